@@ -0,0 +1,213 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "allocations.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+
+const char* get_allocation_phase_name(AllocationPhase phase) {
+	switch (phase) {
+	case OTHER_PHASE:  return "other";
+	case TICK_PHASE:   return "tick";
+	case RENDER_PHASE: return "render";
+	default:           return "?";
+	}
+}
+
+// Plain arrays: these are touched from operator new
+thread_local AllocationPhase current_phase = OTHER_PHASE;
+thread_local AllocationCounts allocation_counts[ALLOCATION_PHASES];
+thread_local AllocationCounts frame_start_counts[ALLOCATION_PHASES];
+thread_local AllocationCounts frame_counts[ALLOCATION_PHASES];
+
+AllocationCounts get_allocation_counts(AllocationPhase phase) {
+	return allocation_counts[phase];
+}
+
+void end_allocation_frame() {
+	for (size_t i = 0; i < ALLOCATION_PHASES; ++i) {
+		frame_counts[i] = allocation_counts[i].since(frame_start_counts[i]);
+		frame_start_counts[i] = allocation_counts[i];
+	}
+}
+
+AllocationCounts get_frame_allocation_counts(AllocationPhase phase) {
+	return frame_counts[phase];
+}
+
+AllocationPhaseScope::AllocationPhaseScope(AllocationPhase phase) :
+	previous(current_phase)
+{
+	current_phase = phase;
+}
+
+AllocationPhaseScope::~AllocationPhaseScope() {
+	current_phase = previous;
+}
+
+#ifdef TRACK_ALLOCATIONS
+
+bool is_tracking_allocations() {
+	return true;
+}
+
+/*
+ * Every replaceable form of operator new counts through these. Aligned
+ * forms only exist from C++17 on and sized deletes from C++14 on, so they
+ * are replaced when the language provides them.
+ */
+void* counted_allocate(std::size_t size) noexcept {
+	AllocationCounts& counts = allocation_counts[current_phase];
+	counts.allocations++;
+	counts.bytes += size;
+
+	return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(std::size_t size) {
+	void *result = counted_allocate(size);
+
+	if (result == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return result;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return counted_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return counted_allocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t&) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t&) noexcept {
+	std::free(pointer);
+}
+
+#ifdef __cpp_sized_deallocation
+
+void operator delete(void *pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+	std::free(pointer);
+}
+
+#endif
+
+#ifdef __cpp_aligned_new
+
+void* counted_allocate(std::size_t size, std::align_val_t align) noexcept {
+	AllocationCounts& counts = allocation_counts[current_phase];
+	counts.allocations++;
+	counts.bytes += size;
+
+	// aligned_alloc() needs a multiple of the alignment
+	std::size_t alignment = static_cast<std::size_t>(align);
+	std::size_t rounded = (std::max<std::size_t>(size, 1) + alignment - 1)
+			/ alignment * alignment;
+	return std::aligned_alloc(alignment, rounded);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+	void *result = counted_allocate(size, align);
+
+	if (result == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return result;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+	return operator new(size, align);
+}
+
+void* operator new(
+		std::size_t size, std::align_val_t align, const std::nothrow_t&
+) noexcept {
+	return counted_allocate(size, align);
+}
+
+void* operator new[](
+		std::size_t size, std::align_val_t align, const std::nothrow_t&
+) noexcept {
+	return counted_allocate(size, align);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(
+		void *pointer, std::align_val_t, const std::nothrow_t&
+) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](
+		void *pointer, std::align_val_t, const std::nothrow_t&
+) noexcept {
+	std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+	std::free(pointer);
+}
+
+void operator delete[](
+		void *pointer, std::size_t, std::align_val_t
+) noexcept {
+	std::free(pointer);
+}
+
+#endif
+
+#else
+
+bool is_tracking_allocations() {
+	return false;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATIONS_H_
+#define ALLOCATIONS_H_
+
+#include <cstddef>
+
+
+/*
+ * Heap allocation counting. The global operator new is only replaced when
+ * compiled with TRACK_ALLOCATIONS; otherwise all counts stay zero.
+ *
+ * Counts are kept per thread and attributed to the phase the thread is in.
+ */
+
+enum AllocationPhase {
+	OTHER_PHASE,
+	TICK_PHASE,
+	RENDER_PHASE,
+
+	ALLOCATION_PHASES
+};
+
+const char* get_allocation_phase_name(AllocationPhase);
+
+struct AllocationCounts {
+	unsigned long allocations = 0;
+	unsigned long bytes = 0;
+
+	AllocationCounts since(const AllocationCounts& earlier) const {
+		AllocationCounts result;
+		result.allocations = allocations - earlier.allocations;
+		result.bytes = bytes - earlier.bytes;
+		return result;
+	}
+};
+
+bool is_tracking_allocations();
+
+/*
+ * Returns the allocations made by this thread in the phase so far.
+ */
+AllocationCounts get_allocation_counts(AllocationPhase);
+
+/*
+ * Ends a frame of this thread. The allocations made since the previous call
+ * become available from get_frame_allocation_counts().
+ */
+void end_allocation_frame();
+AllocationCounts get_frame_allocation_counts(AllocationPhase);
+
+/*
+ * Attributes the allocations of this thread to the phase while in scope.
+ */
+class AllocationPhaseScope {
+private:
+	AllocationPhase previous;
+
+public:
+	explicit AllocationPhaseScope(AllocationPhase);
+	~AllocationPhaseScope();
+
+	AllocationPhaseScope(const AllocationPhaseScope&) = delete;
+	AllocationPhaseScope& operator=(const AllocationPhaseScope&) = delete;
+};
+
+
+#endif /* ALLOCATIONS_H_ */
@@ -0,0 +1,133 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "arena.h"
+
+#include <iostream>
+#include <new>
+
+
+/*
+ * Precedes every block. Padded so that blocks keep the alignment of
+ * operator new.
+ */
+struct alignas(Arena::GRANULARITY) ArenaHeader {
+	Arena *arena;
+	size_t size_class;
+};
+
+static_assert(
+		sizeof(ArenaHeader) == Arena::GRANULARITY,
+		"ArenaHeader must not change block alignment"
+);
+
+// Marks blocks that were taken from the heap
+const size_t HEAP_BLOCK = static_cast<size_t>(-1);
+
+thread_local Arena *current_arena = nullptr;
+
+Arena::~Arena() {
+	if (blocks_in_use != 0) {
+		std::cerr << "Arena destroyed with " << blocks_in_use
+				<< " blocks still in use" << std::endl;
+	}
+
+	for (char *chunk : chunks) {
+		::operator delete(chunk);
+	}
+}
+
+void* Arena::take(size_t size_class) {
+	blocks_in_use++;
+
+	FreeBlock *block = free_lists[size_class];
+	if (block != nullptr) {
+		free_lists[size_class] = block->next;
+		return block;
+	}
+
+	size_t size = (size_class + 1) * GRANULARITY;
+
+	if (cursor == nullptr || static_cast<size_t>(chunk_end - cursor) < size) {
+		// The tail of the previous chunk is abandoned
+		cursor = static_cast<char*>(::operator new(CHUNK_SIZE));
+		chunk_end = cursor + CHUNK_SIZE;
+		chunks.push_back(cursor);
+	}
+
+	void *result = cursor;
+	cursor += size;
+	return result;
+}
+
+void Arena::give_back(void *header, size_t size_class) {
+	blocks_in_use--;
+
+	FreeBlock *block = static_cast<FreeBlock*>(header);
+	block->next = free_lists[size_class];
+	free_lists[size_class] = block;
+}
+
+void* Arena::allocate(Arena *arena, size_t size) {
+	// Header and payload, rounded up to a whole number of granules
+	size_t granules = (size + 2*GRANULARITY - 1) / GRANULARITY;
+
+	ArenaHeader *header;
+
+	if (arena != nullptr && granules <= SIZE_CLASSES) {
+		header = static_cast<ArenaHeader*>(arena->take(granules - 1));
+		header->arena = arena;
+		header->size_class = granules - 1;
+	} else {
+		header = static_cast<ArenaHeader*>(
+				::operator new(granules * GRANULARITY)
+		);
+		header->arena = nullptr;
+		header->size_class = HEAP_BLOCK;
+	}
+
+	return header + 1;
+}
+
+void Arena::deallocate(void *ptr) {
+	if (ptr == nullptr) {
+		return;
+	}
+
+	ArenaHeader *header = static_cast<ArenaHeader*>(ptr) - 1;
+
+	if (header->size_class == HEAP_BLOCK) {
+		::operator delete(header);
+	} else {
+		header->arena->give_back(header, header->size_class);
+	}
+}
+
+Arena* Arena::get_current() {
+	return current_arena;
+}
+
+ArenaScope::ArenaScope(Arena& arena) :
+	previous(current_arena)
+{
+	current_arena = &arena;
+}
+
+ArenaScope::~ArenaScope() {
+	current_arena = previous;
+}
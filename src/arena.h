@@ -0,0 +1,160 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <cstddef>
+#include <list>
+#include <vector>
+
+
+/*
+ * Memory pool owned by a Game. Small blocks are carved from large chunks and
+ * recycled through per-size free lists; all chunks are released together
+ * when the arena is destroyed.
+ *
+ * Every block is preceded by a header naming its arena, so blocks may be
+ * freed without knowing where they came from. Blocks requested without an
+ * arena, or larger than the biggest size class, come from the global heap.
+ *
+ * Arenas are not thread-safe.
+ */
+class Arena {
+public:
+	static const size_t GRANULARITY = 16;
+	static const size_t SIZE_CLASSES = 32;
+	static const size_t CHUNK_SIZE = 64 * 1024;
+
+private:
+	struct FreeBlock {
+		FreeBlock *next;
+	};
+
+	std::vector<char*> chunks;
+	char *cursor = nullptr;
+	char *chunk_end = nullptr;
+
+	FreeBlock *free_lists[SIZE_CLASSES] = {};
+
+	size_t blocks_in_use = 0;
+
+	void* take(size_t size_class);
+	void give_back(void *header, size_t size_class);
+
+public:
+	Arena() {}
+	~Arena();
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	size_t get_blocks_in_use() const {
+		return blocks_in_use;
+	}
+
+	size_t get_reserved_bytes() const {
+		return chunks.size() * CHUNK_SIZE;
+	}
+
+	/*
+	 * Allocates from the given arena or, if it is nullptr, from the heap.
+	 */
+	static void* allocate(Arena*, size_t size);
+
+	/*
+	 * Frees a block returned by allocate().
+	 */
+	static void deallocate(void *ptr);
+
+	/*
+	 * The arena of the innermost ArenaScope on this thread, or nullptr.
+	 */
+	static Arena* get_current();
+
+	friend class ArenaScope;
+};
+
+/*
+ * Makes an arena current on this thread until the end of the scope.
+ */
+class ArenaScope {
+private:
+	Arena *previous;
+
+public:
+	ArenaScope(Arena&);
+	~ArenaScope();
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+/*
+ * Base for classes whose instances are allocated from the current arena.
+ */
+class ArenaAllocated {
+public:
+	static void* operator new(size_t size) {
+		return Arena::allocate(Arena::get_current(), size);
+	}
+
+	static void operator delete(void *ptr) {
+		Arena::deallocate(ptr);
+	}
+};
+
+/*
+ * Standard allocator drawing from an arena. Defaults to the current arena.
+ */
+template< class T >
+struct ArenaAllocator {
+	using value_type = T;
+
+	Arena *arena;
+
+	ArenaAllocator() : arena(Arena::get_current()) {}
+	explicit ArenaAllocator(Arena *arena) : arena(arena) {}
+
+	template< class U >
+	ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t n) {
+		return static_cast<T*>(Arena::allocate(arena, n * sizeof(T)));
+	}
+
+	void deallocate(T *ptr, size_t) {
+		Arena::deallocate(ptr);
+	}
+
+	template< class U >
+	bool operator==(const ArenaAllocator<U>& other) const {
+		return arena == other.arena;
+	}
+
+	template< class U >
+	bool operator!=(const ArenaAllocator<U>& other) const {
+		return arena != other.arena;
+	}
+};
+
+template< class T >
+using ArenaList = std::list<T, ArenaAllocator<T>>;
+
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,72 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "clock.h"
+
+#include <chrono>
+
+
+Timestamp get_monotonic_time() {
+	static const auto start = std::chrono::steady_clock::now();
+
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start
+	).count();
+}
+
+double default_time_scale = 1;
+
+void set_default_time_scale(double scale) {
+	default_time_scale = scale;
+}
+
+double get_default_time_scale() {
+	return default_time_scale;
+}
+
+/*
+ * GameClock
+ */
+
+Timestamp GameClock::update(Timestamp wall_now) {
+	if (wall_time < 0) {
+		wall_time = wall_now;
+		return 0;
+	}
+
+	Timestamp passed = wall_now - wall_time;
+	wall_time = wall_now;
+
+	if (paused) {
+		return 0;
+	}
+
+	Timestamp step = static_cast<Timestamp>(std::llround(passed * time_scale));
+	now += step;
+	return step;
+}
+
+Timestamp GameClock::to_game_time(Timestamp wall) const {
+	if (paused || wall_time < 0 || wall <= wall_time) {
+		return now;
+	}
+
+	return now + static_cast<Timestamp>(
+			std::llround((wall - wall_time) * time_scale)
+	);
+}
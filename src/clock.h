@@ -0,0 +1,111 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include "common.h"
+
+
+const Timestamp NANOSECONDS_PER_SECOND = 1000000000;
+
+/*
+ * Converts a span to seconds. Spans must be short enough for Time, such as
+ * the difference of two nearby moments.
+ */
+inline Time to_seconds(Timestamp span) {
+	return static_cast<Time>(
+			static_cast<double>(span) / NANOSECONDS_PER_SECOND
+	);
+}
+
+inline Timestamp to_timestamp(double seconds) {
+	return static_cast<Timestamp>(
+			std::llround(seconds * NANOSECONDS_PER_SECOND)
+	);
+}
+
+/*
+ * Returns nanoseconds since startup on a monotonic clock.
+ */
+Timestamp get_monotonic_time();
+
+/*
+ * Time scale that new games start with, 1 by default.
+ */
+void set_default_time_scale(double);
+double get_default_time_scale();
+
+/*
+ * The simulation time of a game, separate from the wall clock. It follows
+ * the wall clock multiplied by its time scale, and stands still while paused.
+ */
+class GameClock {
+private:
+	Timestamp now = 0;
+
+	// Wall clock moment of the last update, negative before the first one
+	Timestamp wall_time = -1;
+
+	double time_scale = get_default_time_scale();
+	bool paused = false;
+
+public:
+	/*
+	 * Follows the wall clock to the given moment. Returns the simulation time
+	 * that passed since the last update; the first update starts the clock.
+	 */
+	Timestamp update(Timestamp wall_now);
+
+	/*
+	 * Returns the simulation time that corresponds to a wall clock moment
+	 * after the last update, such as the moment of an input event.
+	 */
+	Timestamp to_game_time(Timestamp wall) const;
+
+	Timestamp get_now() const {
+		return now;
+	}
+
+	bool is_paused() const {
+		return paused;
+	}
+
+	/*
+	 * The wall clock time that passes while paused is skipped, even if the
+	 * clock is not updated in the meantime.
+	 */
+	void set_paused(bool paused) {
+		this->paused = paused;
+
+		if (!paused) {
+			wall_time = -1;
+		}
+	}
+
+	double get_time_scale() const {
+		return time_scale;
+	}
+
+	void set_time_scale(double scale) {
+		time_scale = scale;
+	}
+};
+
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,126 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "fixed.h"
+
+
+Fixed abs(Fixed x) {
+	return x < 0 ? -x : x;
+}
+
+Fixed floor(Fixed x) {
+	return Fixed::from_raw(x.get_raw() & ~(Fixed::ONE - 1));
+}
+
+Fixed ceil(Fixed x) {
+	return -floor(-x);
+}
+
+/*
+ * Roots
+ *
+ * Scaling the argument by 2^16 (2^32) before taking the integer root gives
+ * the root scaled by 2^16, which is the raw result.
+ */
+
+Fixed sqrt(Fixed x) {
+	if (x.get_raw() <= 0) {
+		return 0;
+	}
+
+	uint64_t rest = static_cast<uint64_t>(x.get_raw()) << Fixed::FRACTION_BITS;
+	uint64_t result = 0;
+	uint64_t bit = uint64_t(1) << 62;
+
+	while (bit > rest) {
+		bit >>= 2;
+	}
+
+	while (bit != 0) {
+		if (rest >= result + bit) {
+			rest -= result + bit;
+			result = (result >> 1) + bit;
+		} else {
+			result >>= 1;
+		}
+
+		bit >>= 2;
+	}
+
+	return Fixed::from_raw(static_cast<int32_t>(result));
+}
+
+Fixed cbrt(Fixed x) {
+	const bool negative = x.get_raw() < 0;
+	uint64_t rest = static_cast<uint64_t>(
+			negative ? -static_cast<int64_t>(x.get_raw()) : x.get_raw()
+	) << (2 * Fixed::FRACTION_BITS);
+
+	uint64_t result = 0;
+
+	for (int shift = 63; shift >= 0; shift -= 3) {
+		result <<= 1;
+		uint64_t step = 3 * result * (result + 1) + 1;
+
+		if ((rest >> shift) >= step) {
+			rest -= step << shift;
+			result++;
+		}
+	}
+
+	int32_t raw = static_cast<int32_t>(result);
+	return Fixed::from_raw(negative ? -raw : raw);
+}
+
+/*
+ * Trigonometry
+ */
+
+const Fixed FIXED_PI = Fixed::from_raw(205887);
+const Fixed FIXED_HALF_PI = Fixed::from_raw(102944);
+const int32_t FIXED_TWO_PI_RAW = 411775;
+
+Fixed sin(Fixed x) {
+	// Reduce to [-pi; pi], then to [-pi/2; pi/2] using sin(pi - x) = sin(x)
+	x = Fixed::from_raw(x.get_raw() % FIXED_TWO_PI_RAW);
+
+	if (x > FIXED_PI) {
+		x -= Fixed::from_raw(FIXED_TWO_PI_RAW);
+	} else if (x < -FIXED_PI) {
+		x += Fixed::from_raw(FIXED_TWO_PI_RAW);
+	}
+
+	if (x > FIXED_HALF_PI) {
+		x = FIXED_PI - x;
+	} else if (x < -FIXED_HALF_PI) {
+		x = -FIXED_PI - x;
+	}
+
+	// Taylor series up to x^9 in Horner form
+	const Fixed x2 = x * x;
+	Fixed sum = 1 - x2 / 72;
+	sum = 1 - x2 / 42 * sum;
+	sum = 1 - x2 / 20 * sum;
+	sum = 1 - x2 / 6 * sum;
+
+	return x * sum;
+}
+
+Fixed cos(Fixed x) {
+	return sin(x + FIXED_HALF_PI);
+}
@@ -0,0 +1,219 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIXED_H_
+#define FIXED_H_
+
+#include <cstdint>
+#include <type_traits>
+
+
+/*
+ * A signed Q16.16 fixed-point number: the value times 65536 stored in 32
+ * bits. Every operation is integer arithmetic, so results depend only on the
+ * operands and not on the compiler, its flags or the host.
+ *
+ * Conversions from floating-point truncate towards zero. Mixed arithmetic
+ * with other numbers converts them to Fixed first, so that expressions mixing
+ * both stay fixed-point. Fixed converts to float implicitly for rendering.
+ *
+ * Products and quotients widen to 64 bits, divisions check for zero and
+ * square roots and trigonometry are computed in software, which makes the
+ * physics several times slower than with floats (see LevelCoord).
+ */
+class Fixed {
+private:
+	int32_t raw;
+
+	template< class T >
+	using IfNumber = typename std::enable_if<
+			std::is_arithmetic<T>::value, int
+	>::type;
+
+	static constexpr int32_t to_raw(long long x, std::true_type) {
+		return static_cast<int32_t>(x * ONE);
+	}
+
+	// Scaling by a power of two is exact, only the truncation rounds
+	static constexpr int32_t to_raw(double x, std::false_type) {
+		return static_cast<int32_t>(x * ONE);
+	}
+
+public:
+	static constexpr int FRACTION_BITS = 16;
+	static constexpr int32_t ONE = 1 << FRACTION_BITS;
+
+	Fixed() = default;
+
+	template< class T, IfNumber<T> = 0 >
+	constexpr Fixed(T x) : raw(to_raw(x, std::is_integral<T>())) {}
+
+	static Fixed from_raw(int32_t raw) {
+		Fixed result;
+		result.raw = raw;
+		return result;
+	}
+
+	int32_t get_raw() const {
+		return raw;
+	}
+
+	operator float() const {
+		return static_cast<float>(raw) / ONE;
+	}
+
+	/*
+	 * Arithmetic
+	 *
+	 * Overflows wrap around. Division by zero gives the largest value of the
+	 * dividend's sign.
+	 */
+
+	friend Fixed operator+(Fixed x) {
+		return x;
+	}
+
+	friend Fixed operator-(Fixed x) {
+		return from_raw(-x.raw);
+	}
+
+	friend Fixed operator+(Fixed a, Fixed b) {
+		return from_raw(static_cast<int32_t>(
+				static_cast<uint32_t>(a.raw) + static_cast<uint32_t>(b.raw)
+		));
+	}
+
+	friend Fixed operator-(Fixed a, Fixed b) {
+		return from_raw(static_cast<int32_t>(
+				static_cast<uint32_t>(a.raw) - static_cast<uint32_t>(b.raw)
+		));
+	}
+
+	friend Fixed operator*(Fixed a, Fixed b) {
+		return from_raw(static_cast<int32_t>(
+				(static_cast<int64_t>(a.raw) * b.raw) >> FRACTION_BITS
+		));
+	}
+
+	friend Fixed operator/(Fixed a, Fixed b) {
+		if (b.raw == 0) {
+			return from_raw(a.raw < 0 ? INT32_MIN : INT32_MAX);
+		}
+
+		return from_raw(static_cast<int32_t>(
+				static_cast<int64_t>(a.raw) * ONE / b.raw
+		));
+	}
+
+	Fixed& operator+=(Fixed x) { return *this = *this + x; }
+	Fixed& operator-=(Fixed x) { return *this = *this - x; }
+	Fixed& operator*=(Fixed x) { return *this = *this * x; }
+	Fixed& operator/=(Fixed x) { return *this = *this / x; }
+
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator+(Fixed a, T b) { return a + Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator+(T a, Fixed b) { return Fixed(a) + b; }
+
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator-(Fixed a, T b) { return a - Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator-(T a, Fixed b) { return Fixed(a) - b; }
+
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator*(Fixed a, T b) { return a * Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator*(T a, Fixed b) { return Fixed(a) * b; }
+
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator/(Fixed a, T b) { return a / Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend Fixed operator/(T a, Fixed b) { return Fixed(a) / b; }
+
+	template< class T, IfNumber<T> = 0 >
+	Fixed& operator+=(T x) { return *this += Fixed(x); }
+	template< class T, IfNumber<T> = 0 >
+	Fixed& operator-=(T x) { return *this -= Fixed(x); }
+	template< class T, IfNumber<T> = 0 >
+	Fixed& operator*=(T x) { return *this *= Fixed(x); }
+	template< class T, IfNumber<T> = 0 >
+	Fixed& operator/=(T x) { return *this /= Fixed(x); }
+
+	/*
+	 * Comparison
+	 */
+
+	friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+	friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+	friend bool operator<(Fixed a, Fixed b) { return a.raw < b.raw; }
+	friend bool operator>(Fixed a, Fixed b) { return a.raw > b.raw; }
+	friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+	friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator==(Fixed a, T b) { return a == Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator==(T a, Fixed b) { return Fixed(a) == b; }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator!=(Fixed a, T b) { return a != Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator!=(T a, Fixed b) { return Fixed(a) != b; }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator<(Fixed a, T b) { return a < Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator<(T a, Fixed b) { return Fixed(a) < b; }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator>(Fixed a, T b) { return a > Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator>(T a, Fixed b) { return Fixed(a) > b; }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator<=(Fixed a, T b) { return a <= Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator<=(T a, Fixed b) { return Fixed(a) <= b; }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator>=(Fixed a, T b) { return a >= Fixed(b); }
+	template< class T, IfNumber<T> = 0 >
+	friend bool operator>=(T a, Fixed b) { return Fixed(a) >= b; }
+};
+
+/*
+ * Functions
+ *
+ * Found by argument-dependent lookup, so code that is shared with the
+ * floating-point build calls them unqualified after using std::sqrt etc.
+ */
+
+Fixed abs(Fixed);
+Fixed floor(Fixed);
+Fixed ceil(Fixed);
+
+/*
+ * Exact to the last bit: the largest representable result whose square
+ * (cube) does not exceed the argument. sqrt() of negative numbers is zero.
+ */
+Fixed sqrt(Fixed);
+Fixed cbrt(Fixed);
+
+/*
+ * Polynomial approximations with an error below 0.0002.
+ */
+Fixed sin(Fixed);
+Fixed cos(Fixed);
+
+
+#endif /* FIXED_H_ */
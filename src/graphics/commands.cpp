@@ -0,0 +1,296 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "commands.h"
+
+#include <GLFW/glfw3.h>
+
+#include "instancing.h"
+#include "render_cache.h"
+#include "sdf.h"
+
+
+/*
+ * Executors
+ */
+
+// Instances are placed in the coordinates current at the start of the batch
+GLfloat batch_matrix[16];
+
+inline void vertex(ScreenPoint p) {
+	glVertex2f(p.x, p.y);
+}
+
+void execute_viewport(const ViewportCommand& c) {
+	glViewport(0, 0, c.width, c.height);
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	glOrtho(0, c.width, c.height, 0, 1, -1);
+	glMatrixMode(GL_MODELVIEW);
+}
+
+void execute_clip(const RectangleCommand& c) {
+	GLfloat modelview[16], projection[16];
+	GLint viewport[4];
+	glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+	glGetFloatv(GL_PROJECTION_MATRIX, projection);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	// Only translations and scales, so the corners stay corners. The viewport
+	// may be smaller than the window, see begin_render_cache_execution().
+	auto to_pixels = [&](ScreenPoint p) {
+		GLfloat x = projection[0] * (modelview[0] * p.x + modelview[12])
+				+ projection[12];
+		GLfloat y = projection[5] * (modelview[5] * p.y + modelview[13])
+				+ projection[13];
+
+		return ScreenPoint {
+				viewport[0] + (x + 1) / 2 * viewport[2],
+				viewport[1] + (y + 1) / 2 * viewport[3]
+		};
+	};
+
+	ScreenPoint a = to_pixels(c.min);
+	ScreenPoint b = to_pixels(c.max);
+
+	GLint min_x = static_cast<GLint>(std::floor(std::min(a.x, b.x)));
+	GLint max_x = static_cast<GLint>(std::ceil(std::max(a.x, b.x)));
+	GLint min_y = static_cast<GLint>(std::floor(std::min(a.y, b.y)));
+	GLint max_y = static_cast<GLint>(std::ceil(std::max(a.y, b.y)));
+
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(min_x, min_y, max_x - min_x, max_y - min_y);
+}
+
+void execute_rectangle(const RectangleCommand& c, bool fill) {
+	if (fill) {
+		glBegin(GL_TRIANGLES);
+			vertex(c.min);
+			vertex({c.min.x, c.max.y});
+			vertex(c.max);
+
+			vertex(c.min);
+			vertex({c.max.x, c.min.y});
+			vertex(c.max);
+		glEnd();
+	} else {
+		glBegin(GL_LINE_LOOP);
+			vertex(c.min);
+			vertex({c.min.x, c.max.y});
+			vertex(c.max);
+			vertex({c.max.x, c.min.y});
+		glEnd();
+	}
+}
+
+void execute_sector(const SectorCommand& c, bool fill) {
+	glBegin(fill ? GL_TRIANGLE_FAN : GL_LINE_STRIP);
+		if (fill) vertex(c.center);
+
+		for (float vertex = 0; vertex <= c.vertices; vertex++) {
+			float angle = c.start + vertex / c.vertices * (c.end - c.start);
+			glVertex2f(
+					c.radius * sin(angle) + c.center.x,
+					c.radius * cos(angle) + c.center.y
+			);
+		}
+
+	glEnd();
+}
+
+/*
+ * Tessellates the shape like fill_rounded_rectangle() and
+ * draw_rounded_rectangle() do without shaders.
+ */
+void execute_rounded_rectangle(const RoundedRectangleCommand& c, bool fill) {
+	const ScreenCoord r = c.radius;
+	const unsigned int vertices = c.corner_vertices;
+
+	const ScreenPoint
+		center_min = {c.min.x + r, c.min.y + r},
+		center_max = {c.max.x - r, c.max.y - r};
+
+	execute_sector({center_min, r, vertices, -PI, -PI/2}, fill);
+	execute_sector({{center_min.x, center_max.y}, r, vertices, -PI/2, 0}, fill);
+	execute_sector({center_max, r, vertices, 0, PI/2}, fill);
+	execute_sector({{center_max.x, center_min.y}, r, vertices, PI/2, PI}, fill);
+
+	if (fill) {
+		execute_rectangle({{center_min.x, c.min.y}, {center_max.x, c.max.y}}, true);
+		execute_rectangle({{c.min.x, center_min.y}, {center_min.x, center_max.y}}, true);
+		execute_rectangle({{center_max.x, center_min.y}, {c.max.x, center_max.y}}, true);
+	} else {
+		glBegin(GL_LINES);
+			vertex({c.min.x, center_min.y});
+			vertex({c.min.x, center_max.y});
+			vertex({center_min.x, c.max.y});
+			vertex({center_max.x, c.max.y});
+			vertex({c.max.x, center_max.y});
+			vertex({c.max.x, center_min.y});
+			vertex({center_min.x, c.min.y});
+			vertex({center_max.x, c.min.y});
+		glEnd();
+	}
+}
+
+void execute_line_strips(const LineStripsCommand& c) {
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(ScreenPoint), c.vertices);
+
+	for (unsigned int i = 0; i < c.count; ++i) {
+		glDrawArrays(GL_LINE_STRIP, c.strips[i].first, c.strips[i].count);
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void CommandBuffer::execute() const {
+	size_t offset = 0;
+
+	while (offset < data.size()) {
+		CommandType type = static_cast<CommandType>(data[offset++]);
+
+		switch (type) {
+
+		case CLEAR:
+			glClear(GL_COLOR_BUFFER_BIT);
+			break;
+
+		case SET_VIEWPORT:
+			execute_viewport(read<ViewportCommand>(offset));
+			break;
+
+		case SET_COLOR: {
+			ColorCommand c = read<ColorCommand>(offset);
+			glColor4f(c.red, c.green, c.blue, c.alpha);
+		} break;
+
+		case PUSH_TRANSFORM:
+			glPushMatrix();
+			break;
+
+		case POP_TRANSFORM:
+			glPopMatrix();
+			break;
+
+		case TRANSLATE: {
+			TransformCommand c = read<TransformCommand>(offset);
+			glTranslatef(c.x, c.y, 0);
+		} break;
+
+		case SCALE: {
+			TransformCommand c = read<TransformCommand>(offset);
+			glScalef(c.x, c.y, 1);
+		} break;
+
+		case SET_CLIP:
+			execute_clip(read<RectangleCommand>(offset));
+			break;
+
+		case CLEAR_CLIP:
+			glDisable(GL_SCISSOR_TEST);
+			break;
+
+		case DRAW_LINE: {
+			LineCommand c = read<LineCommand>(offset);
+			glBegin(GL_LINES);
+				vertex(c.a);
+				vertex(c.b);
+			glEnd();
+		} break;
+
+		case FILL_TRIANGLE: {
+			TriangleCommand c = read<TriangleCommand>(offset);
+			glBegin(GL_TRIANGLES);
+				vertex(c.a);
+				vertex(c.b);
+				vertex(c.c);
+			glEnd();
+		} break;
+
+		case DRAW_RECTANGLE:
+		case FILL_RECTANGLE:
+			execute_rectangle(
+					read<RectangleCommand>(offset),
+					type == FILL_RECTANGLE
+			);
+			break;
+
+		case DRAW_SECTOR:
+		case FILL_SECTOR:
+			execute_sector(
+					read<SectorCommand>(offset),
+					type == FILL_SECTOR
+			);
+			break;
+
+		case BEGIN_BATCH:
+			glGetFloatv(GL_MODELVIEW_MATRIX, batch_matrix);
+			break;
+
+		case DRAW_INSTANCES: {
+			InstancesCommand c = read<InstancesCommand>(offset);
+			glPushMatrix();
+			glLoadMatrixf(batch_matrix);
+			draw_instances(c, &data[offset]);
+			glPopMatrix();
+			offset += c.count * sizeof(ShapeInstance);
+		} break;
+
+		case DRAW_LINE_STRIPS:
+			execute_line_strips(read<LineStripsCommand>(offset));
+			break;
+
+		case DRAW_ROUNDED_RECTANGLE:
+		case FILL_ROUNDED_RECTANGLE: {
+			RoundedRectangleCommand c = read<RoundedRectangleCommand>(offset);
+			bool fill = type == FILL_ROUNDED_RECTANGLE;
+
+			if (!draw_sdf_shape(c, fill)) {
+				execute_rounded_rectangle(c, fill);
+			}
+		} break;
+
+		case BEGIN_RENDER_CACHE: {
+			RenderCacheCommand c = read<RenderCacheCommand>(offset);
+			begin_render_cache_execution(c.id, c.resolution);
+		} break;
+
+		case END_RENDER_CACHE:
+			end_render_cache_execution();
+			break;
+
+		case DRAW_RENDER_CACHE:
+			execute_draw_render_cache(read<RenderCacheCommand>(offset).id);
+			break;
+
+		case DESTROY_RENDER_CACHE:
+			execute_destroy_render_cache(read<RenderCacheCommand>(offset).id);
+			break;
+
+		case SET_MULTISAMPLING:
+			if (read<MultisamplingCommand>(offset).enabled) {
+				glEnable(GL_MULTISAMPLE);
+			} else {
+				glDisable(GL_MULTISAMPLE);
+			}
+			break;
+
+		}
+	}
+}
@@ -0,0 +1,239 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMMANDS_H_
+#define COMMANDS_H_
+
+#include "../common.h"
+
+#include <cstring>
+
+#include "design.h"
+
+
+enum CommandType : unsigned char {
+	CLEAR,
+	SET_VIEWPORT,
+
+	SET_COLOR,
+
+	PUSH_TRANSFORM,
+	POP_TRANSFORM,
+	TRANSLATE,
+	SCALE,
+
+	SET_CLIP,
+	CLEAR_CLIP,
+
+	DRAW_LINE,
+	FILL_TRIANGLE,
+	DRAW_RECTANGLE,
+	FILL_RECTANGLE,
+	DRAW_SECTOR,
+	FILL_SECTOR,
+
+	BEGIN_BATCH,
+	DRAW_INSTANCES,
+	DRAW_LINE_STRIPS,
+
+	DRAW_ROUNDED_RECTANGLE,
+	FILL_ROUNDED_RECTANGLE,
+
+	BEGIN_RENDER_CACHE,
+	END_RENDER_CACHE,
+	DRAW_RENDER_CACHE,
+	DESTROY_RENDER_CACHE,
+
+	SET_MULTISAMPLING
+};
+
+/*
+ * Command payloads
+ */
+
+struct ViewportCommand {
+	int width, height;
+};
+
+struct MultisamplingCommand {
+	bool enabled;
+};
+
+struct ColorCommand {
+	GLfloat red, green, blue, alpha;
+};
+
+struct TransformCommand {
+	ScreenCoord x, y;
+};
+
+struct LineCommand {
+	ScreenPoint a, b;
+};
+
+struct TriangleCommand {
+	ScreenPoint a, b, c;
+};
+
+struct RectangleCommand {
+	ScreenPoint min, max;
+};
+
+struct SectorCommand {
+	ScreenPoint center;
+	ScreenCoord radius;
+	unsigned int vertices;
+	float start, end;
+};
+
+/*
+ * Drawn by the distance field shader, see sdf.h. Circles are rounded
+ * squares with a radius of half their size.
+ */
+struct RoundedRectangleCommand {
+	ScreenPoint min, max;
+	ScreenCoord radius;
+
+	// Of each corner when tessellated instead
+	unsigned int corner_vertices;
+};
+
+/*
+ * Identifies a texture that commands can be drawn into and that can then be
+ * drawn as a whole, see render_cache.h.
+ */
+typedef unsigned int RenderCacheId;
+
+struct RenderCacheCommand {
+	RenderCacheId id;
+
+	// Size of the cache relative to the viewport when drawing into it
+	float resolution;
+};
+
+/*
+ * The shape that a batch of instances shares: a rectangle, line or sector
+ * command type with the parameters that cannot be expressed as a placement.
+ */
+struct ShapeKey {
+	CommandType type;
+	unsigned int vertices;
+	float start, end;
+
+	bool operator==(const ShapeKey& x) const {
+		return type == x.type && vertices == x.vertices
+				&& start == x.start && end == x.end;
+	}
+};
+
+/*
+ * One copy of a shape. The shape is built for the unit size at the origin:
+ * each vertex is multiplied by scale and moved by offset.
+ */
+struct ShapeInstance {
+	ScreenPoint offset;
+	ScreenPoint scale;
+	GLfloat red, green, blue, alpha;
+};
+
+/*
+ * Followed by count ShapeInstance structures.
+ */
+struct InstancesCommand {
+	ShapeKey shape;
+	unsigned int count;
+};
+
+/*
+ * A range of vertices drawn as one line strip.
+ */
+struct LineStrip {
+	unsigned short first, count;
+};
+
+/*
+ * Refers to vertex data that never changes, such as the font tables.
+ */
+struct LineStripsCommand {
+	const ScreenPoint *vertices;
+	const LineStrip *strips;
+	unsigned int count;
+};
+
+/*
+ * A recorded sequence of drawing commands. Each command is stored as its
+ * type byte immediately followed by its payload.
+ */
+class CommandBuffer {
+private:
+	std::vector<unsigned char> data;
+
+	template< class T >
+	T read(size_t& offset) const {
+		T result;
+		std::memcpy(&result, &data[offset], sizeof(T));
+		offset += sizeof(T);
+		return result;
+	}
+
+public:
+	void write(CommandType type) {
+		data.push_back(type);
+	}
+
+	template< class T >
+	void write(CommandType type, const T& payload) {
+		size_t offset = data.size();
+		data.resize(offset + 1 + sizeof(T));
+
+		data[offset] = type;
+		std::memcpy(&data[offset + 1], &payload, sizeof(T));
+	}
+
+	template< class T >
+	void write(
+			CommandType type, const T& payload,
+			const void *extra, size_t extra_size
+	) {
+		write(type, payload);
+
+		size_t offset = data.size();
+		data.resize(offset + extra_size);
+		std::memcpy(&data[offset], extra, extra_size);
+	}
+
+	void clear() {
+		data.clear();
+	}
+
+	bool is_empty() const {
+		return data.empty();
+	}
+
+	size_t get_size() const {
+		return data.size();
+	}
+
+	/*
+	 * Issues the recorded commands to the GL context current on this thread.
+	 */
+	void execute() const;
+};
+
+
+#endif /* COMMANDS_H_ */
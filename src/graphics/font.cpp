@@ -20,6 +20,8 @@
 
 #include "graphics.h"
 
+#include <algorithm>
+
 
 /*
  * Font
@@ -49,13 +51,13 @@ ScreenCoord Font::render(ScreenPoint& pos, char c) const {
 	const Glyph& glyph = glyphs->get(c);
 
 	if (!glyph.is_whitespace()) {
-		glPushMatrix();
-		glScalef(size, size, 1);
-		glTranslatef(pos.x / size, pos.y / size, 0);
+		push_transform();
+		scale(size, size);
+		translate(pos.x / size, pos.y / size);
 
 		glyph.render();
 
-		glPopMatrix();
+		pop_transform();
 	}
 
 	return get_advance(glyph);
@@ -65,32 +67,67 @@ ScreenCoord Font::render(ScreenPoint& pos, char c) const {
  * StringDrawer
  */
 
-void StringDrawer::render(ScreenPoint origin) {
-	ScreenPoint pos = origin;
+StringDrawerBuffer::StringDrawerBuffer() {
+	setp(storage, storage + MAX_LENGTH);
+}
 
-	while (true) {
-		char c = stream.get();
-		if (stream.eof()) break;
+StringDrawerBuffer::StringDrawerBuffer(const StringDrawerBuffer& copy) :
+		StringDrawerBuffer()
+{
+	sputn(copy.begin(), copy.end() - copy.begin());
+}
 
-		if (c == '\n') {
+StringDrawerBuffer::int_type StringDrawerBuffer::overflow(int_type c) {
+	if (traits_type::eq_int_type(c, traits_type::eof())) {
+		return traits_type::not_eof(c);
+	}
+
+	// Rare enough for an allocation, each doubling the space
+	size_t length = pptr() - pbase();
+	std::vector<char> grown(length * 2);
+	std::copy(pbase(), pptr(), grown.begin());
+	heap_storage.swap(grown);
+
+	setp(heap_storage.data(), heap_storage.data() + heap_storage.size());
+	pbump(static_cast<int>(length));
+
+	return sputc(traits_type::to_char_type(c));
+}
+
+StringDrawer::StringDrawer(Font font) :
+		buffer(),
+		stream(&buffer),
+		font(font)
+{}
+
+StringDrawer::StringDrawer(const StringDrawer& copy) :
+		buffer(copy.buffer),
+		stream(&buffer),
+		font(copy.font)
+{
+	stream.copyfmt(copy.stream);
+}
+
+void StringDrawer::render(ScreenPoint origin) const {
+	ScreenPoint pos = origin;
+
+	for (const char *c = buffer.begin(); c != buffer.end(); ++c) {
+		if (*c == '\n') {
 			pos.x = origin.x;
 			pos.y += font.get_height();
 		} else {
-			pos.x += font.render(pos, c);
+			pos.x += font.render(pos, *c);
 		}
 	}
 }
 
-ScreenPoint StringDrawer::get_dimensions() {
+ScreenPoint StringDrawer::get_dimensions() const {
 	ScreenCoord max_width = 0;
 	ScreenCoord current_width = 0;
 	ScreenCoord height = font.get_height();
 
-	while (true) {
-		char c = stream.get();
-		if (stream.eof()) break;
-
-		if (c == '\n') {
+	for (const char *c = buffer.begin(); c != buffer.end(); ++c) {
+		if (*c == '\n') {
 			height += font.get_height();
 
 			if (max_width < current_width) {
@@ -98,13 +135,10 @@ ScreenPoint StringDrawer::get_dimensions() {
 			}
 			current_width = 0;
 		} else {
-			current_width += font.get_advance(c);
+			current_width += font.get_advance(*c);
 		}
 	}
 
-	stream.clear();
-	stream.seekg(0, std::ios_base::beg);
-
 	return {
 		std::max(current_width, max_width),
 		height
@@ -112,8 +146,5 @@ ScreenPoint StringDrawer::get_dimensions() {
 }
 
 StringDrawer draw_string(Font font) {
-	return StringDrawer {
-		std::stringstream(),
-		font
-	};
+	return StringDrawer(font);
 }
@@ -21,9 +21,9 @@
 
 #include "../common.h"
 
-#include <cstdarg>
 #include <iostream>
-#include <sstream>
+#include <streambuf>
+#include <vector>
 
 #include "glyph.h"
 
@@ -52,18 +52,51 @@ public:
 	ScreenCoord get_advance(char c) const;
 };
 
-struct StringDrawer {
-	std::stringstream stream;
+/*
+ * Stream buffer that writes into fixed storage so that formatting text does
+ * not touch the heap. Text longer than MAX_LENGTH characters is moved to the
+ * heap instead of being cut off.
+ */
+class StringDrawerBuffer : public std::streambuf {
+public:
+	static const size_t MAX_LENGTH = 1024;
+
+private:
+	char storage[MAX_LENGTH];
+
+	// Used once the text outgrows the storage
+	std::vector<char> heap_storage;
+
+protected:
+	int_type overflow(int_type c) override;
+
+public:
+	StringDrawerBuffer();
+	StringDrawerBuffer(const StringDrawerBuffer& copy);
+
+	const char* begin() const { return pbase(); }
+	const char* end() const { return pptr(); }
+};
+
+class StringDrawer {
+private:
+	StringDrawerBuffer buffer;
+
+public:
+	std::ostream stream;
 	const Font font;
 
-	void render(ScreenPoint);
-	ScreenPoint get_dimensions();
+	StringDrawer(Font font);
+	StringDrawer(const StringDrawer& copy);
+
+	void render(ScreenPoint) const;
+	ScreenPoint get_dimensions() const;
 };
 
 template < class T >
-StringDrawer operator<<(StringDrawer drawer, const T& any) {
+StringDrawer&& operator<<(StringDrawer&& drawer, const T& any) {
 	drawer.stream << any;
-	return drawer;
+	return std::move(drawer);
 }
 
 StringDrawer draw_string(Font font);
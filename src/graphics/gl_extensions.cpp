@@ -0,0 +1,184 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "gl_extensions.h"
+
+#include <cstdio>
+#include <iostream>
+
+
+GLExtensions gl;
+
+template< class T >
+bool load_entry_point(GLProcLoader loader, T& pointer, const char *name) {
+	pointer = reinterpret_cast<T>(loader(name));
+
+	if (pointer == nullptr) {
+		std::cerr << "OpenGL entry point " << name << " is not available"
+				<< std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool is_gl_version_at_least(int major, int minor) {
+	const char *version =
+			reinterpret_cast<const char*>(glGetString(GL_VERSION));
+	int actual_major = 0, actual_minor = 0;
+
+	if (version == nullptr
+			|| std::sscanf(version, "%d.%d", &actual_major, &actual_minor) != 2) {
+		return false;
+	}
+
+	return actual_major > major
+			|| (actual_major == major && actual_minor >= minor);
+}
+
+bool load_render_to_texture(GLProcLoader loader) {
+	if (!is_gl_version_at_least(3, 0)) {
+		return false;
+	}
+
+	bool ok = true;
+
+	ok &= load_entry_point(loader, gl.FramebufferTexture2D,
+			"glFramebufferTexture2D");
+	ok &= load_entry_point(loader, gl.BlendFuncSeparate,
+			"glBlendFuncSeparate");
+
+	return ok;
+}
+
+bool load_shaders(GLProcLoader loader) {
+	// Loaders may return entry points the context does not support
+	if (!is_gl_version_at_least(2, 0)) {
+		return false;
+	}
+
+	bool ok = true;
+
+	ok &= load_entry_point(loader, gl.CreateShader, "glCreateShader");
+	ok &= load_entry_point(loader, gl.DeleteShader, "glDeleteShader");
+	ok &= load_entry_point(loader, gl.ShaderSource, "glShaderSource");
+	ok &= load_entry_point(loader, gl.CompileShader, "glCompileShader");
+	ok &= load_entry_point(loader, gl.GetShaderiv, "glGetShaderiv");
+	ok &= load_entry_point(loader, gl.GetShaderInfoLog, "glGetShaderInfoLog");
+
+	ok &= load_entry_point(loader, gl.CreateProgram, "glCreateProgram");
+	ok &= load_entry_point(loader, gl.AttachShader, "glAttachShader");
+	ok &= load_entry_point(loader, gl.BindAttribLocation,
+			"glBindAttribLocation");
+	ok &= load_entry_point(loader, gl.LinkProgram, "glLinkProgram");
+	ok &= load_entry_point(loader, gl.GetProgramiv, "glGetProgramiv");
+	ok &= load_entry_point(loader, gl.GetProgramInfoLog,
+			"glGetProgramInfoLog");
+	ok &= load_entry_point(loader, gl.UseProgram, "glUseProgram");
+	ok &= load_entry_point(loader, gl.GetUniformLocation,
+			"glGetUniformLocation");
+	ok &= load_entry_point(loader, gl.Uniform2f, "glUniform2f");
+	ok &= load_entry_point(loader, gl.VertexAttrib2f, "glVertexAttrib2f");
+	ok &= load_entry_point(loader, gl.VertexAttrib4f, "glVertexAttrib4f");
+
+	return ok;
+}
+
+bool load_instancing(GLProcLoader loader) {
+	if (!gl.has_shaders || !is_gl_version_at_least(3, 3)) {
+		return false;
+	}
+
+	bool ok = true;
+
+	ok &= load_entry_point(loader, gl.GenBuffers, "glGenBuffers");
+	ok &= load_entry_point(loader, gl.BindBuffer, "glBindBuffer");
+	ok &= load_entry_point(loader, gl.BufferData, "glBufferData");
+
+	ok &= load_entry_point(loader, gl.VertexAttribPointer,
+			"glVertexAttribPointer");
+	ok &= load_entry_point(loader, gl.EnableVertexAttribArray,
+			"glEnableVertexAttribArray");
+	ok &= load_entry_point(loader, gl.DisableVertexAttribArray,
+			"glDisableVertexAttribArray");
+	ok &= load_entry_point(loader, gl.VertexAttribDivisor,
+			"glVertexAttribDivisor");
+	ok &= load_entry_point(loader, gl.DrawArraysInstanced,
+			"glDrawArraysInstanced");
+
+	return ok;
+}
+
+bool load_timer_queries(GLProcLoader loader) {
+	if (!is_gl_version_at_least(3, 3)) {
+		return false;
+	}
+
+	bool ok = true;
+
+	ok &= load_entry_point(loader, gl.GenQueries, "glGenQueries");
+	ok &= load_entry_point(loader, gl.DeleteQueries, "glDeleteQueries");
+	ok &= load_entry_point(loader, gl.BeginQuery, "glBeginQuery");
+	ok &= load_entry_point(loader, gl.EndQuery, "glEndQuery");
+	ok &= load_entry_point(loader, gl.GetQueryObjectui64v,
+			"glGetQueryObjectui64v");
+
+	return ok;
+}
+
+bool load_gl_extensions(GLProcLoader loader) {
+	bool ok = true;
+
+	ok &= load_entry_point(loader, gl.GenFramebuffers, "glGenFramebuffers");
+	ok &= load_entry_point(loader, gl.DeleteFramebuffers, "glDeleteFramebuffers");
+	ok &= load_entry_point(loader, gl.BindFramebuffer, "glBindFramebuffer");
+	ok &= load_entry_point(loader, gl.CheckFramebufferStatus,
+			"glCheckFramebufferStatus");
+	ok &= load_entry_point(loader, gl.FramebufferRenderbuffer,
+			"glFramebufferRenderbuffer");
+	ok &= load_entry_point(loader, gl.BlitFramebuffer, "glBlitFramebuffer");
+
+	ok &= load_entry_point(loader, gl.GenRenderbuffers, "glGenRenderbuffers");
+	ok &= load_entry_point(loader, gl.DeleteRenderbuffers,
+			"glDeleteRenderbuffers");
+	ok &= load_entry_point(loader, gl.BindRenderbuffer, "glBindRenderbuffer");
+	ok &= load_entry_point(loader, gl.RenderbufferStorageMultisample,
+			"glRenderbufferStorageMultisample");
+
+	gl.has_render_to_texture = ok && load_render_to_texture(loader);
+	if (!gl.has_render_to_texture) {
+		std::cerr << "Rendering into textures is not available" << std::endl;
+	}
+
+	gl.has_shaders = load_shaders(loader);
+	if (!gl.has_shaders) {
+		std::cerr << "Shaders are not available" << std::endl;
+	}
+
+	gl.has_instancing = load_instancing(loader);
+	if (!gl.has_instancing) {
+		std::cerr << "Instanced drawing is not available" << std::endl;
+	}
+
+	gl.has_timer_queries = load_timer_queries(loader);
+	if (!gl.has_timer_queries) {
+		std::cerr << "Timer queries are not available" << std::endl;
+	}
+
+	return ok;
+}
@@ -0,0 +1,110 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef GL_EXTENSIONS_H_
+#define GL_EXTENSIONS_H_
+
+#include <GLFW/glfw3.h>
+#include <GL/glext.h>
+
+
+/*
+ * Entry points beyond OpenGL 1.1 that have to be loaded at runtime.
+ */
+struct GLExtensions {
+	PFNGLGENFRAMEBUFFERSPROC GenFramebuffers;
+	PFNGLDELETEFRAMEBUFFERSPROC DeleteFramebuffers;
+	PFNGLBINDFRAMEBUFFERPROC BindFramebuffer;
+	PFNGLCHECKFRAMEBUFFERSTATUSPROC CheckFramebufferStatus;
+	PFNGLFRAMEBUFFERRENDERBUFFERPROC FramebufferRenderbuffer;
+	PFNGLBLITFRAMEBUFFERPROC BlitFramebuffer;
+
+	PFNGLGENRENDERBUFFERSPROC GenRenderbuffers;
+	PFNGLDELETERENDERBUFFERSPROC DeleteRenderbuffers;
+	PFNGLBINDRENDERBUFFERPROC BindRenderbuffer;
+	PFNGLRENDERBUFFERSTORAGEMULTISAMPLEPROC RenderbufferStorageMultisample;
+
+	// Rendering into textures, optional: see has_render_to_texture
+	bool has_render_to_texture;
+
+	PFNGLFRAMEBUFFERTEXTURE2DPROC FramebufferTexture2D;
+	PFNGLBLENDFUNCSEPARATEPROC BlendFuncSeparate;
+
+	// Shaders, optional: see has_shaders
+	bool has_shaders;
+
+	PFNGLCREATESHADERPROC CreateShader;
+	PFNGLDELETESHADERPROC DeleteShader;
+	PFNGLSHADERSOURCEPROC ShaderSource;
+	PFNGLCOMPILESHADERPROC CompileShader;
+	PFNGLGETSHADERIVPROC GetShaderiv;
+	PFNGLGETSHADERINFOLOGPROC GetShaderInfoLog;
+
+	PFNGLCREATEPROGRAMPROC CreateProgram;
+	PFNGLATTACHSHADERPROC AttachShader;
+	PFNGLBINDATTRIBLOCATIONPROC BindAttribLocation;
+	PFNGLLINKPROGRAMPROC LinkProgram;
+	PFNGLGETPROGRAMIVPROC GetProgramiv;
+	PFNGLGETPROGRAMINFOLOGPROC GetProgramInfoLog;
+	PFNGLUSEPROGRAMPROC UseProgram;
+	PFNGLGETUNIFORMLOCATIONPROC GetUniformLocation;
+	PFNGLUNIFORM2FPROC Uniform2f;
+	PFNGLVERTEXATTRIB2FPROC VertexAttrib2f;
+	PFNGLVERTEXATTRIB4FPROC VertexAttrib4f;
+
+	// Instanced drawing, optional: see has_instancing
+	bool has_instancing;
+
+	PFNGLGENBUFFERSPROC GenBuffers;
+	PFNGLBINDBUFFERPROC BindBuffer;
+	PFNGLBUFFERDATAPROC BufferData;
+
+	PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer;
+	PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray;
+	PFNGLDISABLEVERTEXATTRIBARRAYPROC DisableVertexAttribArray;
+	PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor;
+	PFNGLDRAWARRAYSINSTANCEDPROC DrawArraysInstanced;
+
+	// Timer queries, optional: see has_timer_queries
+	bool has_timer_queries;
+
+	PFNGLGENQUERIESPROC GenQueries;
+	PFNGLDELETEQUERIESPROC DeleteQueries;
+	PFNGLBEGINQUERYPROC BeginQuery;
+	PFNGLENDQUERYPROC EndQuery;
+	PFNGLGETQUERYOBJECTUI64VPROC GetQueryObjectui64v;
+};
+
+/*
+ * Loaded extension entry points. Valid after load_gl_extensions() succeeds.
+ */
+extern GLExtensions gl;
+
+using GLProcLoader = void* (*)(const char *name);
+
+/*
+ * Resolves all entry points with the given loader. Returns false if any of
+ * them is unavailable. Rendering into textures needs OpenGL 3.0, shaders need
+ * OpenGL 2.0, instanced drawing and timer queries need OpenGL 3.3; without
+ * them has_render_to_texture, has_shaders, has_instancing or
+ * has_timer_queries is false and the call still succeeds.
+ */
+bool load_gl_extensions(GLProcLoader);
+
+
+#endif /* GL_EXTENSIONS_H_ */
@@ -18,510 +18,742 @@
 
 #include "glyph.h"
 
+#include <cstddef>
+
 #include "graphics.h"
 
 
 /*
- * Primitives
+ * Glyph
  */
 
-void LinePrimitive::render() {
-	draw_line(start, end);
+bool Glyph::is_whitespace() const {
+	return strip_count == 0;
 }
 
-void ArcPrimitive::render() {
-	draw_arc(center, radius, start_angle, end_angle);
+// Pixels per glyph unit that each level of detail is tessellated for, as
+// drawn by Font(36), Font(72) and Font(144)
+constexpr double GLYPH_DETAIL_SCALES[GLYPH_DETAILS] = {4, 8, 16};
+
+void Glyph::render() const {
+	ScreenCoord scale = get_transform_scale();
+
+	size_t detail = 0;
+	while (
+			detail + 1 < GLYPH_DETAILS
+			&& GLYPH_DETAIL_SCALES[detail] < scale
+	) {
+		detail++;
+	}
+
+	draw_line_strips(
+			details.items[detail].vertices,
+			details.items[detail].strips,
+			strip_count
+	);
 }
 
 /*
- * Glyph
+ * Font source
  */
 
-Glyph::Glyph(
-		GlyphCoord width,
-		size_t primitive_count, ...
-) :
-	width(width), primitive_count(primitive_count) {
+enum GlyphRecordType : unsigned char {
+	GLYPH, LINE, ARC
+};
 
-	va_list args;
-	va_start(args, primitive_count);
+/*
+ * A font is written as a list of records: each glyph record is followed by
+ * the line and arc records of its strokes.
+ */
+struct GlyphRecord {
+	GlyphRecordType type;
+
+	// Glyph
+	unsigned char code;
+	GlyphCoord width;
+
+	// Line ends or arc center
+	GlyphPoint a, b;
+
+	// Arc
+	GlyphCoord radius;
+	float start_angle, end_angle;
+};
+
+constexpr GlyphRecord glyph(char code, GlyphCoord width) {
+	return {
+		GLYPH, static_cast<unsigned char>(code), width,
+		{0, 0}, {0, 0},
+		0, 0, 0
+	};
+}
 
-	primitives = new Primitive*[primitive_count];
+constexpr GlyphRecord line(GlyphPoint start, GlyphPoint end) {
+	return {LINE, 0, 0, start, end, 0, 0, 0};
+}
 
-	for (size_t i = 0; i < primitive_count; ++i) {
-		primitives[i] = va_arg(args, Primitive*); // @suppress("C-Style cast instead of C++ cast")
-	}
+constexpr GlyphRecord arc(
+		GlyphPoint center, GlyphCoord radius,
+		float start_angle, float end_angle
+) {
+	return {ARC, 0, 0, center, {0, 0}, radius, start_angle, end_angle};
+}
+
+/*
+ * Default font. The first glyph is used for characters without a glyph.
+ */
 
-	va_end(args);
+constexpr GlyphRecord DEFAULT_FONT[] = {
+	glyph('\0', 4),
+		line({0,0}, {0,7}),
+		line({0,7}, {4,7}),
+		line({4,7}, {4,0}),
+		line({4,0}, {0,0}),
+
+
+
+	glyph(' ', 2),
+
+
+
+	glyph('0', 4),
+		arc ({2,2}, 2, PI/2, 3*PI/2),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+		line({4,2}, {4,5}),
+		line({3.5f, 2.5f}, {0.5f, 4.5f}),
+	glyph('1', 4),
+		arc ({0,0}, 2, 0, PI/2),
+		line({2,0}, {2,7}),
+		line({0,7}, {4,7}),
+	glyph('2', 4),
+		arc ({2,2}, 2, 0, 3*PI/2),
+		arc ({2,6}, 2, PI, 3*PI/2),
+		line({0,6}, {0,7}),
+		line({0,7}, {4,7}),
+	glyph('3', 4),
+		line({0,0}, {4,0}),
+		line({4,0}, {2,3}),
+		arc ({2,5}, 2, -PI/2, PI),
+	glyph('4', 4),
+		line({4,4}, {0,4}),
+		line({0,4}, {3,0}),
+		line({3,0}, {3,7}),
+	glyph('5', 4),
+		line({4,0}, {0,0}),
+		line({0,0}, {0,3}),
+		line({0,3}, {2,3}),
+		arc ({2,5}, 2, -PI/2, PI),
+	glyph('6', 4),
+		arc ({2,2}, 2, PI/2, 3*PI/2),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, 0, 2*PI),
+	glyph('7', 4),
+		line({0,0}, {4,0}),
+		line({4,0}, {0,7}),
+	glyph('8', 4),
+		arc ({2, 1.5f}, 1.5f, 0, 2*PI),
+		arc ({2,5}, 2, 0, 2*PI),
+	glyph('9', 4),
+		arc ({2,2}, 2, 0, 2*PI),
+		line({4,2}, {4,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+
+
+
+	glyph('.', 1),
+		arc ({0.5f, 6.5f}, 0.5f, 0, 2*PI),
+	glyph(',', 1),
+		arc ({-2,7}, 2, 0, PI/2),
+	glyph(':', 1),
+		arc ({0.5f, 3}, 0.5f, 0, 2*PI),
+		arc ({0.5f, 6}, 0.5f, 0, 2*PI),
+	glyph('-', 2),
+		line({0,3}, {2,3}),
+	glyph('\xA9', 5),
+		arc ({2.5f, 4.5f}, 2.5f, 0, 2*PI),
+		arc ({2.5f, 4.5f}, 1.5f, PI, 2*PI),
+
+
+
+	glyph('A', 4),
+		arc ({2,2}, 2, PI/2, 3*PI/2),
+		line({0,7}, {0,2}),
+		line({4,7}, {4,2}),
+		line({0,3}, {4,3}),
+	glyph('B', 4),
+		arc ({2, 1.5f}, 1.5f, 0, PI),
+		arc ({2,5}, 2, 0, PI),
+		line({0,0}, {0,7}),
+		line({0,0}, {2,0}),
+		line({0,3}, {2,3}),
+		line({0,7}, {2,7}),
+	glyph('C', 4),
+		line({4,0}, {2,0}),
+		arc ({2,2}, 2, PI, 3*PI/2),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, 3*PI/2, 2*PI),
+		line({2,7}, {4,7}),
+	glyph('D', 4),
+		line({0,0}, {2,0}),
+		arc ({2,2}, 2, PI/2, PI),
+		line({4,2}, {4,5}),
+		arc ({2,5}, 2, 0, PI/2),
+		line({0,7}, {2,7}),
+		line({0,0}, {0,7}),
+	glyph('E', 4),
+		line({0,0}, {0,7}),
+		line({0,0}, {4,0}),
+		line({0,3}, {3,3}),
+		line({0,7}, {4,7}),
+	glyph('F', 4),
+		line({0,0}, {0,7}),
+		line({0,0}, {4,0}),
+		line({0,3}, {3,3}),
+	glyph('G', 4),
+		arc ({2,2}, 2, PI/2, 3*PI/2),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+		line({4,5}, {4,4}),
+		line({4,4}, {2,4}),
+	glyph('H', 4),
+		line({0,0}, {0,7}),
+		line({4,0}, {4,7}),
+		line({0,3}, {4,3}),
+	glyph('I', 3),
+		line({1.5f, 0}, {1.5f, 7}),
+		line({0,0}, {3,0}),
+		line({0,7}, {3,7}),
+	glyph('J', 3),
+		line({0,0}, {3,0}),
+		line({3,0}, {3,4}),
+		arc ({0,4}, 3, 0, PI/2),
+	glyph('K', 4),
+		line({0,0}, {0,7}),
+		line({0,3}, {4,0}),
+		line({0,3}, {4,7}),
+	glyph('L', 4),
+		line({0,0}, {0,7}),
+		line({0,7}, {4,7}),
+	glyph('M', 5),
+		line({0,7}, {0,0}),
+		line({0,0}, {2.5f, 5}),
+		line({2.5f, 5}, {5,0}),
+		line({5,0}, {5,7}),
+	glyph('N', 4),
+		line({0,7}, {0,0}),
+		line({0,0}, {4,7}),
+		line({4,7}, {4,0}),
+	glyph('O', 4),
+		arc ({2,2}, 2, PI/2, 3*PI/2),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+		line({4,2}, {4,5}),
+	glyph('P', 4),
+		line({0,0}, {2,0}),
+		arc ({2,2}, 2, PI/2, PI),
+		line({4,2}, {4,3}),
+		arc ({2,3}, 2, 0, PI/2),
+		line({0,5}, {2,5}),
+		line({0,0}, {0,7}),
+	glyph('Q', 4),
+		arc ({2,2}, 2, PI/2, 3*PI/2),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+		line({4,2}, {4,5}),
+		line({2,7}, {4,8}),
+	glyph('R', 4),
+		line({0,0}, {2,0}),
+		arc ({2,2}, 2, PI/2, PI),
+		line({4,2}, {4,3}),
+		arc ({2,3}, 2, 0, PI/2),
+		line({0,5}, {2,5}),
+		line({0,0}, {0,7}),
+		arc ({2,7}, 2, PI/2, PI),
+	glyph('S', 4),
+		line({4,0}, {1.5f, 0}),
+		arc ({1.5f, 1.5f}, 1.5f, PI, 2*PI),
+		line({1.5f, 3}, {2.5f, 3}),
+		arc ({2.5f, 4.5f}, 1.5f, PI/2, PI),
+		line({4, 4.5f}, {4, 5.5f}),
+		arc ({2.5f, 5.5f}, 1.5f, 0, PI/2),
+		line({2.5f, 7}, {0, 7}),
+	glyph('T', 4),
+		line({0,0}, {4,0}),
+		line({2,0}, {2,7}),
+	glyph('U', 4),
+		line({0,0}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+		line({4,5}, {4,0}),
+	glyph('V', 4),
+		line({0,0}, {2,7}),
+		line({2,7}, {4,0}),
+	glyph('W', 5),
+		line({0,0}, {1,7}),
+		line({1,7}, {2.5f, 3}),
+		line({2.5f, 3}, {4,7}),
+		line({4,7}, {5,0}),
+	glyph('X', 4),
+		line({0,0}, {4,7}),
+		line({4,0}, {0,7}),
+	glyph('Y', 4),
+		line({0,0}, {2,3}),
+		line({4,0}, {2,3}),
+		line({2,3}, {2,7}),
+	glyph('Z', 4),
+		line({0,0}, {4,0}),
+		line({4,0}, {0,7}),
+		line({0,7}, {4,7}),
+
+
+
+	glyph('a', 4),
+		line({0,2}, {3,2}),
+		arc ({3,3}, 1, PI/2, PI),
+		line({4,3}, {4,7}),
+		arc ({2.5f, 5.5f}, 1.5f, 0, PI/2),
+		line({2.5f, 7}, {1.5f, 7}),
+		arc ({1.5f, 5.5f}, 1.5f, PI, 2*PI),
+		line({1.5f, 4}, {4,4}),
+	glyph('b', 4),
+		line({0,0}, {0,7}),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({4,4}, {4,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+	glyph('c', 3),
+		line({3,2}, {2,2}),
+		arc ({2,4}, 2, PI, 3*PI/2),
+		line({0,4}, {0,5}),
+		arc ({2,5}, 2, 3*PI/2, 2*PI),
+		line({2,7}, {3,7}),
+	glyph('d', 4),
+		line({4,0}, {4,7}),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({0,4}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+	glyph('e', 4),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({0,4}, {4,4}),
+		arc ({3,4}, 3, -PI/2, 0),
+		line({3,7}, {4,7}),
+	glyph('f', 3),
+		arc ({3, 1.5f}, 1.5f, PI, 3*PI/2),
+		line({1.5f, 1.5f}, {1.5f, 5.5f}),
+		arc ({0, 5.5f}, 1.5f, 0, PI/2),
+		line({0,3}, {3,3}),
+	glyph('g', 4),
+		line({4,2}, {4,7}),
+		arc ({2,7}, 2, 0, PI/2),
+		line({2,9}, {0,9}),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({0,4}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+	glyph('h', 4),
+		line({0,0}, {0,7}),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({4,4}, {4,7}),
+	glyph('i', 3),
+		line({0,7}, {3,7}),
+		line({1.5f, 7}, {1.5f, 3}),
+		line({1.5f, 3}, {0,3}),
+		arc ({1.5f, 1.5f}, 0.5f, 0, 2*PI),
+	glyph('j', 2),
+		arc ({0,7}, 2, 0, PI/2),
+		line({2,7}, {2,3}),
+		line({2,3}, {0,3}),
+		arc ({1.5f, 1.5f}, 0.5f, 0, 2*PI),
+	glyph('k', 3),
+		line({0,0}, {0,7}),
+		line({0, 4.5f}, {3,2}),
+		line({0, 4.5f}, {3,7}),
+	glyph('l', 1.5f),
+		line({0,0}, {0,5}),
+		arc ({2,5}, 2, -PI/2, 0),
+	glyph('m', 6),
+		line({0,7}, {0,2}),
+		arc ({1.5f, 3.5f}, 1.5f, PI/2, 3*PI/2),
+		line({3, 3.5f}, {3,7}),
+		arc ({4.5f, 3.5f}, 1.5f, PI/2, 3*PI/2),
+		line({6, 3.5f}, {6,7}),
+	glyph('n', 4),
+		line({0,2}, {0,7}),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({4,4}, {4,7}),
+	glyph('o', 5),
+		arc ({2.5f, 4.5f}, 2.5f, 0, 2*PI),
+	glyph('p', 4),
+		line({0,2}, {0,9}),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({4,4}, {4,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+	glyph('q', 4),
+		line({4,2}, {4,9}),
+		arc ({2,4}, 2, PI/2, 3*PI/2),
+		line({0,4}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+	glyph('r', 3),
+		line({0,2}, {0,7}),
+		arc ({2,4}, 2, PI, 3*PI/2),
+		line({2,2}, {3,2}),
+	glyph('s', 4),
+		line({4,2}, {1,2}),
+		arc ({1,3}, 1, PI, 2*PI),
+		line({1,4}, {2.5f, 4}),
+		arc ({2.5f, 5.5f}, 1.5f, 0, PI),
+		line({2.5f, 7}, {0,7}),
+	glyph('t', 3),
+		line({1,0}, {1,5}),
+		arc ({3,5}, 2, 3*PI/2, 2*PI),
+		line({0,3}, {3,3}),
+	glyph('u', 4),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+		line({4,2}, {4,7}),
+	glyph('v', 4),
+		line({0,2}, {2,7}),
+		line({2,7}, {4,2}),
+	glyph('w', 6),
+		line({0,2}, {0, 5.5f}),
+		arc ({1.5f, 5.5f}, 1.5f, -PI/2, PI/2),
+		line({3,2}, {3, 5.5f}),
+		arc ({4.5f, 5.5f}, 1.5f, -PI/2, PI/2),
+		line({6,2}, {6, 5.5f}),
+	glyph('x', 4),
+		line({0,2}, {4,7}),
+		line({0,7}, {4,2}),
+	glyph('y', 4),
+		line({0,2}, {0,5}),
+		arc ({2,5}, 2, -PI/2, PI/2),
+		line({4,2}, {4,7}),
+		arc ({2,7}, 2, 0, PI/2),
+		line({2,9}, {0,9}),
+	glyph('z', 4),
+		line({0,2}, {4,2}),
+		line({4,2}, {0,7}),
+		line({0,7}, {4,7})
+};
+
+constexpr size_t DEFAULT_FONT_RECORDS =
+		sizeof(DEFAULT_FONT) / sizeof(DEFAULT_FONT[0]);
+
+/*
+ * Compile-time tessellation
+ *
+ * C++11 constexpr functions cannot loop, so every table element is computed
+ * by a recursive walk over the records and the tables are expanded from
+ * index sequences.
+ */
+
+template< size_t... I >
+struct Sequence {};
+
+template< class A, class B >
+struct JoinSequences;
+
+template< size_t... A, size_t... B >
+struct JoinSequences< Sequence<A...>, Sequence<B...> > {
+	using Type = Sequence<A..., (sizeof...(A) + B)...>;
+};
+
+template< size_t N >
+struct MakeSequence {
+	using Type = typename JoinSequences<
+			typename MakeSequence<N / 2>::Type,
+			typename MakeSequence<N - N / 2>::Type
+	>::Type;
+};
+
+template<>
+struct MakeSequence<0> {
+	using Type = Sequence<>;
+};
+
+template<>
+struct MakeSequence<1> {
+	using Type = Sequence<0>;
+};
+
+template< class T, size_t N >
+struct Table {
+	T items[N];
+};
+
+constexpr double TAU = 2 * 3.14159265358979323846;
+
+constexpr double reduce_angle(double x) {
+	return x > TAU / 2 ? reduce_angle(x - TAU)
+			: x < -TAU / 2 ? reduce_angle(x + TAU)
+			: x;
 }
 
-Glyph::~Glyph() {
-	for (size_t i = 0; i < primitive_count; ++i) {
-		delete primitives[i];
-	}
+// Taylor series; terms past the 12th are negligible for |x| <= PI
+constexpr double sin_series(double x, double term, int n) {
+	return n == 12 ? term
+			: term + sin_series(x, -term * x * x / ((2*n) * (2*n + 1)), n + 1);
+}
 
-	delete[] primitives;
+constexpr double constexpr_sin(double x) {
+	return sin_series(reduce_angle(x), reduce_angle(x), 1);
 }
 
-bool Glyph::is_whitespace() const {
-	return primitive_count == 0;
+constexpr double constexpr_cos(double x) {
+	return constexpr_sin(x + TAU / 4);
 }
 
-void Glyph::render() const {
-	for (size_t i = 0; i < primitive_count; ++i) {
-		primitives[i]->render();
-	}
+// Like MAX_TESSELLATION_ERROR in graphics.cpp, in pixels
+constexpr double GLYPH_TESSELLATION_ERROR = 0.25;
+
+constexpr unsigned int MIN_CIRCLE_SEGMENTS = 8;
+
+constexpr double sqrt_iteration(double x, double guess, int n) {
+	return n == 0 ? guess
+			: sqrt_iteration(x, (guess + x / guess) / 2, n - 1);
 }
 
-/*
- * Glyphs
- */
+// Newton's method, converges long before the last step for glyph radii
+constexpr double constexpr_sqrt(double x) {
+	return sqrt_iteration(x, x > 1 ? x : 1, 32);
+}
 
-Glyphs::Glyphs(char max_char, const Glyph* fallback) :
-	fallback(fallback),
-	max_char(get_index(max_char)),
-	contents(new const Glyph*[this->max_char + 1])
-{
-	for (size_t i = 0; i <= this->max_char; ++i) contents[i] = this->fallback;
+constexpr unsigned int constexpr_ceil(double x) {
+	return static_cast<unsigned int>(x)
+			+ (static_cast<unsigned int>(x) < x ? 1 : 0);
 }
 
-Glyphs::~Glyphs() {
-	for (size_t i = 0; i <= max_char; ++i) {
-		if (contents[i] != fallback) {
-			delete contents[i];
-		}
-	}
+constexpr unsigned int at_least(unsigned int min, unsigned int x) {
+	return x > min ? x : min;
+}
 
-	delete fallback;
-	delete[] contents;
+// Computed like get_circle_vertices() in graphics.cpp
+constexpr unsigned int get_circle_segments(double pixels) {
+	return at_least(MIN_CIRCLE_SEGMENTS, constexpr_ceil(
+			TAU / 2 * constexpr_sqrt(
+					constexpr_ceil(pixels) / (2 * GLYPH_TESSELLATION_ERROR)
+			)
+	));
 }
 
-size_t Glyphs::get_index(char c) const {
-	return static_cast<unsigned char>(c);
+// Computed like get_arc_vertices() in graphics.cpp
+constexpr unsigned int get_arc_segments(
+		const GlyphRecord& record, double scale
+) {
+	return at_least(1, constexpr_ceil(
+			get_circle_segments(record.radius * scale)
+					* (record.end_angle > record.start_angle
+							? record.end_angle - record.start_angle
+							: record.start_angle - record.end_angle)
+					/ TAU
+	));
 }
 
-const Glyph& Glyphs::get(char for_char) const {
-	size_t index = get_index(for_char);
-	if (index > max_char) {
-		return *fallback;
-	}
+constexpr size_t get_vertex_count(const GlyphRecord& record, double scale) {
+	return record.type == LINE ? 2
+			: record.type == ARC ? get_arc_segments(record, scale) + 1
+			: 0;
+}
 
-	return *contents[index];
+constexpr float get_arc_angle(
+		const GlyphRecord& record, size_t index, double scale
+) {
+	return record.start_angle
+			+ static_cast<float>(index) / get_arc_segments(record, scale)
+					* (record.end_angle - record.start_angle);
 }
 
-void Glyphs::put(char c, const Glyph* glyph) {
-	if (contents[get_index(c)] != fallback) {
-		delete contents[get_index(c)];
-	}
+// Computed like the sector executor in commands.cpp
+constexpr ScreenPoint get_arc_vertex(const GlyphRecord& record, float angle) {
+	return {
+		static_cast<ScreenCoord>(
+				record.radius * constexpr_sin(angle) + record.a.x
+		),
+		static_cast<ScreenCoord>(
+				record.radius * constexpr_cos(angle) + record.a.y
+		)
+	};
+}
 
-	contents[get_index(c)] = glyph;
+constexpr ScreenPoint get_vertex(
+		const GlyphRecord& record, size_t index, double scale
+) {
+	return record.type == ARC
+			? get_arc_vertex(record, get_arc_angle(record, index, scale))
+			: index == 0
+					? ScreenPoint {record.a.x, record.a.y}
+					: ScreenPoint {record.b.x, record.b.y};
 }
 
-Glyphs default_glyphs('\xFF', new Glyph(4, 4,
-		new LinePrimitive({0,0}, {0,7}),
-		new LinePrimitive({0,7}, {4,7}),
-		new LinePrimitive({4,7}, {4,0}),
-		new LinePrimitive({4,0}, {0,0})
-));
+constexpr size_t count_vertices(double scale, size_t record = 0) {
+	return record == DEFAULT_FONT_RECORDS ? 0
+			: get_vertex_count(DEFAULT_FONT[record], scale)
+					+ count_vertices(scale, record + 1);
+}
 
-Glyphs& get_default_glyphs() {
-	return default_glyphs;
+constexpr size_t count_strips(size_t record = 0, size_t end = DEFAULT_FONT_RECORDS) {
+	return record == end ? 0
+			: (DEFAULT_FONT[record].type != GLYPH)
+					+ count_strips(record + 1, end);
 }
 
-/*
- * Default font
- */
+constexpr size_t find_strip_record(size_t index, size_t record = 0) {
+	return DEFAULT_FONT[record].type == GLYPH
+			? find_strip_record(index, record + 1)
+			: index == 0
+					? record
+					: find_strip_record(index - 1, record + 1);
+}
 
-void register_default_glyphs(Glyphs& output) {
-	typedef ArcPrimitive Arc;
-	typedef LinePrimitive Line;
+constexpr LineStrip find_strip(
+		double scale, size_t index,
+		size_t record = 0, size_t first_vertex = 0
+) {
+	return DEFAULT_FONT[record].type == GLYPH
+			? find_strip(scale, index, record + 1, first_vertex)
+			: index == 0
+					? LineStrip {
+							static_cast<unsigned short>(first_vertex),
+							static_cast<unsigned short>(
+									get_vertex_count(DEFAULT_FONT[record], scale)
+							)
+					}
+					: find_strip(
+							scale, index - 1, record + 1,
+							first_vertex + get_vertex_count(
+									DEFAULT_FONT[record], scale
+							)
+					);
+}
 
+constexpr size_t DEFAULT_FONT_STRIPS = count_strips();
 
+template< size_t... I >
+constexpr Table<LineStrip, sizeof...(I)> build_strips(
+		Sequence<I...>, double scale
+) {
+	return {{ find_strip(scale, I)... }};
+}
 
-	output.put(' ', new Glyph(2, 0));
+template< size_t... I >
+constexpr Table<size_t, sizeof...(I)> build_strip_records(Sequence<I...>) {
+	return {{ find_strip_record(I)... }};
+}
 
+constexpr Table<size_t, DEFAULT_FONT_STRIPS> DEFAULT_STRIP_RECORDS =
+		build_strip_records(MakeSequence<DEFAULT_FONT_STRIPS>::Type());
 
+/*
+ * The strips of the default font tessellated for a level of detail. Only the
+ * vertices they refer to differ between levels.
+ */
+template< size_t DETAIL >
+struct DetailStrips {
+	static constexpr Table<LineStrip, DEFAULT_FONT_STRIPS> TABLE = build_strips(
+			MakeSequence<DEFAULT_FONT_STRIPS>::Type(),
+			GLYPH_DETAIL_SCALES[DETAIL]
+	);
+};
+
+template< size_t DETAIL >
+constexpr Table<LineStrip, DEFAULT_FONT_STRIPS> DetailStrips<DETAIL>::TABLE;
+
+// Binary search for the strip that contains the vertex
+template< size_t DETAIL >
+constexpr size_t find_vertex_strip(
+		size_t index,
+		size_t min = 0, size_t max = DEFAULT_FONT_STRIPS
+) {
+	return max - min == 1 ? min
+			: index < DetailStrips<DETAIL>::TABLE.items[(min + max) / 2].first
+					? find_vertex_strip<DETAIL>(index, min, (min + max) / 2)
+					: find_vertex_strip<DETAIL>(index, (min + max) / 2, max);
+}
 
-	output.put('0', new Glyph(4, 5,
-			new Arc ({2,2}, 2, PI/2, 3*PI/2),
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2),
-			new Line({4,2}, {4,5}),
-			new Line({3.5f, 2.5f}, {0.5f, 4.5f})
-	));
-	output.put('1', new Glyph(4, 3,
-			new Arc ({0,0}, 2, 0, PI/2),
-			new Line({2,0}, {2,7}),
-			new Line({0,7}, {4,7})
-	));
-	output.put('2', new Glyph(4, 4,
-			new Arc ({2,2}, 2, 0, 3*PI/2),
-			new Arc ({2,6}, 2, PI, 3*PI/2),
-			new Line({0,6}, {0,7}),
-			new Line({0,7}, {4,7})
-	));
-	output.put('3', new Glyph(4, 3,
-			new Line({0,0}, {4,0}),
-			new Line({4,0}, {2,3}),
-			new Arc ({2,5}, 2, -PI/2, PI)
-	));
-	output.put('4', new Glyph(4, 3,
-			new Line({4,4}, {0,4}),
-			new Line({0,4}, {3,0}),
-			new Line({3,0}, {3,7})
-	));
-	output.put('5', new Glyph(4, 4,
-			new Line({4,0}, {0,0}),
-			new Line({0,0}, {0,3}),
-			new Line({0,3}, {2,3}),
-			new Arc ({2,5}, 2, -PI/2, PI)
-	));
-	output.put('6', new Glyph(4, 3,
-			new Arc ({2,2}, 2, PI/2, 3*PI/2),
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, 0, 2*PI)
-	));
-	output.put('7', new Glyph(4, 2,
-			new Line({0,0}, {4,0}),
-			new Line({4,0}, {0,7})
-	));
-	output.put('8', new Glyph(4, 2,
-			new Arc ({2, 1.5f}, 1.5f, 0, 2*PI),
-			new Arc ({2,5}, 2, 0, 2*PI)
-	));
-	output.put('9', new Glyph(4, 3,
-			new Arc ({2,2}, 2, 0, 2*PI),
-			new Line({4,2}, {4,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2)
-	));
+template< size_t DETAIL >
+constexpr ScreenPoint find_vertex(size_t index, size_t strip) {
+	return get_vertex(
+			DEFAULT_FONT[DEFAULT_STRIP_RECORDS.items[strip]],
+			index - DetailStrips<DETAIL>::TABLE.items[strip].first,
+			GLYPH_DETAIL_SCALES[DETAIL]
+	);
+}
 
+template< size_t DETAIL, size_t... I >
+constexpr Table<ScreenPoint, sizeof...(I)> build_vertices(Sequence<I...>) {
+	return {{ find_vertex<DETAIL>(I, find_vertex_strip<DETAIL>(I))... }};
+}
 
+/*
+ * The vertices of the default font tessellated for a level of detail.
+ */
+template< size_t DETAIL >
+struct DetailVertices {
+	static constexpr size_t COUNT = count_vertices(GLYPH_DETAIL_SCALES[DETAIL]);
 
-	output.put('.', new Glyph(1, 1,
-			new Arc ({0.5f, 6.5f}, 0.5f, 0, 2*PI)
-	));
-	output.put(',', new Glyph(1, 1,
-			new Arc ({-2,7}, 2, 0, PI/2)
-	));
-	output.put(':', new Glyph(1, 2,
-			new Arc ({0.5f, 3}, 0.5f, 0, 2*PI),
-			new Arc ({0.5f, 6}, 0.5f, 0, 2*PI)
-	));
-	output.put('-', new Glyph(2, 1,
-			new Line({0,3}, {2,3})
-	));
-	output.put('\xA9', new Glyph(5, 2,
-			new Arc ({2.5f, 4.5f}, 2.5f, 0, 2*PI),
-			new Arc ({2.5f, 4.5f}, 1.5f, PI, 2*PI)
-	));
+	static_assert(
+			COUNT <= 0xFFFF,
+			"LineStrip cannot address all vertices of the default font"
+	);
 
+	static constexpr Table<ScreenPoint, COUNT> TABLE =
+			build_vertices<DETAIL>(typename MakeSequence<COUNT>::Type());
+};
 
+template< size_t DETAIL >
+constexpr Table<ScreenPoint, DetailVertices<DETAIL>::COUNT>
+		DetailVertices<DETAIL>::TABLE;
 
-	output.put('A', new Glyph(4, 4,
-			new Arc ({2,2}, 2, PI/2, 3*PI/2),
-			new Line({0,7}, {0,2}),
-			new Line({4,7}, {4,2}),
-			new Line({0,3}, {4,3})
-	));
-	output.put('B', new Glyph(4, 6,
-			new Arc ({2, 1.5f}, 1.5f, 0, PI),
-			new Arc ({2,5}, 2, 0, PI),
-			new Line({0,0}, {0,7}),
-			new Line({0,0}, {2,0}),
-			new Line({0,3}, {2,3}),
-			new Line({0,7}, {2,7})
-	));
-	output.put('C', new Glyph(4, 5,
-			new Line({4,0}, {2,0}),
-			new Arc ({2,2}, 2, PI, 3*PI/2),
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, 3*PI/2, 2*PI),
-			new Line({2,7}, {4,7})
-	));
-	output.put('D', new Glyph(4, 6,
-			new Line({0,0}, {2,0}),
-			new Arc ({2,2}, 2, PI/2, PI),
-			new Line({4,2}, {4,5}),
-			new Arc ({2,5}, 2, 0, PI/2),
-			new Line({0,7}, {2,7}),
-			new Line({0,0}, {0,7})
-	));
-	output.put('E', new Glyph(4, 4,
-			new Line({0,0}, {0,7}),
-			new Line({0,0}, {4,0}),
-			new Line({0,3}, {3,3}),
-			new Line({0,7}, {4,7})
-	));
-	output.put('F', new Glyph(4, 3,
-			new Line({0,0}, {0,7}),
-			new Line({0,0}, {4,0}),
-			new Line({0,3}, {3,3})
-	));
-	output.put('G', new Glyph(4, 5,
-			new Arc ({2,2}, 2, PI/2, 3*PI/2),
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2),
-			new Line({4,5}, {4,4}),
-			new Line({4,4}, {2,4})
-	));
-	output.put('H', new Glyph(4, 3,
-			new Line({0,0}, {0,7}),
-			new Line({4,0}, {4,7}),
-			new Line({0,3}, {4,3})
-	));
-	output.put('I', new Glyph(3, 3,
-			new Line({1.5f, 0}, {1.5f, 7}),
-			new Line({0,0}, {3,0}),
-			new Line({0,7}, {3,7})
-	));
-	output.put('J', new Glyph(3, 3,
-			new Line({0,0}, {3,0}),
-			new Line({3,0}, {3,4}),
-			new Arc ({0,4}, 3, 0, PI/2)
-	));
-	output.put('K', new Glyph(4, 3,
-			new Line({0,0}, {0,7}),
-			new Line({0,3}, {4,0}),
-			new Line({0,3}, {4,7})
-	));
-	output.put('L', new Glyph(4, 2,
-			new Line({0,0}, {0,7}),
-			new Line({0,7}, {4,7})
-	));
-	output.put('M', new Glyph(5, 4,
-			new Line({0,7}, {0,0}),
-			new Line({0,0}, {2.5f, 5}),
-			new Line({2.5f, 5}, {5,0}),
-			new Line({5,0}, {5,7})
-	));
-	output.put('N', new Glyph(4, 3,
-			new Line({0,7}, {0,0}),
-			new Line({0,0}, {4,7}),
-			new Line({4,7}, {4,0})
-	));
-	output.put('O', new Glyph(4, 4,
-			new Arc ({2,2}, 2, PI/2, 3*PI/2),
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2),
-			new Line({4,2}, {4,5})
-	));
-	output.put('P', new Glyph(4, 6,
-			new Line({0,0}, {2,0}),
-			new Arc ({2,2}, 2, PI/2, PI),
-			new Line({4,2}, {4,3}),
-			new Arc ({2,3}, 2, 0, PI/2),
-			new Line({0,5}, {2,5}),
-			new Line({0,0}, {0,7})
-	));
-	output.put('Q', new Glyph(4, 5,
-			new Arc ({2,2}, 2, PI/2, 3*PI/2),
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2),
-			new Line({4,2}, {4,5}),
-			new Line({2,7}, {4,8})
-	));
-	output.put('R', new Glyph(4, 7,
-			new Line({0,0}, {2,0}),
-			new Arc ({2,2}, 2, PI/2, PI),
-			new Line({4,2}, {4,3}),
-			new Arc ({2,3}, 2, 0, PI/2),
-			new Line({0,5}, {2,5}),
-			new Line({0,0}, {0,7}),
-			new Arc ({2,7}, 2, PI/2, PI)
-	));
-	output.put('S', new Glyph(4, 7,
-			new Line({4,0}, {1.5f, 0}),
-			new Arc ({1.5f, 1.5f}, 1.5f, PI, 2*PI),
-			new Line({1.5f, 3}, {2.5f, 3}),
-			new Arc ({2.5f, 4.5f}, 1.5f, PI/2, PI),
-			new Line({4, 4.5f}, {4, 5.5f}),
-			new Arc ({2.5f, 5.5f}, 1.5f, 0, PI/2),
-			new Line({2.5f, 7}, {0, 7})
-	));
-	output.put('T', new Glyph(4, 2,
-			new Line({0,0}, {4,0}),
-			new Line({2,0}, {2,7})
-	));
-	output.put('U', new Glyph(4, 3,
-			new Line({0,0}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2),
-			new Line({4,5}, {4,0})
-	));
-	output.put('V', new Glyph(4, 2,
-			new Line({0,0}, {2,7}),
-			new Line({2,7}, {4,0})
-	));
-	output.put('W', new Glyph(5, 4,
-			new Line({0,0}, {1,7}),
-			new Line({1,7}, {2.5f, 3}),
-			new Line({2.5f, 3}, {4,7}),
-			new Line({4,7}, {5,0})
-	));
-	output.put('X', new Glyph(4, 2,
-			new Line({0,0}, {4,7}),
-			new Line({4,0}, {0,7})
-	));
-	output.put('Y', new Glyph(4, 3,
-			new Line({0,0}, {2,3}),
-			new Line({4,0}, {2,3}),
-			new Line({2,3}, {2,7})
-	));
-	output.put('Z', new Glyph(4, 3,
-			new Line({0,0}, {4,0}),
-			new Line({4,0}, {0,7}),
-			new Line({0,7}, {4,7})
-	));
+/*
+ * Returns the index of the record of the glyph for the character, or 0 if
+ * it has none.
+ */
+constexpr size_t find_glyph_record(unsigned char code, size_t record = 0) {
+	return record == DEFAULT_FONT_RECORDS ? 0
+			: DEFAULT_FONT[record].type == GLYPH
+					&& DEFAULT_FONT[record].code == code
+			? record
+			: find_glyph_record(code, record + 1);
+}
+
+constexpr size_t find_glyph_end(size_t record) {
+	return record == DEFAULT_FONT_RECORDS
+			|| DEFAULT_FONT[record].type == GLYPH
+			? record
+			: find_glyph_end(record + 1);
+}
 
+template< size_t DETAIL >
+constexpr GlyphDetail make_glyph_detail(size_t record) {
+	return {
+		DetailVertices<DETAIL>::TABLE.items,
+		DetailStrips<DETAIL>::TABLE.items + count_strips(0, record)
+	};
+}
 
+template< size_t... DETAIL >
+constexpr Glyph make_glyph(size_t record, Sequence<DETAIL...>) {
+	return Glyph(
+			DEFAULT_FONT[record].width,
+			GlyphDetails {{ make_glyph_detail<DETAIL>(record)... }},
+			static_cast<unsigned short>(
+					count_strips(record + 1, find_glyph_end(record + 1))
+			)
+	);
+}
 
-	output.put('a', new Glyph(4, 7,
-			new Line({0,2}, {3,2}),
-			new Arc ({3,3}, 1, PI/2, PI),
-			new Line({4,3}, {4,7}),
-			new Arc ({2.5f, 5.5f}, 1.5f, 0, PI/2),
-			new Line({2.5f, 7}, {1.5f, 7}),
-			new Arc ({1.5f, 5.5f}, 1.5f, PI, 2*PI),
-			new Line({1.5f, 4}, {4,4})
-	));
-	output.put('b', new Glyph(4, 4,
-			new Line({0,0}, {0,7}),
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({4,4}, {4,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2)
-	));
-	output.put('c', new Glyph(3, 5,
-			new Line({3,2}, {2,2}),
-			new Arc ({2,4}, 2, PI, 3*PI/2),
-			new Line({0,4}, {0,5}),
-			new Arc ({2,5}, 2, 3*PI/2, 2*PI),
-			new Line({2,7}, {3,7})
-	));
-	output.put('d', new Glyph(4, 4,
-			new Line({4,0}, {4,7}),
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({0,4}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2)
-	));
-	output.put('e', new Glyph(4, 4,
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({0,4}, {4,4}),
-			new Arc ({3,4}, 3, -PI/2, 0),
-			new Line({3,7}, {4,7})
-	));
-	output.put('f', new Glyph(3, 4,
-			new Arc ({3, 1.5f}, 1.5f, PI, 3*PI/2),
-			new Line({1.5f, 1.5f}, {1.5f, 5.5f}),
-			new Arc ({0, 5.5f}, 1.5f, 0, PI/2),
-			new Line({0,3}, {3,3})
-	));
-	output.put('g', new Glyph(4, 6,
-			new Line({4,2}, {4,7}),
-			new Arc ({2,7}, 2, 0, PI/2),
-			new Line({2,9}, {0,9}),
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({0,4}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2)
-	));
-	output.put('h', new Glyph(4, 3,
-			new Line({0,0}, {0,7}),
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({4,4}, {4,7})
-	));
-	output.put('i', new Glyph(3, 4,
-			new Line({0,7}, {3,7}),
-			new Line({1.5f, 7}, {1.5f, 3}),
-			new Line({1.5f, 3}, {0,3}),
-			new Arc ({1.5f, 1.5f}, 0.5f, 0, 2*PI)
-	));
-	output.put('j', new Glyph(2, 4,
-			new Arc ({0,7}, 2, 0, PI/2),
-			new Line({2,7}, {2,3}),
-			new Line({2,3}, {0,3}),
-			new Arc ({1.5f, 1.5f}, 0.5f, 0, 2*PI)
-	));
-	output.put('k', new Glyph(3, 3,
-			new Line({0,0}, {0,7}),
-			new Line({0, 4.5f}, {3,2}),
-			new Line({0, 4.5f}, {3,7})
-	));
-	output.put('l', new Glyph(1.5f, 2,
-			new Line({0,0}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, 0)
-	));
-	output.put('m', new Glyph(6, 5,
-			new Line({0,7}, {0,2}),
-			new Arc ({1.5f, 3.5f}, 1.5f, PI/2, 3*PI/2),
-			new Line({3, 3.5f}, {3,7}),
-			new Arc ({4.5f, 3.5f}, 1.5f, PI/2, 3*PI/2),
-			new Line({6, 3.5f}, {6,7})
-	));
-	output.put('n', new Glyph(4, 3,
-			new Line({0,2}, {0,7}),
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({4,4}, {4,7})
-	));
-	output.put('o', new Glyph(5, 1,
-			new Arc ({2.5f, 4.5f}, 2.5f, 0, 2*PI)
-	));
-	output.put('p', new Glyph(4, 4,
-			new Line({0,2}, {0,9}),
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({4,4}, {4,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2)
-	));
-	output.put('q', new Glyph(4, 4,
-			new Line({4,2}, {4,9}),
-			new Arc ({2,4}, 2, PI/2, 3*PI/2),
-			new Line({0,4}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2)
-	));
-	output.put('r', new Glyph(3, 3,
-			new Line({0,2}, {0,7}),
-			new Arc ({2,4}, 2, PI, 3*PI/2),
-			new Line({2,2}, {3,2})
-	));
-	output.put('s', new Glyph(4, 5,
-			new Line({4,2}, {1,2}),
-			new Arc ({1,3}, 1, PI, 2*PI),
-			new Line({1,4}, {2.5f, 4}),
-			new Arc ({2.5f, 5.5f}, 1.5f, 0, PI),
-			new Line({2.5f, 7}, {0,7})
-	));
-	output.put('t', new Glyph(3, 3,
-			new Line({1,0}, {1,5}),
-			new Arc ({3,5}, 2, 3*PI/2, 2*PI),
-			new Line({0,3}, {3,3})
-	));
-	output.put('u', new Glyph(4, 3,
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2),
-			new Line({4,2}, {4,7})
-	));
-	output.put('v', new Glyph(4, 2,
-			new Line({0,2}, {2,7}),
-			new Line({2,7}, {4,2})
-	));
-	output.put('w', new Glyph(6, 5,
-			new Line({0,2}, {0, 5.5f}),
-			new Arc ({1.5f, 5.5f}, 1.5f, -PI/2, PI/2),
-			new Line({3,2}, {3, 5.5f}),
-			new Arc ({4.5f, 5.5f}, 1.5f, -PI/2, PI/2),
-			new Line({6,2}, {6, 5.5f})
-	));
-	output.put('x', new Glyph(4, 2,
-			new Line({0,2}, {4,7}),
-			new Line({0,7}, {4,2})
-	));
-	output.put('y', new Glyph(4, 5,
-			new Line({0,2}, {0,5}),
-			new Arc ({2,5}, 2, -PI/2, PI/2),
-			new Line({4,2}, {4,7}),
-			new Arc ({2,7}, 2, 0, PI/2),
-			new Line({2,9}, {0,9})
-	));
-	output.put('z', new Glyph(4, 3,
-			new Line({0,2}, {4,2}),
-			new Line({4,2}, {0,7}),
-			new Line({0,7}, {4,7})
-	));
+template< size_t... I >
+constexpr Table<Glyph, sizeof...(I)> build_glyphs(Sequence<I...>) {
+	return {{
+		make_glyph(
+				find_glyph_record(I),
+				MakeSequence<GLYPH_DETAILS>::Type()
+		)...
+	}};
+}
+
+constexpr Table<Glyph, 256> DEFAULT_GLYPH_TABLE =
+		build_glyphs(MakeSequence<256>::Type());
+
+constexpr Glyphs DEFAULT_GLYPHS(DEFAULT_GLYPH_TABLE.items);
+
+const Glyphs& get_default_glyphs() {
+	return DEFAULT_GLYPHS;
 }
@@ -21,76 +21,63 @@
 
 #include "../common.h"
 
-#include <cstdarg>
+#include "commands.h"
 
 
 typedef float GlyphCoord;
 struct GlyphPoint {
 	GlyphCoord x, y;
-
-	operator ScreenPoint() const {
-		return {static_cast<float>(x), static_cast<float>(y)};
-	}
 };
 
 const GlyphCoord GLYPH_HEIGHT = 9;
 
 /*
- * Primitives
+ * Glyph
  */
-class Primitive {
-public:
-	virtual ~Primitive() {}
-	virtual void render() = 0;
-};
 
-class LinePrimitive : public Primitive {
-private:
-	GlyphPoint start, end;
-public:
-	LinePrimitive(GlyphPoint start, GlyphPoint end) :
-		start(start), end(end) {}
+/*
+ * Arcs of glyphs are tessellated for several levels of detail, so that they
+ * look smooth in large text without costing vertices in small text.
+ */
+const size_t GLYPH_DETAILS = 3;
 
-	void render() override;
+/*
+ * Where one level of detail of a glyph is in the tables of its font.
+ */
+struct GlyphDetail {
+	const ScreenPoint *vertices;
+	const LineStrip *strips;
 };
 
-class ArcPrimitive : public Primitive {
-private:
-	GlyphPoint center;
-	GlyphCoord radius;
-	float start_angle, end_angle;
-public:
-	ArcPrimitive(
-			GlyphPoint center, GlyphCoord radius,
-			float start_angle, float end_angle) :
-		center(center), radius(radius),
-		start_angle(start_angle), end_angle(end_angle) {}
-
-	void render() override;
+struct GlyphDetails {
+	GlyphDetail items[GLYPH_DETAILS];
 };
 
 /*
- * Glyph
+ * A glyph is a range of line strips in the vertex table of its font. Glyphs
+ * are constant data built at compile time.
  */
-
 class Glyph {
 private:
 	GlyphCoord width;
 
-	Primitive* *primitives;
-	size_t primitive_count;
+	GlyphDetails details;
+	unsigned short strip_count;
 
 public:
-	Glyph(
+	constexpr Glyph(
 			GlyphCoord width,
-			size_t primitive_count, ...
-	);
-
-	~Glyph();
+			GlyphDetails details, unsigned short strip_count
+	) :
+		width(width),
+		details(details), strip_count(strip_count) {}
 
 	GlyphCoord get_width() const {
 		return width;
 	}
+	/*
+	 * Draws the level of detail that suits the current scale.
+	 */
 	void render() const;
 	bool is_whitespace() const;
 };
@@ -99,31 +86,24 @@ public:
  * Glyphs
  */
 
+/*
+ * A font: one glyph for every 8-bit character. Characters without a glyph of
+ * their own share a fallback glyph.
+ */
 class Glyphs {
 private:
-	const Glyph* fallback;
-	const size_t max_char;
-	const Glyph ** const contents;
-
-	size_t get_index(char c) const;
+	const Glyph *contents;
 
 public:
-	Glyphs(char max_char, const Glyph* fallback);
-	~Glyphs();
-
-	const Glyph& get(char for_char) const;
+	constexpr Glyphs(const Glyph *contents) :
+		contents(contents) {}
 
-	/*
-	 * Associates the given glyph with the given character.
-	 * Given pointer will be deleted with this Glyphs instance. Duplicate
-	 * glyphs are not allowed.
-	 */
-	void put(char c, const Glyph* glyph);
+	const Glyph& get(char for_char) const {
+		return contents[static_cast<unsigned char>(for_char)];
+	}
 };
 
-Glyphs& get_default_glyphs();
-
-void register_default_glyphs(Glyphs& output);
+const Glyphs& get_default_glyphs();
 
 
 #endif /* GLYPH_H_ */
@@ -18,36 +18,156 @@
 
 #include "graphics.h"
 
+#include <atomic>
+
+#include "../allocations.h"
 #include "../logic/logic.h"
+#include "commands.h"
+#include "gl_extensions.h"
+#include "offscreen.h"
+#include "quality.h"
+#include "render_thread.h"
 
 #include "ui/ui.h"
 
-GLFWwindow *window;
+const int DEFAULT_WIDTH = 800, DEFAULT_HEIGHT = 600;
+const int MSAA_SAMPLES = 4;
+
+// Offscreen frames are spaced evenly so that their contents are reproducible
+const Timestamp OFFSCREEN_FRAME_LENGTH = NANOSECONDS_PER_SECOND / 60;
+
+GLFWwindow *window = nullptr;
+
+bool offscreen = false;
+WindowDimensions offscreen_size = {DEFAULT_WIDTH, DEFAULT_HEIGHT};
+bool offscreen_close_requested = false;
+std::atomic<Timestamp> offscreen_time(0);
+
+bool use_render_thread = true;
+bool use_sdf_shapes = false;
+bool use_layer_caching = true;
+RenderBackend backend;
 
 Time last_frame_length;
-Time last_frame;
+Timestamp last_frame;
 
 void on_key_event(GLFWwindow*, int key, int scanmode, int action, int mods);
 void on_resize(GLFWwindow*, int width, int height);
+void on_refresh(GLFWwindow*);
+
+void set_offscreen_mode(int width, int height) {
+	offscreen = true;
+	offscreen_size = {width, height};
+}
+
+bool is_offscreen() {
+	return offscreen;
+}
+
+void set_render_thread_enabled(bool enabled) {
+	use_render_thread = enabled;
+}
+
+void set_sdf_shapes_enabled(bool enabled) {
+	use_sdf_shapes = enabled;
+}
+
+void set_layer_caching_enabled(bool enabled) {
+	use_layer_caching = enabled;
+}
+
+bool is_layer_caching_available() {
+	return use_layer_caching && gl.has_render_to_texture;
+}
+
+// Of the primary monitor, 0 if unknown
+double refresh_rate = 0;
 
-void setup_graphics() {
+double get_refresh_rate() {
+	return refresh_rate;
+}
+
+void* get_window_proc_address(const char *name) {
+	return reinterpret_cast<void*>(glfwGetProcAddress(name));
+}
+
+bool setup_window() {
 	glfwInit();
 
-	glfwWindowHint(GLFW_SAMPLES, 4);
-	window = glfwCreateWindow(800, 600, "ClearOut", NULL, NULL);
+	const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+	if (mode != nullptr) {
+		refresh_rate = mode->refreshRate;
+	}
+
+	glfwWindowHint(GLFW_SAMPLES, MSAA_SAMPLES);
+	window = glfwCreateWindow(
+			DEFAULT_WIDTH, DEFAULT_HEIGHT, "ClearOut", NULL, NULL
+	);
+
+	if (window == nullptr) {
+		std::cerr << "Could not create window" << std::endl;
+		return false;
+	}
+
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
 	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1);
+	apply_swap_interval();
 
 	glfwSetKeyCallback(window, on_key_event);
 	glfwSetWindowSizeCallback(window, on_resize);
+	glfwSetWindowRefreshCallback(window, on_refresh);
+
+	if (!load_gl_extensions(get_window_proc_address)) {
+		std::cerr << "Some OpenGL features will not be available" << std::endl;
+	}
+
+	return true;
+}
+
+bool setup_offscreen() {
+	return create_offscreen_context(
+					offscreen_size.width, offscreen_size.height, MSAA_SAMPLES
+			)
+			&& load_gl_extensions(get_offscreen_proc_address)
+			&& create_offscreen_framebuffer();
+}
+
+void present_frame();
+
+void setup_backend() {
+	if (offscreen) {
+		backend.acquire_context = [](void) {
+			set_offscreen_context_current(true);
+		};
+		backend.release_context = [](void) {
+			set_offscreen_context_current(false);
+		};
+	} else {
+		backend.acquire_context = [](void) {
+			glfwMakeContextCurrent(window);
+		};
+		backend.release_context = [](void) {
+			glfwMakeContextCurrent(nullptr);
+		};
+	}
+
+	backend.present = present_frame;
+}
+
+bool setup_graphics() {
+	if (!(offscreen ? setup_offscreen() : setup_window())) {
+		return false;
+	}
+
+	setup_backend();
 
 	glDisable(GL_DEPTH_TEST);
 	glEnable(GL_BLEND);
 
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	on_resize(window, 800, 600);
+	WindowDimensions size = get_window_size();
+	on_resize(window, size.width, size.height);
 
 	glClearColor(
 			Design::BACKGROUND.red,
@@ -56,30 +176,146 @@ void setup_graphics() {
 			0.0f
 	);
 
-	register_default_glyphs(get_default_glyphs());
+	if (use_render_thread) {
+		start_render_thread(backend);
+	}
+
+	last_frame = get_time();
+	return true;
 }
 
 void terminate_graphics() {
 	remove_all_layers();
-	glfwTerminate();
+
+	stop_render_thread();
+
+	// Not set if the window or the offscreen context could not be created
+	if (backend.acquire_context != nullptr) {
+		backend.acquire_context();
+	}
+
+	if (offscreen) {
+		destroy_offscreen_context();
+	} else {
+		glfwTerminate();
+	}
 }
 
 bool should_close() {
+	if (offscreen) {
+		return offscreen_close_requested;
+	}
+
 	return glfwWindowShouldClose(window);
 }
 
+void request_close() {
+	if (offscreen) {
+		offscreen_close_requested = true;
+	} else {
+		glfwSetWindowShouldClose(window, GLFW_TRUE);
+	}
+}
+
+void poll_events() {
+	if (!offscreen) {
+		glfwPollEvents();
+	}
+}
+
+void wait_for_events(Time timeout) {
+	if (offscreen) {
+		offscreen_time.store(offscreen_time.load() + to_timestamp(timeout));
+	} else {
+		glfwWaitEventsTimeout(timeout);
+	}
+
+	// Nothing moved while waiting, so the next frame is not a long one
+	last_frame = get_time();
+	on_rendering_idle();
+}
+
+void present_frame() {
+	if (offscreen) {
+		present_offscreen_frame();
+	} else {
+		glfwSwapBuffers(window);
+	}
+}
+
+bool is_multisampling = true;
+
+void apply_multisampling() {
+	bool enabled = get_quality().multisampling;
+
+	// The state stays with the context, frames are executed in order
+	if (enabled != is_multisampling) {
+		is_multisampling = enabled;
+		get_command_buffer().write(
+				SET_MULTISAMPLING, MultisamplingCommand {enabled}
+		);
+	}
+}
+
 void render() {
-	glClear(GL_COLOR_BUFFER_BIT);
+	if (offscreen) {
+		offscreen_time.store(offscreen_time.load() + OFFSCREEN_FRAME_LENGTH);
+	} else {
+		wait_for_next_frame();
+	}
 
-	render_layers();
+	if (get_pacing().late_input) {
+		poll_events();
+	}
 
-	Time this_frame = glfwGetTime();
-	last_frame_length = this_frame - last_frame;
+	Timestamp this_frame = get_time();
+	last_frame_length = to_seconds(this_frame - last_frame);
 	last_frame = this_frame;
 
-	glfwSwapBuffers(window);
+	end_allocation_frame();
+
+	Timestamp record_start = get_monotonic_time();
+
+	get_command_buffer().write(CLEAR);
+	apply_multisampling();
+
+	{
+		AllocationPhaseScope allocation_phase(RENDER_PHASE);
+		render_layers();
+	}
+
+	Time record_length = to_seconds(get_monotonic_time() - record_start);
+	submit_frame(backend);
+
+	// Recording and execution overlap on the render thread
+	if (!offscreen) {
+		on_frame_timing(
+				last_frame_length,
+				std::max(record_length, get_last_execution_length())
+		);
+	}
+
+	if (!get_pacing().late_input) {
+		poll_events();
+	}
+}
+
+void capture_frame(std::vector<unsigned char>& rgb) {
+	run_on_render_thread([&rgb](void) {
+		read_offscreen_frame(rgb);
+	});
+}
+
+void finish_rendering() {
+	run_on_render_thread(glFinish);
+}
+
+Timestamp get_time() {
+	if (offscreen) {
+		return offscreen_time.load();
+	}
 
-	glfwPollEvents();
+	return get_monotonic_time();
 }
 
 GLFWwindow* get_window_handle() {
@@ -90,14 +326,226 @@ Time get_frame_length() {
 	return last_frame_length;
 }
 
+Timestamp get_frame_time() {
+	return last_frame;
+}
+
 WindowDimensions get_window_size() {
+	if (offscreen) {
+		return offscreen_size;
+	}
+
 	WindowDimensions result;
 	glfwGetWindowSize(window, &result.width, &result.height);
 	return result;
 }
 
+ColorCommand current_color = {1, 1, 1, 1};
+
+/*
+ * Batching
+ */
+
+/*
+ * The transformation accumulated since the batch started: maps p to
+ * offset + scale * p.
+ */
+struct Placement {
+	ScreenPoint offset, scale;
+};
+
+bool is_batching = false;
+std::vector<Placement> batch_transforms;
+
+/*
+ * A rectangle covering the pixels a shape may touch, in the coordinates of
+ * the batch start.
+ */
+struct Bounds {
+	ScreenPoint min, max;
+
+	bool overlaps(const Bounds& x) const {
+		return min.x < x.max.x && x.min.x < max.x
+				&& min.y < x.max.y && x.min.y < max.y;
+	}
+
+	void extend(const Bounds& x) {
+		min = {std::min(min.x, x.min.x), std::min(min.y, x.min.y)};
+		max = {std::max(max.x, x.max.x), std::max(max.y, x.max.y)};
+	}
+};
+
+struct InstanceGroup {
+	ShapeKey shape;
+	std::vector<ShapeInstance> instances;
+
+	// Of each instance and of all of them
+	std::vector<Bounds> instance_bounds;
+	Bounds bounds;
+};
+
+// Groups waiting to be drawn, in paint order. Kept between batches so that
+// instance storage is reused.
+std::vector<InstanceGroup> batch_groups;
+size_t pending_groups = 0;
+
+// Groups are drawn once this many are waiting, each costs an overlap check
+const size_t MAX_PENDING_GROUPS = 16;
+
+// Lines are a pixel wide, so they reach half a pixel past their vertices
+const ScreenCoord LINE_REACH = 0.5f;
+
+/*
+ * Draws the groups collected so far in the order they were started. They may
+ * be flushed in the middle of a transformation, so instances are drawn with
+ * the matrix saved by BEGIN_BATCH, which their placements are relative to.
+ */
+void flush_batch() {
+	if (pending_groups == 0) {
+		return;
+	}
+
+	CommandBuffer& buffer = get_command_buffer();
+
+	for (size_t i = 0; i < pending_groups; ++i) {
+		InstanceGroup& group = batch_groups[i];
+
+		buffer.write(
+				DRAW_INSTANCES,
+				InstancesCommand {
+						group.shape,
+						static_cast<unsigned int>(group.instances.size())
+				},
+				group.instances.data(),
+				group.instances.size() * sizeof(ShapeInstance)
+		);
+		group.instances.clear();
+		group.instance_bounds.clear();
+	}
+	pending_groups = 0;
+
+	// Instances do not leave their color behind
+	buffer.write(SET_COLOR, current_color);
+}
+
+void begin_batch() {
+	if (is_batching) {
+		std::cerr << "Attempted to start batch while batch already started"
+				<< std::endl;
+		return;
+	}
+
+	is_batching = true;
+	batch_transforms.assign(1, {{0, 0}, {1, 1}});
+
+	// Groups are flushed under other transformations, see flush_batch()
+	get_command_buffer().write(BEGIN_BATCH);
+}
+
+void end_batch() {
+	if (!is_batching) {
+		return;
+	}
+
+	flush_batch();
+	is_batching = false;
+}
+
+/*
+ * Returns whether the shape overlaps one in a group drawn after the given
+ * one. Shapes may only join their group if not, or they would be painted
+ * under shapes submitted before them.
+ */
+bool overlaps_later_groups(size_t group, const Bounds& bounds) {
+	for (size_t i = group + 1; i < pending_groups; ++i) {
+		const InstanceGroup& later = batch_groups[i];
+
+		if (!bounds.overlaps(later.bounds)) {
+			continue;
+		}
+
+		for (const Bounds& instance : later.instance_bounds) {
+			if (bounds.overlaps(instance)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Adds the shape to the current batch. Returns false if no batch is started.
+ */
+bool batch_shape(const ShapeKey& shape, ScreenPoint origin, ScreenPoint size) {
+	if (!is_batching) {
+		return false;
+	}
+
+	const Placement& t = batch_transforms.back();
+	ScreenPoint offset = t.offset + t.scale * origin;
+	ScreenPoint scale = t.scale * size;
+
+	// Sectors are centered on the origin, other shapes span to the size
+	ScreenPoint a = offset, b = offset + scale;
+	if (shape.type == DRAW_SECTOR || shape.type == FILL_SECTOR) {
+		a = offset + scale * -1;
+	}
+
+	ScreenCoord margin = shape.type == FILL_RECTANGLE
+			|| shape.type == FILL_SECTOR ? 0 : LINE_REACH;
+
+	Bounds bounds = {
+			{std::min(a.x, b.x) - margin, std::min(a.y, b.y) - margin},
+			{std::max(a.x, b.x) + margin, std::max(a.y, b.y) + margin}
+	};
+
+	// One past the newest group of the shape. Unless the shape would then be
+	// painted under something submitted before it, it joins that group.
+	size_t group = pending_groups;
+	while (group > 0 && !(batch_groups[group - 1].shape == shape)) {
+		group--;
+	}
+
+	if (group == 0 || overlaps_later_groups(group - 1, bounds)) {
+		if (pending_groups == MAX_PENDING_GROUPS) {
+			flush_batch();
+		}
+
+		if (batch_groups.size() == pending_groups) {
+			batch_groups.emplace_back();
+		}
+
+		InstanceGroup& added = batch_groups[pending_groups++];
+		added.shape = shape;
+		added.bounds = bounds;
+		group = pending_groups;
+	}
+
+	InstanceGroup& target = batch_groups[group - 1];
+	target.bounds.extend(bounds);
+	target.instance_bounds.push_back(bounds);
+	target.instances.push_back({
+			offset,
+			scale,
+			current_color.red,
+			current_color.green,
+			current_color.blue,
+			current_color.alpha
+	});
+
+	return true;
+}
+
+void set_color(const ColorCommand& c) {
+	current_color = c;
+	get_command_buffer().write(SET_COLOR, c);
+}
+
 void set_color(Color c) {
-	glColor4f(c.red, c.green, c.blue, c.alpha);
+	set_color(ColorCommand {
+		c.red, c.green, c.blue, c.alpha
+	});
 }
 
 void set_color(unsigned int a, unsigned int r, unsigned int g, unsigned int b) {
@@ -109,45 +557,169 @@ void set_color(unsigned int r, unsigned int g, unsigned int b) {
 }
 
 void set_color(GLfloat a, unsigned int r, unsigned int g, unsigned int b) {
-	glColor4f(
+	set_color(ColorCommand {
 			normalize_channel(r),
 			normalize_channel(g),
 			normalize_channel(b),
 			a
-	);
+	});
 }
 
-inline void vertex(ScreenPoint p) {
-	glVertex2f(p.x, p.y);
+/*
+ * Transformations
+ */
+
+// Scale factors of the current transformation and the pushed ones
+std::vector<ScreenPoint> transform_scales(1, {1, 1});
+
+// Pixels per window pixel of the render cache being drawn into
+float render_resolution = 1;
+
+ScreenCoord get_transform_scale() {
+	const ScreenPoint& s = transform_scales.back();
+	return std::max(std::abs(s.x), std::abs(s.y)) * render_resolution;
+}
+
+void push_transform() {
+	transform_scales.push_back(transform_scales.back());
+
+	if (is_batching) {
+		batch_transforms.push_back(batch_transforms.back());
+	}
+
+	get_command_buffer().write(PUSH_TRANSFORM);
+}
+
+void pop_transform() {
+	if (transform_scales.size() > 1) {
+		transform_scales.pop_back();
+	}
+
+	if (is_batching && batch_transforms.size() > 1) {
+		batch_transforms.pop_back();
+	}
+
+	get_command_buffer().write(POP_TRANSFORM);
+}
+
+void translate(ScreenCoord x, ScreenCoord y) {
+	if (is_batching) {
+		Placement& t = batch_transforms.back();
+		t.offset += t.scale * ScreenPoint {x, y};
+	}
+
+	get_command_buffer().write(TRANSLATE, TransformCommand {x, y});
+}
+
+void scale(ScreenCoord x, ScreenCoord y) {
+	transform_scales.back() *= ScreenPoint {x, y};
+
+	if (is_batching) {
+		batch_transforms.back().scale *= ScreenPoint {x, y};
+	}
+
+	get_command_buffer().write(SCALE, TransformCommand {x, y});
 }
 
 void draw_line(ScreenPoint a, ScreenPoint b) {
-	glBegin(GL_LINES);
-		vertex(a);
-		vertex(b);
-	glEnd();
+	if (batch_shape({DRAW_LINE, 0, 0, 0}, a, {b.x - a.x, b.y - a.y})) {
+		return;
+	}
+
+	get_command_buffer().write(DRAW_LINE, LineCommand {a, b});
+}
+
+void draw_line_strips(
+		const ScreenPoint *vertices,
+		const LineStrip *strips, unsigned int count
+) {
+	flush_batch();
+	get_command_buffer().write(
+			DRAW_LINE_STRIPS,
+			LineStripsCommand {vertices, strips, count}
+	);
+}
+
+/*
+ * Render caches
+ */
+
+RenderCacheId next_render_cache = 0;
+std::vector<RenderCacheId> free_render_caches;
+
+RenderCacheId create_render_cache() {
+	if (free_render_caches.empty()) {
+		return next_render_cache++;
+	}
+
+	RenderCacheId id = free_render_caches.back();
+	free_render_caches.pop_back();
+	return id;
+}
+
+void destroy_render_cache(RenderCacheId id) {
+	flush_batch();
+	// Commands are executed in order, so the id can be reused right away
+	get_command_buffer().write(
+			DESTROY_RENDER_CACHE, RenderCacheCommand {id, 1}
+	);
+	free_render_caches.push_back(id);
+}
+
+void begin_render_cache(RenderCacheId id, float resolution) {
+	flush_batch();
+	get_command_buffer().write(
+			BEGIN_RENDER_CACHE, RenderCacheCommand {id, resolution}
+	);
+	render_resolution = resolution;
+}
+
+void end_render_cache() {
+	flush_batch();
+	get_command_buffer().write(END_RENDER_CACHE);
+	render_resolution = 1;
+}
+
+void draw_render_cache(RenderCacheId id) {
+	flush_batch();
+	get_command_buffer().write(DRAW_RENDER_CACHE, RenderCacheCommand {id, 1});
+}
+
+void set_clip(ScreenPoint min, ScreenPoint max) {
+	flush_batch();
+	get_command_buffer().write(SET_CLIP, RectangleCommand {min, max});
+}
+
+void clear_clip() {
+	flush_batch();
+	get_command_buffer().write(CLEAR_CLIP);
 }
 
 void fill_triangle(ScreenPoint a, ScreenPoint b, ScreenPoint c) {
-	glBegin(GL_TRIANGLES);
-		vertex(a);
-		vertex(b);
-		vertex(c);
-	glEnd();
+	flush_batch();
+	get_command_buffer().write(FILL_TRIANGLE, TriangleCommand {a, b, c});
 }
 
 void draw_rectangle(ScreenPoint min, ScreenPoint max) {
-	glBegin(GL_LINE_LOOP);
-		vertex(min);
-		vertex({min.x, max.y});
-		vertex(max);
-		vertex({max.x, min.y});
-	glEnd();
+	if (batch_shape(
+			{DRAW_RECTANGLE, 0, 0, 0},
+			min, {max.x - min.x, max.y - min.y}
+	)) {
+		return;
+	}
+
+	get_command_buffer().write(DRAW_RECTANGLE, RectangleCommand {min, max});
 }
 
 void fill_rectangle(ScreenPoint min, ScreenPoint max) {
-	fill_triangle(min, {min.x, max.y}, max);
-	fill_triangle(min, {max.x, min.y}, max);
+	if (batch_shape(
+			{FILL_RECTANGLE, 0, 0, 0},
+			min, {max.x - min.x, max.y - min.y}
+	)) {
+		return;
+	}
+
+	get_command_buffer().write(FILL_RECTANGLE, RectangleCommand {min, max});
 }
 
 void draw_rectangle(ScreenPoint min, ScreenCoord width, ScreenCoord height) {
@@ -184,24 +756,80 @@ void fill_rectangle_centered(
 	);
 }
 
+/*
+ * Tessellation
+ */
+
+const unsigned int MIN_CIRCLE_VERTICES = 8;
+
+// Counts are cached for on-screen radii rounded up to whole pixels
+const size_t CACHED_CIRCLE_RADII = 1024;
+unsigned int circle_vertices_cache[CACHED_CIRCLE_RADII] = {};
+
+// Tessellation error of the quality the cache was filled for
+ScreenCoord cached_tessellation_error = 0;
+
+unsigned int compute_circle_vertices(ScreenCoord pixels, ScreenCoord error) {
+	// A chord turning by a deviates from the arc by r (1 - cos(a/2)) <= r a^2/8
+	return std::max(
+			MIN_CIRCLE_VERTICES,
+			static_cast<unsigned int>(std::ceil(
+					PI * std::sqrt(pixels / (2 * error))
+			))
+	);
+}
+
+unsigned int get_circle_vertices(ScreenCoord radius) {
+	ScreenCoord error = get_quality().tessellation_error;
+	if (error != cached_tessellation_error) {
+		std::fill(
+				circle_vertices_cache,
+				circle_vertices_cache + CACHED_CIRCLE_RADII,
+				0
+		);
+		cached_tessellation_error = error;
+	}
+
+	ScreenCoord pixels = std::ceil(std::abs(radius) * get_transform_scale());
+
+	if (pixels >= CACHED_CIRCLE_RADII) {
+		return compute_circle_vertices(pixels, error);
+	}
+
+	unsigned int& cached =
+			circle_vertices_cache[static_cast<size_t>(pixels)];
+	if (cached == 0) {
+		cached = compute_circle_vertices(pixels, error);
+	}
+
+	return cached;
+}
+
+unsigned int get_arc_vertices(ScreenCoord radius, float start, float end) {
+	float turns = std::abs(end - start) / (2*PI);
+
+	return std::max(1u, static_cast<unsigned int>(
+			std::ceil(get_circle_vertices(radius) * turns)
+	));
+}
+
 void do_pseudo_sector(
 		ScreenPoint center, ScreenCoord radius,
 		unsigned int vertices,
 		float start, float end,
 		bool fill
 ) {
-	glBegin(fill ? GL_TRIANGLE_FAN : GL_LINE_STRIP);
-		if (fill) vertex(center);
-
-		for (float vertex = 0; vertex <= vertices; vertex++) {
-			float angle = start + vertex / vertices * (end - start);
-			glVertex2f(
-					radius * sin(angle) + center.x,
-					radius * cos(angle) + center.y
-			);
-		}
+	if (batch_shape(
+			{fill ? FILL_SECTOR : DRAW_SECTOR, vertices, start, end},
+			center, {radius, radius}
+	)) {
+		return;
+	}
 
-	glEnd();
+	get_command_buffer().write(
+			fill ? FILL_SECTOR : DRAW_SECTOR,
+			SectorCommand {center, radius, vertices, start, end}
+	);
 }
 
 void fill_polygon(
@@ -218,11 +846,41 @@ void draw_polygon(
 	do_pseudo_sector(center, radius, vertices, 0, 2*PI, false);
 }
 
-unsigned int inline get_circle_vertices(ScreenCoord radius) {
-	return 64 * radius;
+/*
+ * Records the shape for the distance field shader if enabled. Batches keep
+ * instancing tessellated shapes.
+ */
+bool record_sdf_shape(
+		ScreenPoint min, ScreenPoint max, ScreenCoord radius,
+		bool fill
+) {
+	if (!use_sdf_shapes || is_batching) {
+		return false;
+	}
+
+	get_command_buffer().write(
+			fill ? FILL_ROUNDED_RECTANGLE : DRAW_ROUNDED_RECTANGLE,
+			RoundedRectangleCommand {
+					min, max, radius,
+					get_arc_vertices(radius, 0, PI/2)
+			}
+	);
+	return true;
+}
+
+bool record_sdf_circle(ScreenPoint center, ScreenCoord radius, bool fill) {
+	return record_sdf_shape(
+			{center.x - radius, center.y - radius},
+			{center.x + radius, center.y + radius},
+			radius, fill
+	);
 }
 
 void fill_circle(ScreenPoint center, ScreenCoord radius) {
+	if (record_sdf_circle(center, radius, true)) {
+		return;
+	}
+
 	do_pseudo_sector(
 			center, radius,
 			get_circle_vertices(radius),
@@ -232,6 +890,10 @@ void fill_circle(ScreenPoint center, ScreenCoord radius) {
 }
 
 void draw_circle(ScreenPoint center, ScreenCoord radius) {
+	if (record_sdf_circle(center, radius, false)) {
+		return;
+	}
+
 	do_pseudo_sector(
 			center, radius,
 			get_circle_vertices(radius),
@@ -246,7 +908,7 @@ void fill_sector(
 ) {
 	do_pseudo_sector(
 			center, radius,
-			get_circle_vertices(radius),
+			get_arc_vertices(radius, start, end),
 			start, end,
 			true
 	);
@@ -257,7 +919,7 @@ void draw_arc(
 ) {
 	do_pseudo_sector(
 			center, radius,
-			get_circle_vertices(radius),
+			get_arc_vertices(radius, start, end),
 			start, end,
 			false
 	);
@@ -267,6 +929,10 @@ void draw_rounded_rectangle(
 		ScreenPoint min, ScreenPoint max,
 		ScreenCoord radius
 ) {
+	if (record_sdf_shape(min, max, radius, false)) {
+		return;
+	}
+
 	ScreenPoint
 		center_min = {
 				min.x + radius,
@@ -291,6 +957,10 @@ void fill_rounded_rectangle(
 		ScreenPoint min, ScreenPoint max,
 		ScreenCoord radius
 ) {
+	if (record_sdf_shape(min, max, radius, true)) {
+		return;
+	}
+
 	ScreenPoint
 		center_min = {
 				min.x + radius,
@@ -321,8 +991,12 @@ void on_key_event(
 		return;
 	}
 
+	Timestamp now = get_time();
+	on_input_received(now);
+
 	dispatch_key_event({
-		key, scanmode, action, mods
+		key, scanmode, action, mods,
+		now
 	});
 }
 
@@ -331,11 +1005,11 @@ void on_resize(GLFWwindow*, int width, int height) {
 		return;
 	}
 
-	glViewport(0, 0, width, height);
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	glOrtho(0, width, height, 0, 1, -1);
-	glMatrixMode(GL_MODELVIEW);
+	get_command_buffer().write(SET_VIEWPORT, ViewportCommand {width, height});
 
 	dispatch_resize();
 }
+
+void on_refresh(GLFWwindow*) {
+	request_frame();
+}
@@ -21,23 +21,91 @@
 
 #include <GLFW/glfw3.h>
 
+#include "../clock.h"
 #include "../common.h"
 #include "font.h"
+#include "pacing.h"
 #include "ui/ui.h"
 
 #include "design.h"
 
 
-void setup_graphics();
+/*
+ * Makes setup_graphics() render into an offscreen framebuffer of the given
+ * size instead of opening a window.
+ */
+void set_offscreen_mode(int width, int height);
+bool is_offscreen();
+
+/*
+ * Returns the refresh rate of the primary monitor in Hz, or 0 if it is not
+ * known, as when rendering offscreen.
+ */
+double get_refresh_rate();
+
+/*
+ * Selects whether GL commands are submitted from a dedicated thread. Must be
+ * called before setup_graphics().
+ */
+void set_render_thread_enabled(bool);
+
+/*
+ * Selects whether circles and rounded rectangles outside of batches are drawn
+ * by a distance field shader instead of being tessellated. Falls back to
+ * tessellation when shaders are not available.
+ */
+void set_sdf_shapes_enabled(bool);
+
+/*
+ * Selects whether layers without animated components are drawn from render
+ * caches. Enabled by default.
+ */
+void set_layer_caching_enabled(bool);
+
+/*
+ * Returns whether layer caching is enabled and supported by the context.
+ * Valid after setup_graphics().
+ */
+bool is_layer_caching_available();
+
+bool setup_graphics();
 void terminate_graphics();
 
 bool should_close();
+void request_close();
 void render();
 
+/*
+ * Sleeps until input arrives or the timeout passes, handling the input.
+ * Used instead of render() while nothing on the screen changes.
+ */
+void wait_for_events(Time timeout);
+
+/*
+ * Reads the last rendered offscreen frame as RGB rows, top row first.
+ */
+void capture_frame(std::vector<unsigned char>& rgb);
+
+/*
+ * Waits until all submitted frames have been fully rendered.
+ */
+void finish_rendering();
+
+/*
+ * Returns the wall clock time since startup. In offscreen mode time advances
+ * by a fixed step per rendered frame.
+ */
+Timestamp get_time();
+
 GLFWwindow* get_window_handle();
 
 float get_frame_length();
 
+/*
+ * Returns the moment the current frame started at.
+ */
+Timestamp get_frame_time();
+
 struct WindowDimensions {
 	int width, height;
 };
@@ -49,8 +117,47 @@ void set_color(unsigned int a, unsigned int r, unsigned int g, unsigned int b);
 void set_color(unsigned int r, unsigned int g, unsigned int b);
 void set_color(GLfloat a, unsigned int r, unsigned int g, unsigned b);
 
+void push_transform();
+void pop_transform();
+void translate(ScreenCoord x, ScreenCoord y);
+void scale(ScreenCoord x, ScreenCoord y);
+
+/*
+ * Returns how many pixels a unit of the current transformation spans at most.
+ */
+ScreenCoord get_transform_scale();
+
+/*
+ * Limits drawing to a rectangle given in the current coordinates until
+ * clear_clip(). Transformations must only translate and scale. Not batched.
+ */
+void set_clip(ScreenPoint min, ScreenPoint max);
+void clear_clip();
+
+/*
+ * Between these calls lines, rectangles and sectors are not drawn one by one
+ * but collected into groups of the same shape, each drawn with one instanced
+ * call. A shape only joins its group if it does not overlap shapes of groups
+ * started later, otherwise it starts a new one, and the groups are drawn
+ * before anything that is not batched, so the image is as if everything was
+ * drawn in order.
+ * Transformations must be balanced within the batch; overlaps are judged in
+ * the coordinates of its start, which should be pixels.
+ */
+void begin_batch();
+void end_batch();
+
 void draw_line(ScreenPoint, ScreenPoint);
 
+/*
+ * Draws line strips from vertex data that must stay unchanged until the
+ * program exits. Not batched.
+ */
+void draw_line_strips(
+		const ScreenPoint *vertices,
+		const LineStrip *strips, unsigned int count
+);
+
 void fill_triangle(ScreenPoint, ScreenPoint, ScreenPoint);
 
 void draw_rectangle(ScreenPoint min, ScreenPoint max);
@@ -75,6 +182,14 @@ void do_pseudo_sector(
 		bool fill
 );
 
+/*
+ * The number of vertices that full circles and arcs of the radius are
+ * tessellated into at the current scale, few enough for their size on
+ * screen and enough to look smooth.
+ */
+unsigned int get_circle_vertices(ScreenCoord radius);
+unsigned int get_arc_vertices(ScreenCoord radius, float start, float end);
+
 void fill_polygon(ScreenPoint center, ScreenCoord radius, unsigned int vertices);
 void draw_polygon(ScreenPoint center, ScreenCoord radius, unsigned int vertices);
 
@@ -93,4 +208,22 @@ void fill_rounded_rectangle(
 		ScreenCoord radius
 );
 
+/*
+ * Render caches keep what was drawn between begin_render_cache() and
+ * end_render_cache() in a texture of the window size, so that it can be drawn
+ * again by draw_render_cache() as a single quad. Nothing reaches the window
+ * while a cache is being drawn into. Caches cannot be nested or used in
+ * batches, and need is_layer_caching_available().
+ *
+ * A resolution below 1 makes the cache that much smaller than the window.
+ * The same coordinates still cover the whole window, and drawing the cache
+ * stretches it back with linear filtering.
+ */
+RenderCacheId create_render_cache();
+void destroy_render_cache(RenderCacheId);
+
+void begin_render_cache(RenderCacheId, float resolution = 1);
+void end_render_cache();
+void draw_render_cache(RenderCacheId);
+
 #endif /* GRAPHICS_H_ */
@@ -0,0 +1,277 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "instancing.h"
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+
+#include "gl_extensions.h"
+#include "shaders.h"
+
+
+/*
+ * Shapes
+ */
+
+struct Prototype {
+	ShapeKey shape;
+	GLenum mode;
+	std::vector<GLfloat> vertices;
+	GLuint buffer;
+};
+
+std::vector<Prototype> prototypes;
+
+void add_vertex(Prototype& prototype, GLfloat x, GLfloat y) {
+	prototype.vertices.push_back(x);
+	prototype.vertices.push_back(y);
+}
+
+/*
+ * Builds the vertices that the matching executor in commands.cpp would issue
+ * for a shape of unit size at the origin.
+ */
+void build_prototype(Prototype& prototype) {
+	const ShapeKey& shape = prototype.shape;
+
+	switch (shape.type) {
+
+	case DRAW_LINE:
+		prototype.mode = GL_LINES;
+		add_vertex(prototype, 0, 0);
+		add_vertex(prototype, 1, 1);
+		break;
+
+	case FILL_RECTANGLE:
+		prototype.mode = GL_TRIANGLES;
+		add_vertex(prototype, 0, 0);
+		add_vertex(prototype, 0, 1);
+		add_vertex(prototype, 1, 1);
+
+		add_vertex(prototype, 0, 0);
+		add_vertex(prototype, 1, 0);
+		add_vertex(prototype, 1, 1);
+		break;
+
+	case DRAW_RECTANGLE:
+		prototype.mode = GL_LINE_LOOP;
+		add_vertex(prototype, 0, 0);
+		add_vertex(prototype, 0, 1);
+		add_vertex(prototype, 1, 1);
+		add_vertex(prototype, 1, 0);
+		break;
+
+	case FILL_SECTOR:
+	case DRAW_SECTOR: {
+		bool fill = shape.type == FILL_SECTOR;
+		prototype.mode = fill ? GL_TRIANGLE_FAN : GL_LINE_STRIP;
+
+		if (fill) add_vertex(prototype, 0, 0);
+
+		for (float vertex = 0; vertex <= shape.vertices; vertex++) {
+			float angle = shape.start
+					+ vertex / shape.vertices * (shape.end - shape.start);
+			add_vertex(prototype, sin(angle), cos(angle));
+		}
+	} break;
+
+	default:
+		std::cerr << "Shape type " << static_cast<int>(shape.type)
+				<< " cannot be instanced" << std::endl;
+		prototype.mode = GL_POINTS;
+		break;
+
+	}
+}
+
+const Prototype& get_prototype(const ShapeKey& shape) {
+	for (const Prototype& prototype : prototypes) {
+		if (prototype.shape == shape) {
+			return prototype;
+		}
+	}
+
+	prototypes.push_back({shape, GL_POINTS, {}, 0});
+	Prototype& result = prototypes.back();
+
+	build_prototype(result);
+
+	if (gl.has_instancing) {
+		gl.GenBuffers(1, &result.buffer);
+		gl.BindBuffer(GL_ARRAY_BUFFER, result.buffer);
+		gl.BufferData(
+				GL_ARRAY_BUFFER,
+				result.vertices.size() * sizeof(GLfloat),
+				result.vertices.data(),
+				GL_STATIC_DRAW
+		);
+		gl.BindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	return result;
+}
+
+/*
+ * Instanced drawing
+ */
+
+// Attribute locations bound before linking
+const GLuint VERTEX_ATTRIBUTE = 0;
+const GLuint PLACEMENT_ATTRIBUTE = 1;
+const GLuint COLOR_ATTRIBUTE = 2;
+
+const char *VERTEX_SHADER =
+		"#version 120\n"
+		"attribute vec2 vertex;\n"
+		"attribute vec4 placement;\n"
+		"attribute vec4 color;\n"
+		"void main() {\n"
+		"	vec2 position = placement.xy + vertex * placement.zw;\n"
+		"	gl_Position = gl_ModelViewProjectionMatrix\n"
+		"			* vec4(position, 0.0, 1.0);\n"
+		"	gl_FrontColor = color;\n"
+		"}\n";
+
+const char *FRAGMENT_SHADER =
+		"#version 120\n"
+		"void main() {\n"
+		"	gl_FragColor = gl_Color;\n"
+		"}\n";
+
+enum ProgramState {
+	NOT_CREATED, READY, FAILED
+};
+
+ProgramState program_state = NOT_CREATED;
+GLuint program;
+GLuint instance_buffer;
+
+// In the order of the attribute locations above
+const char * const ATTRIBUTES[] = {"vertex", "placement", "color", nullptr};
+
+bool create_program() {
+	program = create_shader_program(
+			"instancing", VERTEX_SHADER, FRAGMENT_SHADER, ATTRIBUTES
+	);
+
+	if (program == 0) {
+		return false;
+	}
+
+	gl.GenBuffers(1, &instance_buffer);
+	return true;
+}
+
+bool is_program_ready() {
+	if (program_state == NOT_CREATED) {
+		program_state = gl.has_instancing && create_program() ? READY : FAILED;
+	}
+
+	return program_state == READY;
+}
+
+void instance_attribute(GLuint index, size_t offset) {
+	gl.VertexAttribPointer(
+			index, 4, GL_FLOAT, GL_FALSE,
+			sizeof(ShapeInstance),
+			reinterpret_cast<const void*>(offset)
+	);
+	gl.VertexAttribDivisor(index, 1);
+	gl.EnableVertexAttribArray(index);
+}
+
+void draw_instanced(
+		const Prototype& prototype,
+		const unsigned char *instances, unsigned int count
+) {
+	gl.UseProgram(program);
+
+	gl.BindBuffer(GL_ARRAY_BUFFER, prototype.buffer);
+	gl.VertexAttribPointer(VERTEX_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+	gl.EnableVertexAttribArray(VERTEX_ATTRIBUTE);
+
+	// Orphan the previous contents instead of waiting for them to be used
+	gl.BindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+	gl.BufferData(
+			GL_ARRAY_BUFFER,
+			count * sizeof(ShapeInstance), instances,
+			GL_STREAM_DRAW
+	);
+
+	instance_attribute(PLACEMENT_ATTRIBUTE, offsetof(ShapeInstance, offset));
+	instance_attribute(COLOR_ATTRIBUTE, offsetof(ShapeInstance, red));
+
+	gl.DrawArraysInstanced(
+			prototype.mode, 0,
+			prototype.vertices.size() / 2,
+			count
+	);
+
+	gl.DisableVertexAttribArray(VERTEX_ATTRIBUTE);
+	gl.DisableVertexAttribArray(PLACEMENT_ATTRIBUTE);
+	gl.DisableVertexAttribArray(COLOR_ATTRIBUTE);
+
+	gl.BindBuffer(GL_ARRAY_BUFFER, 0);
+	gl.UseProgram(0);
+}
+
+/*
+ * Fallback
+ */
+
+void draw_one_by_one(
+		const Prototype& prototype,
+		const unsigned char *instances, unsigned int count
+) {
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, prototype.vertices.data());
+
+	for (unsigned int i = 0; i < count; ++i) {
+		ShapeInstance instance;
+		std::memcpy(
+				&instance,
+				instances + i * sizeof(ShapeInstance),
+				sizeof(ShapeInstance)
+		);
+
+		glColor4f(instance.red, instance.green, instance.blue, instance.alpha);
+
+		glPushMatrix();
+		glTranslatef(instance.offset.x, instance.offset.y, 0);
+		glScalef(instance.scale.x, instance.scale.y, 1);
+		glDrawArrays(prototype.mode, 0, prototype.vertices.size() / 2);
+		glPopMatrix();
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void draw_instances(
+		const InstancesCommand& command,
+		const unsigned char *instances
+) {
+	const Prototype& prototype = get_prototype(command.shape);
+
+	if (is_program_ready()) {
+		draw_instanced(prototype, instances, command.count);
+	} else {
+		draw_one_by_one(prototype, instances, command.count);
+	}
+}
@@ -0,0 +1,40 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INSTANCING_H_
+#define INSTANCING_H_
+
+#include "commands.h"
+
+
+/*
+ * Draws every instance of the shape to the GL context current on this thread.
+ * instances points to command.count ShapeInstance structures, which need not
+ * be aligned.
+ *
+ * The shape is built once and kept on the GPU. With instanced drawing
+ * available all instances are drawn with a single call; otherwise each
+ * instance is drawn from a client-side vertex array.
+ */
+void draw_instances(
+		const InstancesCommand& command,
+		const unsigned char *instances
+);
+
+
+#endif /* INSTANCING_H_ */
@@ -0,0 +1,232 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "offscreen.h"
+
+#include <iostream>
+
+#include "gl_extensions.h"
+
+#ifdef WITH_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+
+int offscreen_width, offscreen_height, offscreen_samples;
+
+/*
+ * Context
+ */
+
+#ifdef WITH_EGL
+
+EGLDisplay egl_display = EGL_NO_DISPLAY;
+EGLContext egl_context = EGL_NO_CONTEXT;
+
+EGLDisplay get_egl_display() {
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+	auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+			eglGetProcAddress("eglGetPlatformDisplayEXT")
+	);
+
+	if (get_platform_display != nullptr) {
+		EGLDisplay display = get_platform_display(
+				EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr
+		);
+
+		if (display != EGL_NO_DISPLAY) {
+			return display;
+		}
+	}
+#endif
+
+	return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+bool create_offscreen_context(int width, int height, int samples) {
+	offscreen_width = width;
+	offscreen_height = height;
+	offscreen_samples = samples;
+
+	egl_display = get_egl_display();
+
+	if (
+			egl_display == EGL_NO_DISPLAY
+			|| !eglInitialize(egl_display, nullptr, nullptr)
+	) {
+		std::cerr << "Could not initialize EGL display" << std::endl;
+		return false;
+	}
+
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		std::cerr << "EGL does not support desktop OpenGL" << std::endl;
+		return false;
+	}
+
+	// Surfaceless rendering requires EGL_KHR_no_config_context and
+	// EGL_KHR_surfaceless_context
+	egl_context = eglCreateContext(
+			egl_display, static_cast<EGLConfig>(0), EGL_NO_CONTEXT, nullptr
+	);
+
+	if (egl_context == EGL_NO_CONTEXT) {
+		std::cerr << "Could not create EGL context, error 0x" << std::hex
+				<< eglGetError() << std::dec << std::endl;
+		return false;
+	}
+
+	if (!eglMakeCurrent(
+			egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, egl_context
+	)) {
+		std::cerr << "Could not make EGL context current" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void destroy_offscreen_context() {
+	if (egl_display == EGL_NO_DISPLAY) {
+		return;
+	}
+
+	eglMakeCurrent(egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+	if (egl_context != EGL_NO_CONTEXT) {
+		eglDestroyContext(egl_display, egl_context);
+		egl_context = EGL_NO_CONTEXT;
+	}
+
+	eglTerminate(egl_display);
+	egl_display = EGL_NO_DISPLAY;
+}
+
+void set_offscreen_context_current(bool current) {
+	eglMakeCurrent(
+			egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+			current ? egl_context : EGL_NO_CONTEXT
+	);
+}
+
+void* get_offscreen_proc_address(const char *name) {
+	return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+#else
+
+bool create_offscreen_context(int, int, int) {
+	std::cerr << "Offscreen rendering is not available in this build, "
+			"rebuild with WITH_EGL" << std::endl;
+	return false;
+}
+
+void destroy_offscreen_context() {}
+
+void set_offscreen_context_current(bool) {}
+
+void* get_offscreen_proc_address(const char*) {
+	return nullptr;
+}
+
+#endif
+
+/*
+ * Framebuffer
+ */
+
+// Multisampled buffer rendered into
+GLuint render_framebuffer = 0, render_renderbuffer = 0;
+
+// Single-sampled buffer frames are resolved into for reading
+GLuint resolve_framebuffer = 0, resolve_renderbuffer = 0;
+
+bool create_framebuffer(GLuint& framebuffer, GLuint& renderbuffer, int samples) {
+	gl.GenRenderbuffers(1, &renderbuffer);
+	gl.BindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+	gl.RenderbufferStorageMultisample(
+			GL_RENDERBUFFER, samples, GL_RGBA8,
+			offscreen_width, offscreen_height
+	);
+
+	gl.GenFramebuffers(1, &framebuffer);
+	gl.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	gl.FramebufferRenderbuffer(
+			GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+			GL_RENDERBUFFER, renderbuffer
+	);
+
+	if (gl.CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+		std::cerr << "Offscreen framebuffer is incomplete" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool create_offscreen_framebuffer() {
+	if (!create_framebuffer(resolve_framebuffer, resolve_renderbuffer, 0)) {
+		return false;
+	}
+
+	if (offscreen_samples > 0) {
+		if (!create_framebuffer(
+				render_framebuffer, render_renderbuffer, offscreen_samples
+		)) {
+			return false;
+		}
+	} else {
+		render_framebuffer = resolve_framebuffer;
+	}
+
+	gl.BindFramebuffer(GL_FRAMEBUFFER, render_framebuffer);
+	return true;
+}
+
+void present_offscreen_frame() {
+	if (render_framebuffer != resolve_framebuffer) {
+		gl.BindFramebuffer(GL_READ_FRAMEBUFFER, render_framebuffer);
+		gl.BindFramebuffer(GL_DRAW_FRAMEBUFFER, resolve_framebuffer);
+		gl.BlitFramebuffer(
+				0, 0, offscreen_width, offscreen_height,
+				0, 0, offscreen_width, offscreen_height,
+				GL_COLOR_BUFFER_BIT, GL_NEAREST
+		);
+		gl.BindFramebuffer(GL_FRAMEBUFFER, render_framebuffer);
+	}
+
+	glFlush();
+}
+
+void read_offscreen_frame(std::vector<unsigned char>& rgb) {
+	const size_t row = static_cast<size_t>(offscreen_width) * 3;
+	rgb.resize(row * offscreen_height);
+
+	gl.BindFramebuffer(GL_READ_FRAMEBUFFER, resolve_framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+	// GL rows go bottom to top
+	for (int y = 0; y < offscreen_height; ++y) {
+		glReadPixels(
+				0, offscreen_height - 1 - y, offscreen_width, 1,
+				GL_RGB, GL_UNSIGNED_BYTE, &rgb[y * row]
+		);
+	}
+
+	gl.BindFramebuffer(GL_READ_FRAMEBUFFER, render_framebuffer);
+}
@@ -0,0 +1,60 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef OFFSCREEN_H_
+#define OFFSCREEN_H_
+
+#include <vector>
+
+
+/*
+ * Creates a window-less GL context rendering into a framebuffer of the given
+ * size. Only available when built with WITH_EGL (EGL surfaceless platform,
+ * e.g. Mesa llvmpipe); returns false otherwise.
+ */
+bool create_offscreen_context(int width, int height, int samples);
+void destroy_offscreen_context();
+
+/*
+ * Binds or unbinds the offscreen context to the calling thread.
+ */
+void set_offscreen_context_current(bool current);
+
+/*
+ * Looks up a GL entry point in the offscreen context.
+ */
+void* get_offscreen_proc_address(const char *name);
+
+/*
+ * Creates the framebuffer the frames are rendered into and binds it. Must be
+ * called after GL extensions have been loaded.
+ */
+bool create_offscreen_framebuffer();
+
+/*
+ * Finishes the current frame making it available for read_offscreen_frame().
+ */
+void present_offscreen_frame();
+
+/*
+ * Reads the last presented frame as tightly packed RGB rows, top row first.
+ */
+void read_offscreen_frame(std::vector<unsigned char>& rgb);
+
+
+#endif /* OFFSCREEN_H_ */
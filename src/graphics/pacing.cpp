@@ -0,0 +1,200 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "pacing.h"
+
+#include <chrono>
+#include <thread>
+
+#include "graphics.h"
+#include "quality.h"
+
+
+PacingSettings pacing;
+
+void set_pacing(PacingSettings settings) {
+	pacing = settings;
+}
+
+const PacingSettings& get_pacing() {
+	return pacing;
+}
+
+void apply_swap_interval() {
+	glfwSwapInterval(pacing.mode == VSYNC ? 1 : 0);
+}
+
+// Assumed when the display does not report its refresh rate
+const double DEFAULT_REFRESH_RATE = 60;
+
+Time get_frame_budget() {
+	if (pacing.mode == LIMITED) {
+		return 1 / pacing.target_fps;
+	}
+
+	double refresh_rate = get_refresh_rate();
+	return 1 / (refresh_rate > 0 ? refresh_rate : DEFAULT_REFRESH_RATE);
+}
+
+/*
+ * Limiter
+ */
+
+// OS sleep is only trusted up to this much before the deadline
+const Timestamp SPIN_MARGIN = NANOSECONDS_PER_SECOND / 500;
+
+Timestamp next_frame_deadline = -1;
+
+void wait_for_next_frame() {
+	if (pacing.mode != LIMITED || pacing.target_fps <= 0) {
+		return;
+	}
+
+	const Timestamp period = to_timestamp(1 / pacing.target_fps);
+	Timestamp now = get_time();
+
+	if (next_frame_deadline < 0 || now - next_frame_deadline > period) {
+		// First frame or too far behind to catch up
+		next_frame_deadline = now;
+	}
+
+	Timestamp sleep_time = next_frame_deadline - now - SPIN_MARGIN;
+	if (sleep_time > 0) {
+		std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_time));
+	}
+
+	while (get_time() < next_frame_deadline) {
+		// Spin
+	}
+
+	next_frame_deadline += period;
+}
+
+/*
+ * Latency measurement
+ */
+
+const Time LATENCY_REPORT_PERIOD = 1.0f;
+
+Timestamp pending_input_time = -1;
+Time last_input_latency = 0;
+
+struct LatencyReport {
+	Timestamp start = -1;
+	Timestamp last_frame = -1;
+
+	unsigned int frames = 0;
+	Time max_frame_length = 0;
+
+	unsigned int samples = 0;
+	Time latency_sum = 0;
+	Time min_latency = 0;
+	Time max_latency = 0;
+};
+
+LatencyReport latency_report;
+
+void reset_latency_report(Timestamp now) {
+	latency_report = LatencyReport();
+	latency_report.start = latency_report.last_frame = now;
+}
+
+void on_input_received(Timestamp event_time) {
+	if (pending_input_time < 0) {
+		pending_input_time = event_time;
+	}
+}
+
+void print_latency_report(Timestamp now) {
+	auto& r = latency_report;
+
+	// Other output on the console keeps its own format
+	std::ios_base::fmtflags flags = std::cout.flags();
+	std::streamsize precision = std::cout.precision();
+
+	std::cout << std::fixed << std::setprecision(2)
+			<< "Frames: " << r.frames
+			<< ", frame avg " << to_seconds(now - r.start) / r.frames * 1000
+			<< " ms, max " << r.max_frame_length * 1000 << " ms"
+			<< ", quality level " << get_quality_level();
+
+	if (r.samples != 0) {
+		std::cout
+				<< "; input-to-swap avg " << r.latency_sum / r.samples * 1000
+				<< " ms, min " << r.min_latency * 1000
+				<< " ms, max " << r.max_latency * 1000
+				<< " ms (" << r.samples << " samples)";
+	}
+
+	std::cout << std::endl;
+	std::cout.flags(flags);
+	std::cout.precision(precision);
+}
+
+Timestamp take_pending_input() {
+	Timestamp result = pending_input_time;
+	pending_input_time = -1;
+	return result;
+}
+
+void on_frame_presented(Timestamp now, Timestamp input_time) {
+	bool has_sample = input_time >= 0;
+
+	if (has_sample) {
+		last_input_latency = to_seconds(now - input_time);
+	}
+
+	if (!pacing.report_latency) {
+		return;
+	}
+
+	auto& r = latency_report;
+
+	if (r.start < 0) {
+		reset_latency_report(now);
+		return;
+	}
+
+	r.frames++;
+	r.max_frame_length = std::max(
+			r.max_frame_length,
+			to_seconds(now - r.last_frame)
+	);
+	r.last_frame = now;
+
+	if (has_sample) {
+		if (r.samples == 0 || last_input_latency < r.min_latency) {
+			r.min_latency = last_input_latency;
+		}
+		if (r.samples == 0 || last_input_latency > r.max_latency) {
+			r.max_latency = last_input_latency;
+		}
+
+		r.samples++;
+		r.latency_sum += last_input_latency;
+	}
+
+	if (to_seconds(now - r.start) >= LATENCY_REPORT_PERIOD) {
+		print_latency_report(now);
+		reset_latency_report(now);
+	}
+}
+
+Time get_last_input_latency() {
+	return last_input_latency;
+}
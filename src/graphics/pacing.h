@@ -0,0 +1,103 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACING_H_
+#define PACING_H_
+
+#include "../common.h"
+
+
+enum PacingMode {
+	/*
+	 * Swaps are synchronized with the display refresh.
+	 */
+	VSYNC,
+
+	/*
+	 * Frames are rendered as fast as possible.
+	 */
+	UNCAPPED,
+
+	/*
+	 * Frames are spaced to target_fps by sleeping and then spinning until the
+	 * deadline. Swaps are not synchronized with the display.
+	 */
+	LIMITED
+};
+
+struct PacingSettings {
+	PacingMode mode = VSYNC;
+	double target_fps = 60;
+
+	/*
+	 * Poll input right before the simulation instead of after the swap.
+	 */
+	bool late_input = false;
+
+	/*
+	 * Periodically print input-to-display latency statistics.
+	 */
+	bool report_latency = false;
+};
+
+void set_pacing(PacingSettings);
+const PacingSettings& get_pacing();
+
+/*
+ * Applies the swap interval required by the current pacing mode. Must be
+ * called with a current GL context.
+ */
+void apply_swap_interval();
+
+/*
+ * Returns the time a frame may take under the current pacing mode: the
+ * period of target_fps when limited, the display refresh period otherwise.
+ */
+Time get_frame_budget();
+
+/*
+ * Blocks until the next frame should be started.
+ */
+void wait_for_next_frame();
+
+/*
+ * Records that an input event issued at the given moment is waiting to reach
+ * the screen.
+ */
+void on_input_received(Timestamp event_time);
+
+/*
+ * Returns the moment of the earliest input received since the last call, or
+ * a negative value if there was none. The frame being recorded presents it.
+ */
+Timestamp take_pending_input();
+
+/*
+ * Records that a frame presenting input received at input_time (negative if
+ * none) has been swapped at the given moment.
+ */
+void on_frame_presented(Timestamp now, Timestamp input_time);
+
+/*
+ * Returns the event-to-swap latency of the last frame that presented input,
+ * in seconds.
+ */
+Time get_last_input_latency();
+
+
+#endif /* PACING_H_ */
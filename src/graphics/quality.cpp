@@ -0,0 +1,246 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "quality.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "pacing.h"
+
+
+const QualitySettings QUALITY_SETTINGS[] = {
+		{0.25f, 1.00f, std::numeric_limits<size_t>::max(), true, 1.00f, true},
+		{0.50f, 1.00f, 256, true,  1.00f, true},
+		{1.00f, 0.50f, 128, true,  1.00f, true},
+		{1.00f, 0.50f,  64, false, 1.00f, false},
+		{2.00f, 0.25f,  32, false, 1.00f, false},
+		{2.00f, 0.25f,  16, false, 0.50f, false}
+};
+
+const unsigned int QUALITY_LEVELS =
+		sizeof(QUALITY_SETTINGS) / sizeof(QUALITY_SETTINGS[0]);
+
+unsigned int quality_level = 0;
+
+unsigned int get_quality_level() {
+	return quality_level;
+}
+
+const QualitySettings& get_quality() {
+	return QUALITY_SETTINGS[quality_level];
+}
+
+void set_quality_level(unsigned int level) {
+	quality_level = std::min(level, QUALITY_LEVELS - 1);
+}
+
+/*
+ * Governor
+ */
+
+// Frame costs are averaged over windows of this length
+const Time QUALITY_WINDOW = 0.5f;
+
+// Shares of the frame budget that lower and allow to raise the quality
+const float LOWER_QUALITY_LOAD = 0.9f;
+const float RAISE_QUALITY_LOAD = 0.5f;
+
+// Calm windows needed before raising the quality, doubled on each relapse
+const unsigned int MIN_CALM_WINDOWS = 4;
+const unsigned int MAX_CALM_WINDOWS = 64;
+
+// Lowering must bring the load below this share of the load before it
+const float MIN_LOWERING_GAIN = 0.95f;
+
+// Levels found not to help are tried again after this many windows
+const unsigned int USEFUL_LEVEL_EXPIRY_WINDOWS = 120;
+
+// Frames this many budgets long missed their deadline or refresh
+const float MISSED_FRAME_LENGTH = 1.5f;
+
+// Costs miss work done by drivers at the swap; misses reveal it
+const float MAX_MISSED_SHARE = 0.1f;
+
+bool is_governor_enabled = false;
+
+Time window_length = 0;
+Time window_cost = 0;
+unsigned int window_frames = 0;
+unsigned int window_missed_frames = 0;
+
+// Whether the next frame started after an idle wait
+bool was_idle = false;
+
+unsigned int calm_windows = 0;
+unsigned int needed_calm_windows = MIN_CALM_WINDOWS;
+
+// Whether the quality was changed at the end of the last window
+bool was_raised = false;
+bool was_lowered = false;
+
+// Where the current run of lowerings started
+unsigned int level_before_lowering = 0;
+float load_before_lowering = 0;
+
+// Levels beyond it turned out not to be cheaper on this machine
+unsigned int lowest_useful_level = QUALITY_LEVELS - 1;
+unsigned int windows_since_limited = 0;
+
+void set_quality_governor(bool enabled) {
+	is_governor_enabled = enabled;
+}
+
+bool is_quality_governor_enabled() {
+	return is_governor_enabled;
+}
+
+void judge_window(float load) {
+	// A single noisy window must not rule levels out for good
+	if (lowest_useful_level < QUALITY_LEVELS - 1
+			&& ++windows_since_limited >= USEFUL_LEVEL_EXPIRY_WINDOWS) {
+		lowest_useful_level = QUALITY_LEVELS - 1;
+	}
+
+	if (was_lowered) {
+		was_lowered = false;
+
+		if (load > load_before_lowering * MIN_LOWERING_GAIN) {
+			calm_windows = 0;
+
+			// Levels turn independent knobs, so one that does not help here
+			// says nothing about the next ones
+			if (load > LOWER_QUALITY_LOAD
+					&& quality_level < lowest_useful_level) {
+				was_lowered = true;
+				set_quality_level(quality_level + 1);
+				return;
+			}
+
+			// Some knobs only move work around, such as scaling on a CPU
+			// renderer; none of the levels tried were worth their cost
+			if (load > LOWER_QUALITY_LOAD) {
+				lowest_useful_level = level_before_lowering;
+				windows_since_limited = 0;
+				set_quality_level(level_before_lowering);
+			}
+			return;
+		}
+	}
+
+	if (load > LOWER_QUALITY_LOAD) {
+		calm_windows = 0;
+
+		if (was_raised) {
+			// The higher quality did not fit after all, try again later
+			needed_calm_windows = std::min(
+					needed_calm_windows * 2, MAX_CALM_WINDOWS
+			);
+		}
+		was_raised = false;
+
+		if (quality_level < lowest_useful_level) {
+			was_lowered = true;
+			level_before_lowering = quality_level;
+			load_before_lowering = load;
+			set_quality_level(quality_level + 1);
+		}
+		return;
+	}
+
+	if (was_raised) {
+		needed_calm_windows = MIN_CALM_WINDOWS;
+		was_raised = false;
+	}
+
+	if (load > RAISE_QUALITY_LOAD || quality_level == 0) {
+		calm_windows = 0;
+		return;
+	}
+
+	if (++calm_windows >= needed_calm_windows) {
+		calm_windows = 0;
+		was_raised = true;
+		set_quality_level(quality_level - 1);
+	}
+}
+
+void on_frame_timing(Time frame_length, Time cost) {
+	if (!is_governor_enabled) {
+		return;
+	}
+
+	if (was_idle) {
+		was_idle = false;
+		return;
+	}
+
+	Time budget = get_frame_budget();
+
+	window_length += frame_length;
+	window_cost += cost;
+	window_frames++;
+
+	if (frame_length > budget * MISSED_FRAME_LENGTH) {
+		window_missed_frames++;
+	}
+
+	if (window_length < QUALITY_WINDOW) {
+		return;
+	}
+
+	float load = window_cost / window_frames / budget;
+	if (window_missed_frames > window_frames * MAX_MISSED_SHARE) {
+		load = std::max(load, window_length / window_frames / budget);
+	}
+
+	judge_window(load);
+
+	window_length = window_cost = 0;
+	window_frames = window_missed_frames = 0;
+}
+
+void on_rendering_idle() {
+	// Frames before the wait do not tell how busy rendering is
+	window_length = window_cost = 0;
+	window_frames = window_missed_frames = 0;
+	was_idle = true;
+}
+
+/*
+ * Sprites
+ */
+
+// Share of a sprite owed, sprites are created whenever it reaches one
+float sprite_credit = 0;
+
+bool should_create_sprite(size_t existing) {
+	const QualitySettings& quality = get_quality();
+
+	if (existing >= quality.max_sprites) {
+		return false;
+	}
+
+	sprite_credit += quality.sprite_rate;
+	if (sprite_credit < 1) {
+		return false;
+	}
+
+	sprite_credit -= 1;
+	return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUALITY_H_
+#define QUALITY_H_
+
+#include "../common.h"
+
+
+/*
+ * Rendering quality that can be lowered to keep frames within their budget.
+ * Level 0 is the full quality; each next level is cheaper than the previous.
+ */
+struct QualitySettings {
+	// Largest distance in pixels between a curve and the chords drawn for it
+	ScreenCoord tessellation_error;
+
+	// Fraction of effect sprites that are created
+	float sprite_rate;
+
+	// Effect sprites are not created while a game has this many
+	size_t max_sprites;
+
+	bool multisampling;
+
+	// Size of the framebuffer the game is drawn into relative to the window
+	float resolution_scale;
+
+	// Whether the remains of destroyed bricks are drawn
+	bool corpses;
+};
+
+extern const unsigned int QUALITY_LEVELS;
+
+unsigned int get_quality_level();
+const QualitySettings& get_quality();
+
+/*
+ * Fixes the quality level, clamped to the lowest quality.
+ */
+void set_quality_level(unsigned int level);
+
+/*
+ * While enabled the level follows the cost of frames, see on_frame_timing().
+ * Disabled by default.
+ */
+void set_quality_governor(bool enabled);
+bool is_quality_governor_enabled();
+
+/*
+ * Reports how long the last frame took from start to start and how long it
+ * kept the CPU or GPU busy recording or executing it. The governor lowers the
+ * quality when costs exceed the frame budget of the pacing mode or frames
+ * are missed, and raises it again once they fit with headroom. A level that
+ * does not lower the load is stepped past; when none of the deeper ones do
+ * either, they are left unused for a while.
+ */
+void on_frame_timing(Time frame_length, Time cost);
+
+/*
+ * Reports that rendering paused while waiting for events. The frame after
+ * the pause is not timed, so idle time never counts as a missed frame.
+ */
+void on_rendering_idle();
+
+/*
+ * Returns whether an effect sprite should be created into a game that has
+ * the given number of sprites. Thins sprites out evenly, never randomly, so
+ * that the random sequence of the game is not disturbed.
+ */
+bool should_create_sprite(size_t existing);
+
+
+#endif /* QUALITY_H_ */
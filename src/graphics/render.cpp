@@ -43,8 +43,8 @@ void Platform::render() {
 	const ScreenCoord radius = 0.3,
 			inner_radius = radius * 0.8;
 
-	glPushMatrix();
-	glTranslatef(0, visual.height, 0);
+	push_transform();
+	translate(0, visual.height);
 
 	set_color(Design::FILL);
 	fill_rounded_rectangle(
@@ -92,10 +92,10 @@ void Platform::render() {
 			}
 	);
 
-	glPopMatrix();
+	pop_transform();
 }
 
-void Ball::render() {
+void Ball::render(Timestamp) {
 	set_color(Design::FILL);
 	fill_circle(position, radius);
 
@@ -247,10 +247,7 @@ void FloorCollisionSprite::do_render(Game&, Time time) {
 		return;
 	}
 
-	Time frame_length = get_frame_length();
-
-	position.x += velocity.x * frame_length;
-	position.y += velocity.y * frame_length;
+	position = start_pos + velocity * static_cast<Velocity>(time);
 
 	float fraction = time / lifetime;
 
@@ -319,7 +316,7 @@ void BonusFloorCollisionSprite::do_render(Game&, Time time) {
 	const Time lifetime = 0.1f;
 	unsigned int vertices = good ? 4 : 5;
 
-	position += velocity * get_frame_length();
+	position = start_pos + velocity * static_cast<Velocity>(time);
 
 	if (time >= lifetime) {
 		die();
@@ -334,11 +331,12 @@ void BonusFloorCollisionSprite::do_render(Game&, Time time) {
 
 
 
-void Bonus::render() {
+void Bonus::render(Timestamp now) {
 	unsigned int vertices = good ? 4 : 5;
 
 	const float RADIANS_PER_SECOND = 5;
-	float angle = glfwGetTime() * RADIANS_PER_SECOND;
+	const Timestamp TURN_PERIOD = to_timestamp(2*PI / RADIANS_PER_SECOND);
+	float angle = to_seconds(now % TURN_PERIOD) * RADIANS_PER_SECOND;
 
 	set_color(0.2f, 0x00, 0x00, 0x00);
 	do_pseudo_sector(
@@ -0,0 +1,231 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "render_cache.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "gl_extensions.h"
+
+
+struct RenderCache {
+	int width = 0, height = 0, samples = 0;
+
+	// Multisampled buffer drawn into, same as target without multisampling
+	GLuint render_framebuffer = 0, render_renderbuffer = 0;
+
+	GLuint target_framebuffer = 0, texture = 0;
+};
+
+// Indexed by RenderCacheId
+std::vector<RenderCache> render_caches;
+
+// Framebuffer bound when the cache that is being drawn into was begun
+GLint cache_previous_framebuffer = 0;
+RenderCache *current_cache = nullptr;
+
+void release_render_cache(RenderCache& cache) {
+	if (cache.render_framebuffer != cache.target_framebuffer) {
+		gl.DeleteFramebuffers(1, &cache.render_framebuffer);
+		gl.DeleteRenderbuffers(1, &cache.render_renderbuffer);
+	}
+
+	gl.DeleteFramebuffers(1, &cache.target_framebuffer);
+	glDeleteTextures(1, &cache.texture);
+
+	cache = RenderCache();
+}
+
+bool create_render_cache(RenderCache& cache) {
+	glGenTextures(1, &cache.texture);
+	glBindTexture(GL_TEXTURE_2D, cache.texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(
+			GL_TEXTURE_2D, 0, GL_RGBA8, cache.width, cache.height, 0,
+			GL_RGBA, GL_UNSIGNED_BYTE, nullptr
+	);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	gl.GenFramebuffers(1, &cache.target_framebuffer);
+	gl.BindFramebuffer(GL_FRAMEBUFFER, cache.target_framebuffer);
+	gl.FramebufferTexture2D(
+			GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+			GL_TEXTURE_2D, cache.texture, 0
+	);
+	bool complete =
+			gl.CheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+
+	if (cache.samples > 0) {
+		gl.GenRenderbuffers(1, &cache.render_renderbuffer);
+		gl.BindRenderbuffer(GL_RENDERBUFFER, cache.render_renderbuffer);
+		gl.RenderbufferStorageMultisample(
+				GL_RENDERBUFFER, cache.samples, GL_RGBA8,
+				cache.width, cache.height
+		);
+
+		gl.GenFramebuffers(1, &cache.render_framebuffer);
+		gl.BindFramebuffer(GL_FRAMEBUFFER, cache.render_framebuffer);
+		gl.FramebufferRenderbuffer(
+				GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+				GL_RENDERBUFFER, cache.render_renderbuffer
+		);
+		complete &= gl.CheckFramebufferStatus(GL_FRAMEBUFFER)
+				== GL_FRAMEBUFFER_COMPLETE;
+	} else {
+		cache.render_framebuffer = cache.target_framebuffer;
+	}
+
+	if (!complete) {
+		std::cerr << "Render cache framebuffer is incomplete" << std::endl;
+	}
+
+	return complete;
+}
+
+void begin_render_cache_execution(RenderCacheId id, float resolution) {
+	if (id >= render_caches.size()) {
+		render_caches.resize(id + 1);
+	}
+
+	RenderCache& cache = render_caches[id];
+
+	GLint viewport[4], samples;
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glGetIntegerv(GL_SAMPLES, &samples);
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &cache_previous_framebuffer);
+
+	// Samples would be stored but not used
+	if (!glIsEnabled(GL_MULTISAMPLE)) {
+		samples = 0;
+	}
+
+	int width = std::max(1, static_cast<int>(viewport[2] * resolution));
+	int height = std::max(1, static_cast<int>(viewport[3] * resolution));
+
+	if (
+			cache.texture == 0
+			|| cache.width != width || cache.height != height
+			|| cache.samples != samples
+	) {
+		release_render_cache(cache);
+
+		cache.width = width;
+		cache.height = height;
+		cache.samples = samples;
+
+		if (!create_render_cache(cache)) {
+			release_render_cache(cache);
+			gl.BindFramebuffer(GL_FRAMEBUFFER, cache_previous_framebuffer);
+			return;
+		}
+	}
+
+	current_cache = &cache;
+	gl.BindFramebuffer(GL_FRAMEBUFFER, cache.render_framebuffer);
+
+	// Saves the clear color, the blend function and the viewport
+	glPushAttrib(GL_COLOR_BUFFER_BIT | GL_VIEWPORT_BIT);
+	glViewport(0, 0, cache.width, cache.height);
+
+	glClearColor(0, 0, 0, 0);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	gl.BlendFuncSeparate(
+			GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+			GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+	);
+}
+
+void end_render_cache_execution() {
+	if (current_cache == nullptr) {
+		return;
+	}
+
+	RenderCache& cache = *current_cache;
+	current_cache = nullptr;
+
+	glPopAttrib();
+
+	if (cache.render_framebuffer != cache.target_framebuffer) {
+		gl.BindFramebuffer(GL_READ_FRAMEBUFFER, cache.render_framebuffer);
+		gl.BindFramebuffer(GL_DRAW_FRAMEBUFFER, cache.target_framebuffer);
+		gl.BlitFramebuffer(
+				0, 0, cache.width, cache.height,
+				0, 0, cache.width, cache.height,
+				GL_COLOR_BUFFER_BIT, GL_NEAREST
+		);
+	}
+
+	gl.BindFramebuffer(GL_FRAMEBUFFER, cache_previous_framebuffer);
+}
+
+void execute_draw_render_cache(RenderCacheId id) {
+	if (id >= render_caches.size() || render_caches[id].texture == 0) {
+		return;
+	}
+
+	const RenderCache& cache = render_caches[id];
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	// Pixels only need blending when the cache is stretched
+	GLint filter = (cache.width == viewport[2] && cache.height == viewport[3])
+			? GL_NEAREST
+			: GL_LINEAR;
+
+	glPushAttrib(GL_COLOR_BUFFER_BIT | GL_ENABLE_BIT | GL_TEXTURE_BIT);
+
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, cache.texture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+	glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+	// The quad covers the viewport regardless of the transformation
+	glMatrixMode(GL_PROJECTION);
+	glPushMatrix();
+	glLoadIdentity();
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+	glLoadIdentity();
+
+	glBegin(GL_TRIANGLE_STRIP);
+		glTexCoord2f(0, 0); glVertex2f(-1, -1);
+		glTexCoord2f(1, 0); glVertex2f(+1, -1);
+		glTexCoord2f(0, 1); glVertex2f(-1, +1);
+		glTexCoord2f(1, 1); glVertex2f(+1, +1);
+	glEnd();
+
+	glPopMatrix();
+	glMatrixMode(GL_PROJECTION);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+
+	glPopAttrib();
+}
+
+void execute_destroy_render_cache(RenderCacheId id) {
+	if (id < render_caches.size()) {
+		release_render_cache(render_caches[id]);
+	}
+}
@@ -0,0 +1,41 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_CACHE_H_
+#define RENDER_CACHE_H_
+
+#include "commands.h"
+
+
+/*
+ * Executors of the render cache commands. A cache is a texture of the
+ * viewport size times the resolution it was begun with. Commands executed
+ * between begin and end are drawn into it instead of the current framebuffer,
+ * with the same multisampling and a viewport of the cache size. Colors are
+ * stored premultiplied so that drawing the cache blends the same way drawing
+ * its contents directly would.
+ *
+ * Caches are created on first use and resized when the viewport changes.
+ */
+void begin_render_cache_execution(RenderCacheId, float resolution);
+void end_render_cache_execution();
+void execute_draw_render_cache(RenderCacheId);
+void execute_destroy_render_cache(RenderCacheId);
+
+
+#endif /* RENDER_CACHE_H_ */
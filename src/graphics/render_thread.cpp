@@ -0,0 +1,251 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "render_thread.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "gl_extensions.h"
+#include "graphics.h"
+
+
+struct Frame {
+	CommandBuffer commands;
+
+	// Moment of the earliest input this frame presents, negative if none
+	Timestamp input_time = -1;
+
+	// Moment the frame was swapped, negative while it has not been
+	Timestamp present_time = -1;
+
+	// Time the commands took to execute, without waiting for the swap
+	Time execution_length = 0;
+};
+
+/*
+ * GPU timing
+ */
+
+// Results are read this many frames late so that reading does not stall
+const size_t FRAME_QUERIES = 3;
+
+GLuint frame_queries[FRAME_QUERIES];
+bool is_query_issued[FRAME_QUERIES] = {};
+bool are_queries_created = false;
+size_t next_query = 0;
+
+Time last_gpu_length = 0;
+
+void begin_frame_query() {
+	if (!gl.has_timer_queries) {
+		return;
+	}
+
+	if (!are_queries_created) {
+		gl.GenQueries(FRAME_QUERIES, frame_queries);
+		are_queries_created = true;
+	}
+
+	GLuint query = frame_queries[next_query];
+
+	if (is_query_issued[next_query]) {
+		GLuint64 nanoseconds;
+		gl.GetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+		last_gpu_length = to_seconds(static_cast<Timestamp>(nanoseconds));
+	}
+
+	gl.BeginQuery(GL_TIME_ELAPSED, query);
+}
+
+void end_frame_query() {
+	if (!gl.has_timer_queries) {
+		return;
+	}
+
+	gl.EndQuery(GL_TIME_ELAPSED);
+	is_query_issued[next_query] = true;
+	next_query = (next_query + 1) % FRAME_QUERIES;
+}
+
+/*
+ * Frames
+ */
+
+Frame frames[2];
+Frame *recording_frame = &frames[0];
+
+std::thread render_thread;
+std::mutex render_mutex;
+std::condition_variable render_condition;
+
+bool is_thread_running = false;
+bool should_stop = false;
+
+// Frame waiting to be picked up by the render thread
+Frame *pending_frame = nullptr;
+
+// Whether the render thread is executing a frame or a task
+bool is_busy = false;
+
+Action pending_task = nullptr;
+
+Time last_execution_length = 0;
+
+void execute_frame(Frame& frame, RenderBackend& backend) {
+	Timestamp start = get_monotonic_time();
+	begin_frame_query();
+	frame.commands.execute();
+	end_frame_query();
+	frame.execution_length = std::max(
+			to_seconds(get_monotonic_time() - start),
+			last_gpu_length
+	);
+
+	backend.present();
+	frame.present_time = get_time();
+}
+
+void report_presented(Frame& frame) {
+	if (frame.present_time >= 0) {
+		on_frame_presented(frame.present_time, frame.input_time);
+	}
+
+	last_execution_length = frame.execution_length;
+
+	frame.commands.clear();
+	frame.input_time = frame.present_time = -1;
+	frame.execution_length = 0;
+}
+
+void render_thread_main(RenderBackend backend) {
+	backend.acquire_context();
+
+	std::unique_lock<std::mutex> lock(render_mutex);
+
+	while (true) {
+		render_condition.wait(lock, [](void) {
+			return pending_frame != nullptr
+					|| pending_task != nullptr
+					|| should_stop;
+		});
+
+		if (pending_frame != nullptr) {
+			Frame *frame = pending_frame;
+			pending_frame = nullptr;
+
+			lock.unlock();
+			execute_frame(*frame, backend);
+			lock.lock();
+		} else if (pending_task != nullptr) {
+			lock.unlock();
+			pending_task();
+			lock.lock();
+
+			pending_task = nullptr;
+		} else {
+			break;
+		}
+
+		is_busy = false;
+		render_condition.notify_all();
+	}
+
+	lock.unlock();
+	backend.release_context();
+}
+
+void start_render_thread(RenderBackend backend) {
+	if (is_thread_running) {
+		return;
+	}
+
+	backend.release_context();
+
+	should_stop = false;
+	is_thread_running = true;
+	render_thread = std::thread(render_thread_main, backend);
+}
+
+void stop_render_thread() {
+	if (!is_thread_running) {
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(render_mutex);
+		render_condition.wait(lock, [](void) { return !is_busy; });
+
+		should_stop = true;
+		render_condition.notify_all();
+	}
+
+	render_thread.join();
+	is_thread_running = false;
+}
+
+CommandBuffer& get_command_buffer() {
+	return recording_frame->commands;
+}
+
+void submit_frame(RenderBackend& backend) {
+	Frame& frame = *recording_frame;
+	frame.input_time = take_pending_input();
+
+	if (!is_thread_running) {
+		execute_frame(frame, backend);
+		report_presented(frame);
+		return;
+	}
+
+	Frame *next = (recording_frame == &frames[0]) ? &frames[1] : &frames[0];
+
+	{
+		std::unique_lock<std::mutex> lock(render_mutex);
+		render_condition.wait(lock, [](void) { return !is_busy; });
+
+		pending_frame = &frame;
+		is_busy = true;
+		render_condition.notify_all();
+	}
+
+	// The render thread is done with the other frame
+	report_presented(*next);
+	recording_frame = next;
+}
+
+Time get_last_execution_length() {
+	return last_execution_length;
+}
+
+void run_on_render_thread(Action task) {
+	if (!is_thread_running) {
+		task();
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(render_mutex);
+	render_condition.wait(lock, [](void) { return !is_busy; });
+
+	pending_task = task;
+	is_busy = true;
+	render_condition.notify_all();
+
+	render_condition.wait(lock, [](void) { return !is_busy; });
+}
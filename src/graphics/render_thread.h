@@ -0,0 +1,68 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_THREAD_H_
+#define RENDER_THREAD_H_
+
+#include "../common.h"
+
+#include "commands.h"
+
+
+/*
+ * Context operations of the active graphics backend.
+ */
+struct RenderBackend {
+	Action acquire_context;
+	Action release_context;
+	Action present;
+};
+
+/*
+ * Moves the GL context to a dedicated thread which executes submitted frames
+ * while the next frame is being recorded. Without it frames are executed on
+ * the calling thread when submitted.
+ */
+void start_render_thread(RenderBackend);
+void stop_render_thread();
+
+/*
+ * Returns the buffer that drawing commands are currently recorded into.
+ */
+CommandBuffer& get_command_buffer();
+
+/*
+ * Finishes recording of the current frame and queues it for execution.
+ * Blocks while the previous frame is still being executed.
+ */
+void submit_frame(RenderBackend&);
+
+/*
+ * Returns how long executing the commands of the last presented frame took
+ * on the CPU or, as far as timer queries tell, on the GPU.
+ */
+Time get_last_execution_length();
+
+/*
+ * Runs the task on the thread that owns the GL context after all submitted
+ * frames have been executed, and waits for it to complete.
+ */
+void run_on_render_thread(Action task);
+
+
+#endif /* RENDER_THREAD_H_ */
@@ -0,0 +1,145 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sdf.h"
+
+#include <algorithm>
+
+#include "shaders.h"
+
+
+// Attribute locations bound before linking; the corner is gl_Vertex
+const GLuint BOX_ATTRIBUTE = 1;
+const GLuint SHAPE_ATTRIBUTE = 2;
+
+const char * const SDF_ATTRIBUTES[] = {"unused", "box", "shape", nullptr};
+
+/*
+ * The quad is grown by a pixel plus the outline width so that the smoothed
+ * edge is not cut off. Transformations are only ever translations and
+ * scales, so the pixels per unit can be read off the matrix diagonal.
+ */
+const char *SDF_VERTEX_SHADER =
+		"#version 120\n"
+		"attribute vec4 box;\n"
+		"attribute vec2 shape;\n"
+		"uniform vec2 viewport;\n"
+		"varying vec2 local;\n"
+		"varying vec2 half_size;\n"
+		"varying float radius;\n"
+		"varying float outline;\n"
+		"void main() {\n"
+		"	vec2 pixels_per_unit = abs(vec2(\n"
+		"			gl_ModelViewProjectionMatrix[0][0],\n"
+		"			gl_ModelViewProjectionMatrix[1][1]\n"
+		"	)) * viewport * 0.5;\n"
+		"	vec2 margin = (1.0 + shape.y) / pixels_per_unit;\n"
+		"	local = gl_Vertex.xy * (box.zw + margin);\n"
+		"	gl_Position = gl_ModelViewProjectionMatrix\n"
+		"			* vec4(box.xy + local, 0.0, 1.0);\n"
+		"	gl_FrontColor = gl_Color;\n"
+		"	half_size = box.zw;\n"
+		"	radius = shape.x;\n"
+		"	outline = shape.y;\n"
+		"}\n";
+
+const char *SDF_FRAGMENT_SHADER =
+		"#version 120\n"
+		"varying vec2 local;\n"
+		"varying vec2 half_size;\n"
+		"varying float radius;\n"
+		"varying float outline;\n"
+		"void main() {\n"
+		"	vec2 q = abs(local) - half_size + radius;\n"
+		"	float distance = length(max(q, 0.0))\n"
+		"			+ min(max(q.x, q.y), 0.0) - radius;\n"
+		"	float pixels = distance / (length(fwidth(local)) * 0.7071);\n"
+		"	float coverage = outline > 0.0\n"
+		"			? clamp(0.5 * outline + 0.5 - abs(pixels), 0.0, 1.0)\n"
+		"			: clamp(0.5 - pixels, 0.0, 1.0);\n"
+		"	gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * coverage);\n"
+		"}\n";
+
+// Width of outlines in pixels
+const GLfloat SDF_OUTLINE_WIDTH = 1;
+
+enum SdfProgramState {
+	SDF_NOT_CREATED, SDF_READY, SDF_FAILED
+};
+
+SdfProgramState sdf_program_state = SDF_NOT_CREATED;
+GLuint sdf_program;
+GLint sdf_viewport_uniform;
+
+bool is_sdf_program_ready() {
+	if (sdf_program_state == SDF_NOT_CREATED) {
+		sdf_program = gl.has_shaders
+				? create_shader_program(
+						"distance field",
+						SDF_VERTEX_SHADER, SDF_FRAGMENT_SHADER,
+						SDF_ATTRIBUTES
+				)
+				: 0;
+
+		if (sdf_program != 0) {
+			sdf_viewport_uniform =
+					gl.GetUniformLocation(sdf_program, "viewport");
+			sdf_program_state = SDF_READY;
+		} else {
+			sdf_program_state = SDF_FAILED;
+		}
+	}
+
+	return sdf_program_state == SDF_READY;
+}
+
+bool draw_sdf_shape(const RoundedRectangleCommand& c, bool fill) {
+	if (!is_sdf_program_ready()) {
+		return false;
+	}
+
+	const GLfloat half_width = (c.max.x - c.min.x) / 2;
+	const GLfloat half_height = (c.max.y - c.min.y) / 2;
+	const GLfloat radius = std::min({c.radius, half_width, half_height});
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	gl.UseProgram(sdf_program);
+	gl.Uniform2f(sdf_viewport_uniform, viewport[2], viewport[3]);
+
+	glBegin(GL_TRIANGLE_STRIP);
+		gl.VertexAttrib4f(
+				BOX_ATTRIBUTE,
+				c.min.x + half_width, c.min.y + half_height,
+				half_width, half_height
+		);
+		gl.VertexAttrib2f(
+				SHAPE_ATTRIBUTE,
+				radius, fill ? 0 : SDF_OUTLINE_WIDTH
+		);
+
+		glVertex2f(-1, -1);
+		glVertex2f(+1, -1);
+		glVertex2f(-1, +1);
+		glVertex2f(+1, +1);
+	glEnd();
+
+	gl.UseProgram(0);
+	return true;
+}
@@ -0,0 +1,36 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SDF_H_
+#define SDF_H_
+
+#include "commands.h"
+
+
+/*
+ * Draws the rounded rectangle to the GL context current on this thread as a
+ * single quad. The fragment shader computes the coverage of each pixel from
+ * the signed distance to the outline, so the cost does not depend on the
+ * size of the shape. Outlines are one pixel wide like GL lines.
+ *
+ * Returns false without drawing anything if shaders are not available.
+ */
+bool draw_sdf_shape(const RoundedRectangleCommand&, bool fill);
+
+
+#endif /* SDF_H_ */
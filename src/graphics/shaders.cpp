@@ -0,0 +1,84 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "shaders.h"
+
+#include <iostream>
+
+
+GLuint compile_shader(const char *name, GLenum type, const char *source) {
+	GLuint shader = gl.CreateShader(type);
+	gl.ShaderSource(shader, 1, &source, nullptr);
+	gl.CompileShader(shader);
+
+	GLint status;
+	gl.GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+
+	if (status != GL_TRUE) {
+		char log[1024];
+		gl.GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+		std::cerr << "Could not compile " << name << " shader: " << log
+				<< std::endl;
+
+		gl.DeleteShader(shader);
+		return 0;
+	}
+
+	return shader;
+}
+
+GLuint create_shader_program(
+		const char *name,
+		const char *vertex_source, const char *fragment_source,
+		const char * const *attributes
+) {
+	GLuint vertex = compile_shader(name, GL_VERTEX_SHADER, vertex_source);
+	GLuint fragment =
+			compile_shader(name, GL_FRAGMENT_SHADER, fragment_source);
+
+	if (vertex == 0 || fragment == 0) {
+		return 0;
+	}
+
+	GLuint program = gl.CreateProgram();
+	gl.AttachShader(program, vertex);
+	gl.AttachShader(program, fragment);
+
+	for (GLuint i = 0; attributes[i] != nullptr; ++i) {
+		gl.BindAttribLocation(program, i, attributes[i]);
+	}
+
+	gl.LinkProgram(program);
+
+	// Shaders are freed together with the program
+	gl.DeleteShader(vertex);
+	gl.DeleteShader(fragment);
+
+	GLint status;
+	gl.GetProgramiv(program, GL_LINK_STATUS, &status);
+
+	if (status != GL_TRUE) {
+		char log[1024];
+		gl.GetProgramInfoLog(program, sizeof(log), nullptr, log);
+		std::cerr << "Could not link " << name << " shader: " << log
+				<< std::endl;
+		return 0;
+	}
+
+	return program;
+}
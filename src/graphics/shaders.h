@@ -0,0 +1,37 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHADERS_H_
+#define SHADERS_H_
+
+#include "gl_extensions.h"
+
+
+/*
+ * Compiles and links a GLSL program. The attributes are bound to locations
+ * 0, 1, 2 and so on in the given order; the list ends with nullptr. Errors
+ * are reported with the given name. Returns 0 on failure.
+ */
+GLuint create_shader_program(
+		const char *name,
+		const char *vertex_source, const char *fragment_source,
+		const char * const *attributes
+);
+
+
+#endif /* SHADERS_H_ */
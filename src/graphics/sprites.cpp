@@ -18,36 +18,110 @@
 
 #include "sprites.h"
 
+#include "quality.h"
 #include "../logic/logic.h"
 
 
-void Sprite::render(Game& game, Time now) {
+// Sprites draw no further than this from their position
+const ScreenCoord SPRITE_REACH = 2;
+
+// Longer than any sprite lives
+const Time MAX_SPRITE_LIFETIME = 1;
+
+bool Sprite::is_visible(const LevelView& view) const {
+	return view.contains(position, SPRITE_REACH);
+}
+
+void Sprite::render(Game& game, Timestamp now, const LevelView& view) {
 	if (is_dead()) return;
 
 	if (start_time < 0) {
 		start_time = now;
 	}
 
-	do_render(game, now - start_time);
+	Time time = to_seconds(now - start_time);
+
+	if (!is_visible(view)) {
+		// Sprites only expire in do_render()
+		if (time > MAX_SPRITE_LIFETIME) {
+			die();
+		}
+		return;
+	}
+
+	do_render(game, time);
 }
 
-FloorCollisionSprite::FloorCollisionSprite(Ball& reference) :
-		Sprite(reference.get_position())
-{
-	start_pos = position;
-	radius = reference.get_radius();
-	velocity = { +reference.get_velocity_x(), +reference.get_velocity_y() };
+FloorCollisionSprite::FloorCollisionSprite(const GameEvent& ball_lost) :
+		Sprite(ball_lost.position),
+		start_pos(ball_lost.position),
+		radius(ball_lost.radius),
+		velocity(ball_lost.velocity)
+{}
+
+bool FloorCollisionSprite::is_visible(const LevelView& view) const {
+	// The splash grows up to six radii around the point of impact
+	return view.contains(start_pos, 6 * radius)
+			|| view.contains(position, radius);
 }
 
-BonusCollectedSprite::BonusCollectedSprite(Bonus& reference) :
-		Sprite(reference.get_position()),
-		good(reference.is_good())
+BonusCollectedSprite::BonusCollectedSprite(const GameEvent& bonus_caught) :
+		Sprite(bonus_caught.position),
+		good(bonus_caught.good)
+{}
+
+BonusFloorCollisionSprite::BonusFloorCollisionSprite(
+		const GameEvent& bonus_lost
+) :
+		Sprite(bonus_lost.position),
+		start_pos(bonus_lost.position),
+		velocity(bonus_lost.velocity),
+		good(bonus_lost.good)
 {}
 
-BonusFloorCollisionSprite::BonusFloorCollisionSprite(Bonus& reference) :
-		Sprite(reference.get_position()),
-		good(reference.is_good())
-{
-	start_pos = position;
-	velocity = { +reference.get_velocity_x(), +reference.get_velocity_y() };
+/*
+ * Events
+ */
+
+Sprite* create_event_sprite(const GameEvent& event) {
+	switch (event.type) {
+
+	case WALL_HIT:
+	case PLATFORM_HIT:
+	case BRICK_HIT:
+		return new CollisionSprite(event.position);
+
+	case BRICK_DESTROYED:
+		if (event.brick == EXPLOSIVE_BRICK) {
+			return new BrickExplosionSprite(event.position);
+		}
+		return new BrickBrokenSprite(event.position, false);
+
+	case BONUS_CAUGHT:
+		return new BonusCollectedSprite(event);
+
+	case BONUS_LOST:
+		return new BonusFloorCollisionSprite(event);
+
+	case BALL_LOST:
+		return new FloorCollisionSprite(event);
+
+	}
+
+	return nullptr;
+}
+
+void create_event_sprites(Game& game) {
+	ArenaScope arena_scope(game.get_arena());
+
+	for (const GameEvent& event : game.events) {
+		if (!should_create_sprite(game.sprites.size())) {
+			continue;
+		}
+
+		Sprite *sprite = create_event_sprite(event);
+		if (sprite != nullptr) {
+			game.add_sprite(sprite);
+		}
+	}
 }
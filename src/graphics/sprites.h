@@ -20,12 +20,14 @@
 #define SPRITES_H_
 
 #include "../common.h"
+#include "../arena.h"
+#include "../logic/events.h"
 
 
-class Sprite {
+class Sprite : public ArenaAllocated {
 private:
 	bool dead = false;
-	Time start_time = -1;
+	Timestamp start_time = -1;
 
 protected:
 	LevelPoint position;
@@ -36,6 +38,11 @@ protected:
 
 	virtual void do_render(Game& game, Time time) = 0;
 
+	/*
+	 * Whether the sprite may draw anything within the view.
+	 */
+	virtual bool is_visible(const LevelView& view) const;
+
 public:
 	Sprite(LevelPoint pos) :
 	position(pos) {}
@@ -46,7 +53,11 @@ public:
 		return dead;
 	}
 
-	void render(Game& game, Time now);
+	/*
+	 * Renders the sprite if it is visible. Sprites that stay out of view for
+	 * longer than any sprite lives die without being drawn.
+	 */
+	void render(Game& game, Timestamp now, const LevelView& view);
 };
 
 class CollisionSprite : public Sprite {
@@ -74,9 +85,10 @@ private:
 	VelocityVector velocity;
 
 public:
-	FloorCollisionSprite(Ball& reference);
+	FloorCollisionSprite(const GameEvent& ball_lost);
 
 	void do_render(Game& game, Time time) override;
+	bool is_visible(const LevelView& view) const override;
 };
 
 class BrickExplosionSprite : public Sprite {
@@ -92,7 +104,7 @@ private:
 	bool good;
 
 public:
-	BonusCollectedSprite(Bonus& reference);
+	BonusCollectedSprite(const GameEvent& bonus_caught);
 
 	void do_render(Game& game, Time time) override;
 };
@@ -104,10 +116,16 @@ private:
 	bool good;
 
 public:
-	BonusFloorCollisionSprite(Bonus& reference);
+	BonusFloorCollisionSprite(const GameEvent& bonus_lost);
 
 	void do_render(Game& game, Time time) override;
 };
 
+/*
+ * Adds the sprites for the events of the last tick to the game, as many as
+ * the rendering quality allows.
+ */
+void create_event_sprites(Game&);
+
 
 #endif /* SPRITES_H_ */
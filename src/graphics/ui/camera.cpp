@@ -0,0 +1,136 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "camera.h"
+
+#include "../graphics.h"
+
+
+// Fraction of the way to the target covered per second
+const float CAMERA_FOLLOW_RATE = 4;
+
+// Keeps the platform at least this far from the edges of the view
+const ScreenCoord CAMERA_PLATFORM_PADDING = 2;
+
+float camera_zoom = 1;
+
+void set_camera_zoom(float zoom) {
+	camera_zoom = zoom;
+}
+
+float get_camera_zoom() {
+	return camera_zoom;
+}
+
+/*
+ * Centers a visible span on the value without showing anything outside
+ * [0; length], or centers it on the level if the whole length is visible.
+ */
+ScreenCoord keep_in_level(
+		ScreenCoord value, ScreenCoord visible, ScreenCoord length
+) {
+	if (visible >= length) {
+		return length / 2.0f;
+	}
+
+	return force_in_range(visible / 2, value, length - visible / 2);
+}
+
+ScreenPoint Camera::get_target(const Game& game, Size visible) const {
+	ScreenPoint platform = {
+			static_cast<ScreenCoord>(game.platform.get_position()),
+			static_cast<ScreenCoord>(PLATFORM_HEIGHT)
+	};
+
+	ScreenPoint min = platform, max = platform;
+	for (const Ball *ball : game.get_balls()) {
+		ScreenPoint position = ball->get_position();
+
+		min.x = std::min(min.x, position.x);
+		min.y = std::min(min.y, position.y);
+		max.x = std::max(max.x, position.x);
+		max.y = std::max(max.y, position.y);
+	}
+
+	ScreenPoint target = {(min.x + max.x) / 2, (min.y + max.y) / 2};
+
+	// Balls far away must not take the platform out of view
+	Size reach = {
+			std::max(0.0f, visible.x / 2 - CAMERA_PLATFORM_PADDING),
+			std::max(0.0f, visible.y / 2 - CAMERA_PLATFORM_PADDING)
+	};
+
+	return {
+		force_in_range(platform.x - reach.x, target.x, platform.x + reach.x),
+		force_in_range(platform.y - reach.y, target.y, platform.y + reach.y)
+	};
+}
+
+void Camera::update(
+		const Game& game, Size area, ScreenCoord margin, Time frame_length
+) {
+	Size level = {
+		static_cast<ScreenCoord>(game.level->get_width()),
+		static_cast<ScreenCoord>(game.level->get_height())
+	};
+
+	this->area = area;
+	scale_factor = zoom * std::min(
+			(area.x - 2*margin) / level.x,
+			(area.y - 2*margin) / level.y
+	);
+
+	ScreenPoint target;
+
+	if (zoom <= 1) {
+		target = {level.x / 2.0f, level.y / 2.0f};
+	} else {
+		Size visible = {area.x / scale_factor, area.y / scale_factor};
+		target = get_target(game, visible);
+		target.x = keep_in_level(target.x, visible.x, level.x);
+		target.y = keep_in_level(target.y, visible.y, level.y);
+	}
+
+	if (!is_placed) {
+		center = target;
+		is_placed = true;
+		return;
+	}
+
+	float progress = std::min(1.0f, CAMERA_FOLLOW_RATE * frame_length);
+	center.x += (target.x - center.x) * progress;
+	center.y += (target.y - center.y) * progress;
+}
+
+void Camera::apply() const {
+	translate(area.x / 2.0f, area.y / 2.0f);
+	scale(scale_factor, -scale_factor);
+	translate(-center.x, -center.y);
+}
+
+LevelView Camera::get_view() const {
+	Size half = {
+			area.x / 2.0f / scale_factor,
+			area.y / 2.0f / scale_factor
+	};
+
+	return {
+		{center.x - half.x, center.y - half.y},
+		{center.x + half.x, center.y + half.y}
+	};
+}
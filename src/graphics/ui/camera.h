@@ -0,0 +1,81 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAMERA_H_
+#define CAMERA_H_
+
+#include "layout.h"
+#include "../../logic/logic.h"
+
+
+/*
+ * Zoom of game cameras relative to fitting the whole level, 1 by default.
+ */
+void set_camera_zoom(float);
+float get_camera_zoom();
+
+/*
+ * Decides which part of a level is shown in an area starting at the origin.
+ * At zoom 1 the whole level is centered and scaled to fit with the margin
+ * around it. Closer cameras follow the platform and the balls without
+ * leaving the level.
+ */
+class Camera {
+private:
+	float zoom;
+	float scale_factor = 1;
+
+	Size area = {0, 0};
+	ScreenPoint center = {0, 0};
+	bool is_placed = false;
+
+	ScreenPoint get_target(const Game&, Size visible) const;
+
+public:
+	Camera(float zoom = get_camera_zoom()) :
+	zoom(zoom) {}
+
+	float get_zoom() const {
+		return zoom;
+	}
+
+	void set_zoom(float zoom) {
+		this->zoom = zoom;
+	}
+
+	/*
+	 * Moves the camera towards the action in the game. The first update
+	 * places it there at once.
+	 */
+	void update(
+			const Game&, Size area, ScreenCoord margin, Time frame_length
+	);
+
+	/*
+	 * Applies the transformation from level to area coordinates.
+	 */
+	void apply() const;
+
+	/*
+	 * Returns the part of the level visible in the area.
+	 */
+	LevelView get_view() const;
+};
+
+
+#endif /* CAMERA_H_ */
@@ -69,7 +69,7 @@ void Component::set_layout_hint(LayoutHint hint) {
 }
 
 void Component::apply_transform() {
-	glTranslatef(bounds.min.x, bounds.min.y, 0);
+	translate(bounds.min.x, bounds.min.y);
 }
 
 void Component::render() {
@@ -77,13 +77,13 @@ void Component::render() {
 		layout();
 	}
 
-	glPushMatrix();
+	push_transform();
 	apply_transform();
 
 	render_self();
 	render_children();
 
-	glPopMatrix();
+	pop_transform();
 }
 
 void Component::render_children() {
@@ -124,6 +124,32 @@ void Component::set_preferred_size(Size preferred_size) {
 void Component::invalidate() {
 	is_valid = false;
 	is_preferred_size_cache_valid = false;
+
+	request_redraw();
+}
+
+void Component::request_redraw() {
+	get_root()->is_redraw_requested = true;
+}
+
+bool Component::take_redraw_request() {
+	bool result = is_redraw_requested;
+	is_redraw_requested = false;
+	return result;
+}
+
+bool Component::has_animation() const {
+	if (is_animated()) {
+		return true;
+	}
+
+	for (Component *child : children) {
+		if (child->has_animation()) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 void Component::layout() {
@@ -221,6 +247,7 @@ void Component::focus_next() {
 		if (component->is_focusable()) {
 			this->has_focus = false;
 			component->has_focus = true;
+			request_redraw();
 			return;
 		}
 
@@ -254,6 +281,7 @@ void Component::focus_previous() {
 		if (component->is_focusable()) {
 			this->has_focus = false;
 			component->has_focus = true;
+			request_redraw();
 			return;
 		}
 
@@ -293,6 +321,7 @@ void Component::grab_focus() {
 	}
 
 	has_focus = true;
+	request_redraw();
 }
 
 /*
@@ -34,6 +34,9 @@ private:
 	bool has_focus = false;
 	bool is_valid = false;
 
+	// Only used in the root
+	bool is_redraw_requested = true;
+
 	LayoutManager * const layout_manager;
 	LayoutHint layout_hint;
 
@@ -134,6 +137,43 @@ public:
 	is_focusable() const
 	{ return false; }
 
+	/*
+	 * Returns whether render_self() may draw something different in each
+	 * frame. Layers containing such components are not cached.
+	 */
+	virtual
+	bool
+	is_animated() const
+	{ return false; }
+
+	/*
+	 * Returns whether this component or any of its descendants is animated.
+	 */
+	bool
+	has_animation() const;
+
+	/*
+	 * Tells the layer that the appearance of the component has changed.
+	 * Called on invalidation and focus changes.
+	 */
+	void
+	request_redraw();
+
+	/*
+	 * Returns whether a redraw was requested anywhere in the tree since the
+	 * last call. Only valid for the root.
+	 */
+	bool
+	take_redraw_request();
+
+	/*
+	 * Returns whether a redraw is pending without taking the request. Only
+	 * valid for the root.
+	 */
+	bool
+	has_redraw_request() const
+	{ return is_redraw_requested; }
+
 	void
 	render();
 
@@ -18,7 +18,11 @@
 
 #include "game_layer.h"
 
+#include <sstream>
+
 #include "../graphics.h"
+#include "../quality.h"
+#include "../../allocations.h"
 #include "../../logic/logic.h"
 #include "../../workflow.h"
 
@@ -104,40 +108,85 @@ Layer* create_game_layer(Game *game) {
  * GameComponent
  */
 
+const size_t HISTORY_CAPACITY = 8 * 1024 * 1024;
+const Time HISTORY_INTERVAL = 0.1f;
+const Time REWIND_TIME = 1.0f;
+const Time AUTOSAVE_INTERVAL = 5.0f;
+const float CAMERA_ZOOM_STEP = 1.25f;
+
+GameComponent::GameComponent(Game *game, LayoutHint hint) :
+	Component("Game", hint),
+	game(game),
+	history(HISTORY_CAPACITY)
+{}
+
 GameComponent::~GameComponent() {
 	delete game;
-}
 
-Size GameComponent::get_level_size() {
-	return {
-		static_cast<ScreenCoord>(get_game()->level->get_width()),
-		static_cast<ScreenCoord>(get_game()->level->get_height())
-	};
+	if (has_scaled_cache) {
+		destroy_render_cache(scaled_cache);
+	}
 }
 
-void GameComponent::apply_transform() {
-	Size comp = get_bounds().size();
-	Size level = get_level_size();
+void GameComponent::render_self() {
+	tick();
+
+	camera.update(*game, get_bounds().size(), MARGIN, get_frame_length());
+	LevelView view = camera.get_view();
+
+	// The whole level fits unless zoomed in, and splashes may leave the area
+	bool is_clipping = camera.get_zoom() > 1;
+
+	// A still game is drawn into the cache of the layer, which cannot nest
+	float resolution = get_quality().resolution_scale;
+	bool is_scaling = resolution < 1
+			&& is_layer_caching_available() && is_animated();
 
-	float scale_factor = std::min(
-			(comp.x - 2*MARGIN) / level.x,
-			(comp.y - 2*MARGIN) / level.y
-	);
+	if (is_scaling) {
+		if (!has_scaled_cache) {
+			scaled_cache = create_render_cache();
+			has_scaled_cache = true;
+		}
+
+		begin_render_cache(scaled_cache, resolution);
+	}
+
+	push_transform();
+	camera.apply();
+	if (is_clipping) set_clip(view.min, view.max);
+	render_game(*game, game->clock.get_now(), view);
+	if (is_clipping) clear_clip();
+	pop_transform();
+
+	if (is_scaling) {
+		end_render_cache();
+		draw_render_cache(scaled_cache);
+	}
 
-	glTranslatef(comp.x / 2.0f, comp.y / 2.0f, 0.0f);
-	glScalef(scale_factor, -scale_factor, 1.0f);
-	glTranslatef(-level.x / 2.0f, -level.y / 2.0f, 0.0f);
+	if (is_showing_stats) {
+		render_stats();
+	}
 }
 
-void GameComponent::render_self() {
-	tick();
+Size get_level_size(const Game& game) {
+	return {
+		static_cast<ScreenCoord>(game.level->get_width()),
+		static_cast<ScreenCoord>(game.level->get_height())
+	};
+}
 
-	render_decorations();
-	render_game();
+LevelView apply_game_transform(
+		const Game& game, Size area, ScreenCoord margin
+) {
+	Camera camera(1);
+	camera.update(game, area, margin, 0);
+	camera.apply();
+
+	return camera.get_view();
 }
 
-void GameComponent::render_decorations() {
-	Size level = get_level_size();
+void render_decorations(const Game& game) {
+	Size level = get_level_size(game);
 
 	set_color(Design::FILL);
 
@@ -146,59 +195,232 @@ void GameComponent::render_decorations() {
 	draw_line({level.x, 0/*-INFINITY*/}, {level.x, level.y});
 }
 
-void GameComponent::render_game() {
-	game->level->render(*game);
-	game->platform.render();
+void render_game(Game& game, Timestamp now, const LevelView& view) {
+	render_decorations(game);
+
+	game.level->render(game, view);
+	game.platform.render();
+
+	for (Ball *ball : game.get_balls()) {
+		if (view.contains(ball->get_position(), ball->get_radius())) {
+			ball->render(now);
+		}
+	}
 
-	for (Ball *ball : game->get_balls()) ball->render();
-	for (Bonus *bonus : game->get_bonuses()) bonus->render();
+	for (Bonus *bonus : game.get_bonuses()) {
+		// With the shadow
+		if (view.contains(bonus->get_position(), 2 * bonus->get_radius())) {
+			bonus->render(now);
+		}
+	}
 
 	for (
-			auto sprite = game->sprites.begin();
-			sprite != game->sprites.end();
+			auto sprite = game.sprites.begin();
+			sprite != game.sprites.end();
 			++sprite
 	) {
-		(**sprite).render(*game, static_cast<float>(glfwGetTime()));
+		(**sprite).render(game, now, view);
 
 		if ((**sprite).is_dead()) {
 			auto to_delete = sprite;
 			--sprite;
 
 			delete *to_delete;
-			game->sprites.erase(to_delete);
+			game.sprites.erase(to_delete);
 		}
 	}
 }
 
 void GameComponent::tick() {
-	::tick(*game, get_frame_length());
+	GameStats before = game->stats;
+	Timestamp game_time_before = game->clock.get_now();
+	{
+		AllocationPhaseScope allocation_phase(TICK_PHASE);
+		advance_game(*game, get_frame_time());
+		create_event_sprites(*game);
+	}
+	frame_stats = game->stats.since(before);
+
+	if (is_reporting_stats()) {
+		report_stats(get_frame_length());
+	}
+
+	if (game->state == RUNNING) {
+		record_history(to_seconds(game->clock.get_now() - game_time_before));
+	}
+
+	if (game->state == VICTORY || game->state == DEFEAT) {
+		if (!is_showing_results) {
+			is_showing_results = true;
+			show_results_menu(*game);
+		}
+	}
+}
+
+void GameComponent::record_history(Time frame_length) {
+	since_history += frame_length;
+	since_autosave += frame_length;
+
+	if (since_history < HISTORY_INTERVAL) {
+		return;
+	}
+
+	since_history = 0;
+	save_snapshot(*game, snapshot);
+	history.push(snapshot);
+
+	if (since_autosave >= AUTOSAVE_INTERVAL && !get_autosave_file().empty()) {
+		since_autosave = 0;
+		write_snapshot_file(get_autosave_file(), snapshot);
+	}
+}
+
+const Time STATS_REPORT_PERIOD = 5.0f;
+
+void GameComponent::report_stats(Time frame_length) {
+	since_stats_report += frame_length;
+
+	if (since_stats_report < STATS_REPORT_PERIOD) {
+		return;
+	}
+
+	std::cout << "Game stats, total: ";
+	print_stats(std::cout, game->stats, ", ");
+
+	// Only the period is rounded, the stats and later output keep the format
+	std::ios_base::fmtflags flags = std::cout.flags();
+	std::streamsize precision = std::cout.precision();
+	std::cout << "\n  last " << std::fixed << std::setprecision(1)
+			<< since_stats_report << " s: ";
+	std::cout.flags(flags);
+	std::cout.precision(precision);
+
+	print_stats(std::cout, game->stats.since(reported_stats), ", ");
+	std::cout << std::endl;
+
+	since_stats_report = 0;
+	reported_stats = game->stats;
+}
+
+void GameComponent::render_stats() {
+	const Font font(16);
+
+	StringDrawer total = draw_string(font) << "Total\n";
+	print_stats(total.stream, game->stats, "\n");
+
+	StringDrawer frame = draw_string(font) << "Last frame\n";
+	print_stats(frame.stream, frame_stats, "\n");
+
+	frame.stream << "\nQuality level: " << get_quality_level();
+	if (is_quality_governor_enabled()) {
+		frame.stream << " (adaptive)";
+	}
+
+	if (is_tracking_allocations()) {
+		for (AllocationPhase phase : {TICK_PHASE, RENDER_PHASE}) {
+			AllocationCounts counts = get_frame_allocation_counts(phase);
+
+			frame.stream << "\n" << get_allocation_phase_name(phase)
+					<< " allocations: " << counts.allocations
+					<< " (" << counts.bytes << " bytes)";
+		}
+	}
+
+	ScreenCoord frame_x = MARGIN + total.get_dimensions().x + 2*MARGIN;
+
+	set_color(Design::OUTLINE);
+	total.render({MARGIN, MARGIN});
+	frame.render({frame_x, MARGIN});
+}
+
+void GameComponent::rewind(size_t snapshots) {
+	if (history.size() == 0) {
+		return;
+	}
+
+	snapshots = std::min(snapshots, history.size() - 1);
+
+	if (!history.get(snapshots, snapshot)) {
+		return;
+	}
+
+	Game *restored = load_snapshot(snapshot);
+	if (restored == nullptr) {
+		return;
+	}
+
+	std::swap(restored->bot, game->bot);
+	restored->clock = game->clock;
+	restored->stats = game->stats;
+	delete game;
+	game = restored;
+
+	history.rewind(snapshots);
+	since_history = 0;
+}
+
+bool GameComponent::is_animated() const {
+	if (game->clock.is_paused()) {
+		return false;
+	}
+
+	return game->state == RUNNING || !game->sprites.empty();
 }
 
 bool GameComponent::on_event(KeyEvent event) {
 	if (event.is(ANY, 4,
 			GLFW_KEY_A, GLFW_KEY_D, GLFW_KEY_LEFT, GLFW_KEY_RIGHT
 	)) {
-		game->platform.set_movement(
-				event.key == GLFW_KEY_A || event.key == GLFW_KEY_LEFT,
+		game->input.push({
+				game->clock.to_game_time(event.time),
+				(event.key == GLFW_KEY_A || event.key == GLFW_KEY_LEFT)
+						? MOVE_LEFT
+						: MOVE_RIGHT,
 				event.action == GLFW_PRESS,
 				(event.mods & GLFW_MOD_SHIFT) != 0
-		);
+		});
 		return true;
 	}
 
 	if (event.is(ANY, 2,
 			GLFW_KEY_LEFT_SHIFT, GLFW_KEY_RIGHT_SHIFT
 	)) {
-		game->platform.set_movement_fast(
-			event.action == GLFW_PRESS
-		);
+		game->input.push({
+				game->clock.to_game_time(event.time),
+				MOVE_FAST,
+				event.action == GLFW_PRESS,
+				event.action == GLFW_PRESS
+		});
 		return true;
 	}
 
 	if (event.is(PRESS, GLFW_KEY_SPACE)) {
-		for (Ball *ball : game->get_balls()) {
-			ball->release();
+		game->input.push({
+				game->clock.to_game_time(event.time),
+				RELEASE_BALLS, true, false
+		});
+		return true;
+	}
+
+	if (event.is(PRESS, 2, GLFW_KEY_EQUAL, GLFW_KEY_MINUS)) {
+		float zoom = camera.get_zoom() * CAMERA_ZOOM_STEP;
+		if (event.key == GLFW_KEY_MINUS) {
+			zoom = std::max(1.0f, camera.get_zoom() / CAMERA_ZOOM_STEP);
 		}
+
+		camera.set_zoom(zoom);
+		request_redraw();
+		return true;
+	}
+
+	if (event.is(PRESS, GLFW_KEY_F3)) {
+		is_showing_stats = !is_showing_stats;
+		request_redraw();
+		return true;
+	}
+
+	if (event.is(PRESS, GLFW_KEY_F9)) {
+		rewind(static_cast<size_t>(REWIND_TIME / HISTORY_INTERVAL));
 		return true;
 	}
 
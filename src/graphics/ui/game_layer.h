@@ -19,32 +19,62 @@
 #ifndef GAME_LAYER_H_
 #define GAME_LAYER_H_
 
+#include "camera.h"
 #include "layer.h"
+#include "../../logic/snapshot.h"
+#include "../../logic/stats.h"
 
 
 Layer* create_game_layer(Game *game);
 
+/*
+ * Centers the level of the game in an area of the given size starting at the
+ * origin, scaled to fit with the margin around it. Returns the visible part.
+ */
+LevelView apply_game_transform(const Game&, Size area, ScreenCoord margin);
+
+/*
+ * Renders the parts of the game and the walls around its level that are in
+ * view as of the given moment of game time. Expects the transformation of the view, see
+ * Camera and apply_game_transform().
+ */
+void render_game(Game&, Timestamp now, const LevelView& view);
+
 class GameComponent : public Component {
 private:
-	Game * const game;
+	Game *game;
+	bool is_showing_results = false;
 
-	void tick();
+	Camera camera;
+
+	// The game is drawn through it at a lowered resolution
+	RenderCacheId scaled_cache;
+	bool has_scaled_cache = false;
+
+	bool is_showing_stats = false;
+	GameStats frame_stats;
+	GameStats reported_stats;
+	Time since_stats_report = 0;
 
-	void render_decorations();
-	void render_game();
+	// Recent states for rewinding
+	SnapshotRing history;
+	Snapshot snapshot;
+	Time since_history = 0;
+	Time since_autosave = 0;
 
-	Size get_level_size();
+	void tick();
+	void record_history(Time frame_length);
+	void rewind(size_t snapshots);
+
+	void report_stats(Time frame_length);
+	void render_stats();
 
 protected:
-	virtual void apply_transform() override;
 	virtual void render_self() override;
 	virtual bool on_event(KeyEvent) override;
 
 public:
-	GameComponent(Game *game, LayoutHint hint) :
-		Component("Game", hint),
-		game(game)
-	{}
+	GameComponent(Game *game, LayoutHint hint);
 
 	virtual ~GameComponent();
 
@@ -55,6 +85,12 @@ public:
 	virtual bool is_focusable() const override {
 		return true;
 	}
+
+	/*
+	 * The game is still while paused, and once it has ended and its last
+	 * sprites have faded. The displays of the layer only change with it.
+	 */
+	virtual bool is_animated() const override;
 };
 
 
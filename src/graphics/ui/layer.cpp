@@ -29,9 +29,57 @@ Layer::Layer(LayoutManager *manager, bool close_on_escape) :
 
 Layer::~Layer() {
 	delete root;
+
+	if (has_cache) {
+		destroy_render_cache(cache);
+	}
 }
 
 void Layer::render() {
+	bool changed = root->take_redraw_request();
+
+	// Animations may stop and start without a redraw request
+	bool use_cache = should_use_cache();
+	if (use_cache != is_using_cache) {
+		is_using_cache = use_cache;
+		changed = true;
+	}
+
+	if (!is_using_cache) {
+		render_contents();
+		return;
+	}
+
+	if (changed) {
+		begin_render_cache(cache);
+		render_contents();
+		end_render_cache();
+
+		// Layout done while rendering requests a redraw that is not needed
+		root->take_redraw_request();
+	}
+
+	draw_render_cache(cache);
+}
+
+bool Layer::needs_render() const {
+	return root->has_redraw_request() || root->has_animation();
+}
+
+bool Layer::should_use_cache() {
+	if (!is_layer_caching_available() || root->has_animation()) {
+		return false;
+	}
+
+	if (!has_cache) {
+		cache = create_render_cache();
+		has_cache = true;
+	}
+
+	return true;
+}
+
+void Layer::render_contents() {
 	set_color(Design::BACKGROUND_TRANSPARENT);
 
 	WindowDimensions dims = get_window_size();
@@ -20,6 +20,7 @@
 #define LAYER_H_
 
 #include "component.h"
+#include "../commands.h"
 
 
 class Layer {
@@ -29,6 +30,14 @@ private:
 
 	Action close_action = nullptr;
 
+	// Layers that are not animated are drawn once into the cache
+	RenderCacheId cache;
+	bool has_cache = false;
+	bool is_using_cache = false;
+
+	void render_contents();
+	bool should_use_cache();
+
 public:
 	Layer(LayoutManager*, bool close_on_escape = false);
 	virtual ~Layer();
@@ -38,6 +47,12 @@ public:
 	{ return root; }
 
 	void render();
+
+	/*
+	 * Returns whether rendering would change the appearance of the layer.
+	 */
+	bool needs_render() const;
+
 	void on_key_event(KeyEvent event);
 	void on_resize();
 
@@ -22,7 +22,30 @@
 std::vector<Layer*> layers;
 std::vector<Layer*> layers_copy;
 
+// Set whenever the layer stack or the window changes
+bool is_frame_requested = true;
+
+void request_frame() {
+	is_frame_requested = true;
+}
+
+bool is_frame_needed() {
+	if (is_frame_requested) {
+		return true;
+	}
+
+	for (Layer *layer : layers) {
+		if (layer->needs_render()) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void render_layers() {
+	is_frame_requested = false;
+
 	layers_copy.clear();
 	for (Layer *layer : layers) {
 		layers_copy.push_back(layer);
@@ -36,6 +59,7 @@ void render_layers() {
 void add_layer(Layer* layer) {
 	layers.push_back(layer);
 	layer->on_added();
+	request_frame();
 }
 
 void remove_top_layer() {
@@ -47,6 +71,7 @@ void remove_top_layer() {
 	layers.pop_back();
 	layer->on_removed();
 	delete layer;
+	request_frame();
 }
 
 void remove_all_layers() {
@@ -55,6 +80,7 @@ void remove_all_layers() {
 	}
 
 	layers.clear();
+	request_frame();
 }
 
 void dispatch_key_event(KeyEvent event) {
@@ -63,12 +89,15 @@ void dispatch_key_event(KeyEvent event) {
 	}
 
 	layers.back()->on_key_event(event);
+	request_frame();
 }
 
 void dispatch_resize() {
 	for (Layer *layer : layers) {
 		layer->on_resize();
 	}
+
+	request_frame();
 }
 
 Component* center_component(Component* content) {
@@ -21,6 +21,7 @@
 
 #include "layer.h"
 #include "game_layer.h"
+#include "wall_layer.h"
 
 #include "button.h"
 #include "label.h"
@@ -35,6 +36,18 @@ void remove_all_layers();
 void dispatch_key_event(KeyEvent);
 void dispatch_resize();
 
+/*
+ * Asks for the next frame to be rendered even if no layer is animated, for
+ * changes that happen outside of the components such as window exposure.
+ */
+void request_frame();
+
+/*
+ * Returns whether the next frame would differ from the last one: a frame was
+ * requested, a layer is animated or has a pending redraw.
+ */
+bool is_frame_needed();
+
 
 Component* center_component(Component*);
 
@@ -38,6 +38,7 @@ struct KeyEvent {
 	int scanmode;
 	int action;
 	int mods;
+	Timestamp time;
 
 	inline bool is(
 			GLKeyAction accepted_action,
@@ -0,0 +1,120 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "wall_layer.h"
+
+#include <cmath>
+
+#include "game_layer.h"
+#include "../graphics.h"
+#include "../../allocations.h"
+#include "../../workflow.h"
+
+
+const ScreenCoord TILE_MARGIN = 4;
+
+Layer* create_wall_layer(unsigned int games) {
+	Layer *result = new Layer(new BorderLayoutManager());
+
+	Component *wall = new WallComponent(games, BorderLayoutHints::CENTER);
+	wall->grab_focus();
+
+	result->get_root()->add_child(wall);
+	return result;
+}
+
+WallComponent::WallComponent(unsigned int games, LayoutHint hint) :
+	Component("Wall", hint),
+	tiles(std::max(games, 1u))
+{
+	columns = static_cast<unsigned int>(std::ceil(std::sqrt(tiles.size())));
+	rows = (tiles.size() + columns - 1) / columns;
+
+	// Spread the games over the levels so that all of them are on show
+	for (size_t i = 0; i < tiles.size(); ++i) {
+		for (size_t level = 0; level < i % (max_level + 1); ++level) {
+			delete tiles[i].attempt.start_next_level();
+		}
+
+		tiles[i].game = nullptr;
+		start_next_game(tiles[i]);
+	}
+}
+
+WallComponent::~WallComponent() {
+	for (Tile& tile : tiles) {
+		delete tile.game;
+	}
+}
+
+void WallComponent::start_next_game(Tile& tile) {
+	if (tile.game != nullptr && tile.game->state == DEFEAT) {
+		tile.attempt = Attempt();
+	}
+
+	delete tile.game;
+
+	tile.game = tile.attempt.start_next_level();
+	tile.game->bot = new Bot();
+}
+
+void WallComponent::tick(Tile& tile) {
+	{
+		// Game logic keeps score in the current attempt
+		AttemptScope attempt_scope(tile.attempt);
+		AllocationPhaseScope allocation_phase(TICK_PHASE);
+		advance_game(*tile.game, get_frame_time());
+		create_event_sprites(*tile.game);
+	}
+
+	if (tile.game->state == VICTORY || tile.game->state == DEFEAT) {
+		start_next_game(tile);
+	}
+}
+
+void WallComponent::render_self() {
+	Size size = get_bounds().size();
+	Size tile_size = {size.x / columns, size.y / rows};
+
+	begin_batch();
+
+	for (size_t i = 0; i < tiles.size(); ++i) {
+		tick(tiles[i]);
+
+		push_transform();
+		translate(
+				tile_size.x * (i % columns),
+				tile_size.y * (i / columns)
+		);
+		LevelView view =
+				apply_game_transform(*tiles[i].game, tile_size, TILE_MARGIN);
+		render_game(*tiles[i].game, tiles[i].game->clock.get_now(), view);
+		pop_transform();
+	}
+
+	end_batch();
+}
+
+bool WallComponent::on_event(KeyEvent event) {
+	if (event.is(PRESS, GLFW_KEY_ESCAPE)) {
+		show_main_menu();
+		return true;
+	}
+
+	return false;
+}
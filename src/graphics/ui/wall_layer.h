@@ -0,0 +1,68 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef WALL_LAYER_H_
+#define WALL_LAYER_H_
+
+#include "layer.h"
+#include "../../logic/logic.h"
+
+
+/*
+ * Creates a layer that shows the given number of bot-played games at once.
+ */
+Layer* create_wall_layer(unsigned int games);
+
+/*
+ * Bot-played games tiled in a grid. Each game keeps its own attempt and moves
+ * on to the next level when it ends. All games are drawn in one batch so
+ * that their shapes are shared.
+ */
+class WallComponent : public Component {
+private:
+	struct Tile {
+		Game *game;
+		Attempt attempt;
+	};
+
+	std::vector<Tile> tiles;
+	unsigned int columns, rows;
+
+	void start_next_game(Tile&);
+	void tick(Tile&);
+
+protected:
+	virtual void render_self() override;
+	virtual bool on_event(KeyEvent) override;
+
+public:
+	WallComponent(unsigned int games, LayoutHint hint);
+
+	virtual ~WallComponent();
+
+	virtual bool is_focusable() const override {
+		return true;
+	}
+
+	virtual bool is_animated() const override {
+		return true;
+	}
+};
+
+
+#endif /* WALL_LAYER_H_ */
@@ -17,21 +17,321 @@
  */
 
 #include "graphics/graphics.h"
+#include "graphics/quality.h"
 #include "logic/logic.h"
+#include "logic/tick_workers.h"
+#include "tools/tools.h"
 #include "workflow.h"
 
-int main() {
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+
+
+using Tool = std::function<int(void)>;
+
+void print_usage(const char *program) {
+	std::cerr
+			<< "Usage: " << program << " [options]\n"
+			<< "  --vsync             synchronize frames with display (default)\n"
+			<< "  --uncapped          render frames as fast as possible\n"
+			<< "  --fps N             limit frame rate to N without vsync\n"
+			<< "  --late-input        poll input right before simulation\n"
+			<< "  --report-latency    print frame and input latency statistics\n"
+			<< "  --report-stats      print game simulation counters periodically\n"
+			<< "  --no-render-thread  submit GL commands from the main thread\n"
+			<< "  --no-layer-cache    redraw menus every frame instead of caching them\n"
+			<< "  --sdf-shapes        draw circles and rounded rectangles with shaders\n"
+			<< "  --zoom X            show the level X times closer, following the play\n"
+			<< "  --quality N         keep quality level N (0 is best) instead of adapting\n"
+			<< "  --time-scale X      run games X times faster than real time\n"
+			<< "  --tick-threads N    split ticks of large games over N threads\n"
+			<< "  --autoplay          let a bot play the game\n"
+			<< "  --resume FILE       start from the game saved in FILE\n"
+			<< "  --autosave FILE     save the game into FILE periodically\n"
+			<< "  --wall N            show N bot-played games at once\n"
+			<< "  --offscreen WxH     render offscreen at the given resolution\n"
+			<< "  --golden-record DIR render reference images into DIR\n"
+			<< "  --golden-check DIR  compare rendering against images in DIR\n"
+			<< "  --bench-render N    measure offscreen rendering of N frames\n"
+			<< "  --bench-motion N    measure motion kernels on N bodies\n"
+			<< "  --bench-tick N      measure parallel ticks of N balls\n"
+			<< "  --simulate SECONDS  let a bot play headless for SECONDS of game time\n"
+			<< "  --check-allocations TICKS\n"
+			<< "                      check that TICKS ticks do not allocate\n"
+			<< "  --check-determinism TICKS\n"
+			<< "                      check that TICKS ticks replay identically\n"
+			<< "  --hash-trace FILE   compare state hashes with FILE, or record them\n"
+			<< "  --stress-physics N  find the largest safe time step over N trials"
+			<< std::endl;
+}
+
+/*
+ * Parse the whole argument as a number; false if anything else is left.
+ */
+bool parse_number(const char *arg, double& result) {
+	char *end;
+	errno = 0;
+	result = std::strtod(arg, &end);
+	return end != arg && *end == '\0' && errno == 0 && std::isfinite(result);
+}
+
+bool parse_number(const char *arg, long& result) {
+	char *end;
+	errno = 0;
+	result = std::strtol(arg, &end, 10);
+	return end != arg && *end == '\0' && errno == 0;
+}
+
+bool parse_number(const char *arg, unsigned int& result) {
+	long value;
+	if (!parse_number(arg, value) || value < 0 || value > UINT_MAX) {
+		return false;
+	}
+
+	result = value;
+	return true;
+}
+
+bool parse_arguments(
+		int argc, char *argv[],
+		Tool& tool, bool& headless, std::string& resume,
+		unsigned int& wall_games, std::string& hash_trace
+) {
+	PacingSettings pacing;
+	bool offscreen = false;
+	bool fixed_quality = false;
+	int width = 800, height = 600;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool has_value = i + 1 < argc;
+
+		if (arg == "--vsync") {
+			pacing.mode = VSYNC;
+		} else if (arg == "--uncapped") {
+			pacing.mode = UNCAPPED;
+		} else if (arg == "--fps" && has_value) {
+			pacing.mode = LIMITED;
+			if (!parse_number(argv[++i], pacing.target_fps)
+					|| pacing.target_fps <= 0) {
+				std::cerr << "Invalid frame rate " << argv[i] << std::endl;
+				return false;
+			}
+		} else if (arg == "--late-input") {
+			pacing.late_input = true;
+		} else if (arg == "--report-latency") {
+			pacing.report_latency = true;
+		} else if (arg == "--report-stats") {
+			set_stats_reporting(true);
+		} else if (arg == "--no-render-thread") {
+			set_render_thread_enabled(false);
+		} else if (arg == "--no-layer-cache") {
+			set_layer_caching_enabled(false);
+		} else if (arg == "--sdf-shapes") {
+			set_sdf_shapes_enabled(true);
+		} else if (arg == "--zoom" && has_value) {
+			double zoom;
+			if (!parse_number(argv[++i], zoom) || zoom < 1) {
+				std::cerr << "Invalid zoom " << argv[i] << std::endl;
+				return false;
+			}
+			set_camera_zoom(zoom);
+		} else if (arg == "--quality" && has_value) {
+			long level;
+			if (!parse_number(argv[++i], level) || level < 0) {
+				std::cerr << "Invalid quality level " << argv[i] << std::endl;
+				return false;
+			}
+			set_quality_level(level);
+			fixed_quality = true;
+		} else if (arg == "--time-scale" && has_value) {
+			double time_scale;
+			if (!parse_number(argv[++i], time_scale) || time_scale < 0) {
+				std::cerr << "Invalid time scale " << argv[i] << std::endl;
+				return false;
+			}
+			set_default_time_scale(time_scale);
+		} else if (arg == "--tick-threads" && has_value) {
+			long threads;
+			if (!parse_number(argv[++i], threads) || threads < 1) {
+				std::cerr << "Invalid number of threads " << argv[i] << std::endl;
+				return false;
+			}
+			set_tick_threads(threads);
+		} else if (arg == "--autoplay") {
+			set_autoplay(true);
+		} else if (arg == "--resume" && has_value) {
+			resume = argv[++i];
+		} else if (arg == "--autosave" && has_value) {
+			set_autosave_file(argv[++i]);
+		} else if (arg == "--wall" && has_value) {
+			long games;
+			if (!parse_number(argv[++i], games) || games < 1) {
+				std::cerr << "Invalid number of games " << argv[i] << std::endl;
+				return false;
+			}
+			wall_games = games;
+		} else if (arg == "--offscreen" && has_value) {
+			offscreen = true;
+			if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2
+					|| width <= 0 || height <= 0) {
+				std::cerr << "Invalid resolution " << argv[i] << std::endl;
+				return false;
+			}
+		} else if (arg == "--golden-record" && has_value) {
+			std::string directory = argv[++i];
+			offscreen = true;
+			tool = [directory](void) {
+				return record_golden_images(directory);
+			};
+		} else if (arg == "--golden-check" && has_value) {
+			std::string directory = argv[++i];
+			offscreen = true;
+			tool = [directory](void) {
+				return check_golden_images(directory);
+			};
+		} else if (arg == "--bench-render" && has_value) {
+			unsigned int frames;
+			if (!parse_number(argv[++i], frames) || frames == 0) {
+				std::cerr << "Invalid number of frames " << argv[i] << std::endl;
+				return false;
+			}
+			offscreen = true;
+			tool = [frames, &resume, &wall_games](void) {
+				return benchmark_rendering(frames, resume, wall_games);
+			};
+		} else if (arg == "--bench-motion" && has_value) {
+			long bodies;
+			if (!parse_number(argv[++i], bodies) || bodies < 1) {
+				std::cerr << "Invalid number of bodies " << argv[i] << std::endl;
+				return false;
+			}
+			headless = true;
+			tool = [bodies](void) {
+				return benchmark_motion(bodies);
+			};
+		} else if (arg == "--bench-tick" && has_value) {
+			long balls;
+			if (!parse_number(argv[++i], balls) || balls < 1) {
+				std::cerr << "Invalid number of balls " << argv[i] << std::endl;
+				return false;
+			}
+			headless = true;
+			tool = [balls](void) {
+				return benchmark_tick(balls);
+			};
+		} else if (arg == "--simulate" && has_value) {
+			double seconds;
+			if (!parse_number(argv[++i], seconds) || seconds <= 0) {
+				std::cerr << "Invalid duration " << argv[i] << std::endl;
+				return false;
+			}
+			headless = true;
+			tool = [seconds, &resume](void) {
+				return simulate_gameplay(seconds, resume);
+			};
+		} else if (arg == "--check-allocations" && has_value) {
+			unsigned int ticks;
+			if (!parse_number(argv[++i], ticks) || ticks == 0) {
+				std::cerr << "Invalid number of ticks " << argv[i] << std::endl;
+				return false;
+			}
+			headless = true;
+			tool = [ticks](void) {
+				return check_allocations(ticks);
+			};
+		} else if (arg == "--check-determinism" && has_value) {
+			unsigned int ticks;
+			if (!parse_number(argv[++i], ticks) || ticks == 0) {
+				std::cerr << "Invalid number of ticks " << argv[i] << std::endl;
+				return false;
+			}
+			headless = true;
+			tool = [ticks, &hash_trace](void) {
+				return check_determinism(ticks, hash_trace);
+			};
+		} else if (arg == "--stress-physics" && has_value) {
+			unsigned int trials;
+			if (!parse_number(argv[++i], trials) || trials == 0) {
+				std::cerr << "Invalid number of trials " << argv[i] << std::endl;
+				return false;
+			}
+			headless = true;
+			tool = [trials](void) {
+				return stress_physics(trials);
+			};
+		} else if (arg == "--hash-trace" && has_value) {
+			hash_trace = argv[++i];
+		} else {
+			std::cerr << "Unknown option " << arg << std::endl;
+			print_usage(argv[0]);
+			return false;
+		}
+	}
+
+	if (offscreen) {
+		if (tool == nullptr) {
+			std::cerr << "--offscreen requires a tool to run" << std::endl;
+			return false;
+		}
+
+		set_offscreen_mode(width, height);
+	}
+
+	// Tools measure or compare rendering at a known quality
+	if (tool == nullptr && !fixed_quality) {
+		set_quality_governor(true);
+	}
+
+	set_pacing(pacing);
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	Tool tool = nullptr;
+	bool headless = false;
+	std::string resume;
+	unsigned int wall_games = 0;
+	std::string hash_trace;
+
+	if (!parse_arguments(
+			argc, argv, tool, headless, resume, wall_games, hash_trace
+	)) {
+		return 1;
+	}
+
 	setup_random();
 	setup_logic();
-	setup_graphics();
 
-	show_main_menu();
+	int result = 0;
+
+	if (headless) {
+		result = tool();
+	} else {
+		if (setup_graphics()) {
+			if (tool != nullptr) {
+				result = tool();
+			} else {
+				if (wall_games != 0) {
+					show_wall(wall_games);
+				} else if (resume.empty() || resume_game(resume) == nullptr) {
+					show_main_menu();
+				}
+				main_loop();
+			}
+		} else {
+			result = 1;
+		}
 
-	main_loop();
+		terminate_graphics();
+	}
 
-	terminate_graphics();
 	terminate_logic();
 	terminate_random();
 
-	return 0;
+	return result;
 }
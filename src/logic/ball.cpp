@@ -19,6 +19,7 @@
 #include "ball.h"
 
 #include "logic.h"
+#include "snapshot.h"
 
 
 const Velocity BALL_ACCELERATION_PER_SECOND_PER_UNIT_MASS = 0.2f;
@@ -40,9 +41,9 @@ void Ball::accelerate(Velocity delta) {
 	velocity_vector.y += delta * velocity_vector.y / velocity;
 }
 
-const float SPHERE_VOLUME_COEFF = 4 * PI / 3;
+const LevelCoord SPHERE_VOLUME_COEFF = 4 * PI / 3;
 // Make sure that the ball masses 1 by default
-const float BALL_DENSITY =
+const LevelCoord BALL_DENSITY =
 		1.0f /
 		(SPHERE_VOLUME_COEFF *
 		DEFAULT_BALL_RADIUS * DEFAULT_BALL_RADIUS * DEFAULT_BALL_RADIUS);
@@ -52,7 +53,8 @@ Ball::Mass Ball::calculate_mass(LevelCoord radius) const {
 }
 
 LevelCoord Ball::calculate_radius(Mass mass) const {
-	return cbrtf(mass / BALL_DENSITY / SPHERE_VOLUME_COEFF);
+	using std::cbrt;
+	return cbrt(mass / BALL_DENSITY / SPHERE_VOLUME_COEFF);
 }
 
 Ball::Mass Ball::get_mass() const {
@@ -85,8 +87,7 @@ void Ball::set_mass_animated(Ball::Mass new_mass) {
 
 
 void Ball::tick(Game& game, Time frame_length) {
-	if (tick_held(game, frame_length)) return;
-	tick_radius(game, frame_length);
+	if (!prepare_tick(game, frame_length)) return;
 
 	Collideable::tick(game, frame_length);
 
@@ -95,9 +96,35 @@ void Ball::tick(Game& game, Time frame_length) {
 			frame_length / get_mass()
 	);
 
+	finish_tick(game, frame_length);
+}
+
+bool Ball::prepare_tick(Game& game, Time frame_length) {
+	if (tick_held(game, frame_length)) return false;
+	tick_radius(game, frame_length);
+	return true;
+}
+
+void Ball::finish_tick(Game& game, Time frame_length) {
 	tick_invincibility(game, frame_length);
 }
 
+void Ball::handle_motion_hits(Game& game, unsigned char hits) {
+	if (hits & HIT_BOUNDS) {
+		check_collisions(game);
+	} else if (hits & NEAR_BRICKS) {
+		collide_with_level(game);
+	}
+}
+
+void accelerate_balls(MotionStore& store, Time frame_length) {
+	accelerate_motion(
+			store, frame_length,
+			BALL_ACCELERATION_PER_SECOND_PER_UNIT_MASS,
+			BALL_DENSITY * SPHERE_VOLUME_COEFF
+	);
+}
+
 bool Ball::tick_held(Game& game, Time) {
 	if (is_held) {
 		position.x = force_in_range(
@@ -124,7 +151,7 @@ void Ball::tick_radius(Game&, Time frame_length) {
 						: -BALL_RADIUS_CHANGE_SPEED)
 				* frame_length;
 
-		float ratio = old_mass / get_mass();
+		LevelCoord ratio = old_mass / get_mass();
 
 		set_velocity(
 				get_velocity_x() * ratio,
@@ -153,18 +180,26 @@ void Ball::check_collisions(Game& game) {
 	collide_with_level(game);
 }
 
-void Ball::collide_with_level(Game& game) {
-	LevelBlock min =
-	{
-			static_cast<LevelBlockCoord>(floorf(position.x - radius)),
-			static_cast<LevelBlockCoord>(floorf(position.y - radius)),
+void get_blocks_around(
+		LevelPoint position, LevelCoord radius,
+		LevelBlock& min, LevelBlock& max
+) {
+	using std::floor;
+
+	min = {
+			static_cast<LevelBlockCoord>(floor(position.x - radius)),
+			static_cast<LevelBlockCoord>(floor(position.y - radius)),
 	};
 
-	LevelBlock max =
-	{
-		static_cast<LevelBlockCoord>(floorf(position.x + radius)),
-		static_cast<LevelBlockCoord>(floorf(position.y + radius)),
+	max = {
+			static_cast<LevelBlockCoord>(floor(position.x + radius)),
+			static_cast<LevelBlockCoord>(floor(position.y + radius)),
 	};
+}
+
+void Ball::collide_with_level(Game& game) {
+	LevelBlock min, max;
+	get_blocks_around(position, radius, min, max);
 
 	for (LevelBlockCoord x = min.x; x <= max.x; ++x) {
 		for (LevelBlock block = {x, min.y}; block.y <= max.y; ++block.y) {
@@ -173,8 +208,8 @@ void Ball::collide_with_level(Game& game) {
 	}
 }
 
-void Ball::create_collision_sprite(Game& game) {
-	game.add_sprite(new CollisionSprite(position));
+void Ball::emit_hit(Game& game, GameEventType type) {
+	game.events.emit(GameEvent(type, position));
 }
 
 void Ball::on_collide_with_platform(Game& game) {
@@ -188,27 +223,31 @@ void Ball::on_collide_with_platform(Game& game) {
 
 	set_velocity(vx, sqrt(sqr(velocity) - sqr(vx)));
 	game.platform.bounce(*this);
-	create_collision_sprite(game);
+	emit_hit(game, PLATFORM_HIT);
 }
 
 void Ball::on_collide_with_level_wall(Game& game) {
 	Collideable::on_collide_with_level_wall(game);
-	create_collision_sprite(game);
+	emit_hit(game, WALL_HIT);
 }
 
 void Ball::on_collide_with_level_ceiling(Game& game) {
 	Collideable::on_collide_with_level_ceiling(game);
-	create_collision_sprite(game);
+	emit_hit(game, WALL_HIT);
 }
 
 void Ball::on_collide_with_level_floor(Game& game) {
 	if (is_invincible()) {
 		bounce_y(true, radius);
-		create_collision_sprite(game);
+		emit_hit(game, WALL_HIT);
 		return;
 	}
 
-	game.add_sprite(new FloorCollisionSprite(*this));
+	GameEvent event(BALL_LOST, position);
+	event.velocity = {+get_velocity_x(), +get_velocity_y()};
+	event.radius = radius;
+	game.events.emit(event);
+
 	die();
 }
 
@@ -233,3 +272,17 @@ void Ball::release() {
 void Ball::add_invincibility(Time time) {
 	invinciblity += time;
 }
+
+void Ball::save(SnapshotWriter& writer) const {
+	Collideable::save(writer);
+	writer.write(is_held);
+	writer.write(invinciblity);
+	writer.write(desired_radius);
+}
+
+void Ball::load(SnapshotReader& reader) {
+	Collideable::load(reader);
+	is_held = reader.read<bool>();
+	invinciblity = reader.read<Time>();
+	desired_radius = reader.read<LevelCoord>();
+}
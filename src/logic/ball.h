@@ -21,6 +21,7 @@
 
 #include "../common.h"
 #include "collideable.h"
+#include "events.h"
 
 
 const Velocity DEFAULT_BALL_VELOCITY = 10.0f;
@@ -59,9 +60,21 @@ public:
 			VelocityVector velocity = {0, DEFAULT_BALL_VELOCITY}
 	);
 
-	virtual void render() override;
+	virtual void render(Timestamp now) override;
 	virtual void tick(Game&, Time frame_length) override;
 
+	/*
+	 * The parts of tick() around the move for batched simulation.
+	 * prepare_tick() returns false if the ball does not move this tick.
+	 */
+	bool prepare_tick(Game&, Time frame_length);
+	void finish_tick(Game&, Time frame_length);
+
+	virtual void handle_motion_hits(Game&, unsigned char hits) override;
+
+	virtual void save(SnapshotWriter&) const override;
+	virtual void load(SnapshotReader&) override;
+
 	void accelerate(Velocity delta);
 
 	Mass get_mass() const;
@@ -80,12 +93,29 @@ public:
 
 	void add_invincibility(Time time);
 
-	virtual void create_collision_sprite(Game&);
+	/*
+	 * Emits an event of a bounce of this ball at its position.
+	 */
+	void emit_hit(Game&, GameEventType);
 
 	bool get_is_held() const { return is_held; }
 	void hold();
 	void release();
 };
 
+/*
+ * Finds the blocks a ball at the position is checked against, see
+ * Ball::collide_with_level().
+ */
+void get_blocks_around(
+		LevelPoint position, LevelCoord radius,
+		LevelBlock& min, LevelBlock& max
+);
+
+/*
+ * Applies the acceleration of Ball::tick() to a batch of moving balls.
+ */
+void accelerate_balls(MotionStore&, Time frame_length);
+
 
 #endif /* BALL_H_ */
@@ -19,7 +19,10 @@
 
 #include "bonus.h"
 
+#include <list>
+
 #include "logic.h"
+#include "snapshot.h"
 
 
 /*
@@ -50,14 +53,28 @@ void Bonus::tick(Game& game, Time frame_length) {
 	);
 }
 
+void accelerate_bonuses(MotionStore& store, Time frame_length) {
+	apply_gravity(store, frame_length, BONUS_ACCELERATION_PER_SECOND);
+}
+
+void Bonus::emit(Game& game, GameEventType type) {
+	GameEvent event(type, position);
+	event.velocity = {+get_velocity_x(), +get_velocity_y()};
+	event.good = good;
+	game.events.emit(event);
+}
+
 void Bonus::on_collide_with_platform(Game& game) {
+	game.stats.bonuses_caught++;
+
+	// The effect is part of the simulation, the event is for the rest
 	apply(game);
-	game.add_sprite(new BonusCollectedSprite(*this));
+	emit(game, BONUS_CAUGHT);
 	die();
 }
 
 void Bonus::on_collide_with_level_floor(Game& game) {
-	game.add_sprite(new BonusFloorCollisionSprite(*this));
+	emit(game, BONUS_LOST);
 	die();
 }
 
@@ -68,14 +85,14 @@ void Bonus::on_collide_with_level_floor(Game& game) {
 SimpleBonus::SimpleBonus(
 		LevelPoint position, VelocityVector velocity,
 		Color color, bool good,
-		GameAction action
+		const GameAction *action
 ) :
 		Bonus(position, velocity, color, good),
 		action(action)
 {}
 
 void SimpleBonus::apply(Game& game) {
-	action(game);
+	(*action)(game);
 }
 
 /*
@@ -95,13 +112,19 @@ void register_bonus_type(BonusCreator creator, float weight) {
 	bonus_registry_total_weight += weight;
 }
 
+// Actions of simple bonuses, shared by all bonuses of a type
+std::list<SimpleBonus::GameAction> simple_bonus_actions;
+
 void register_simple_bonus_type(
 		Color color, bool good, SimpleBonus::GameAction action,
 		float weight
 ) {
+	simple_bonus_actions.push_back(action);
+	const SimpleBonus::GameAction *stored = &simple_bonus_actions.back();
+
 	register_bonus_type(
-			[color, good, action](LevelPoint pos, VelocityVector vel) {
-					return new SimpleBonus(pos, vel, color, good, action);
+			[color, good, stored](LevelPoint pos, VelocityVector vel) {
+					return new SimpleBonus(pos, vel, color, good, stored);
 			},
 			weight
 	);
@@ -125,15 +148,39 @@ Bonus* create_random_bonus(LevelPoint pos) {
 		itr++;
 	}
 
-	BonusCreator creator =
-			(itr != bonus_registry.cend())
-					? itr->creator
-					: bonus_registry.back().creator;
+	if (itr == bonus_registry.cend()) {
+		itr--;
+	}
+
+	using std::sin;
+	using std::cos;
 
-	float angle = generate_random_float() * PI/2 - PI/4;
+	LevelCoord angle = generate_random_float() * PI/2 - PI/4;
 
-	return creator(pos, {
-			BONUS_VELOCITY * sinf(angle),
-			BONUS_VELOCITY * cosf(angle)
+	Bonus *bonus = itr->creator(pos, {
+			BONUS_VELOCITY * sin(angle),
+			BONUS_VELOCITY * cos(angle)
 	});
+
+	bonus->registry_index = itr - bonus_registry.cbegin();
+	return bonus;
+}
+
+void Bonus::save(SnapshotWriter& writer) const {
+	writer.write(registry_index);
+	Collideable::save(writer);
+}
+
+Bonus* load_bonus(SnapshotReader& reader) {
+	unsigned int index = reader.read<unsigned int>();
+
+	if (index >= bonus_registry.size()) {
+		reader.fail();
+		return nullptr;
+	}
+
+	Bonus *bonus = bonus_registry[index].creator({0, 0}, {0, 0});
+	bonus->registry_index = index;
+	bonus->load(reader);
+	return bonus;
 }
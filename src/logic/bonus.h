@@ -21,6 +21,7 @@
 
 #include "../common.h"
 #include "collideable.h"
+#include "events.h"
 #include "../graphics/design.h"
 
 
@@ -31,6 +32,14 @@ private:
 	Color color;
 	bool good;
 
+	// Index in the bonus registry, see create_random_bonus()
+	unsigned int registry_index = 0;
+
+	friend Bonus* create_random_bonus(LevelPoint);
+	friend Bonus* load_bonus(SnapshotReader&);
+
+	void emit(Game&, GameEventType);
+
 protected:
 	virtual void apply(Game&) = 0;
 
@@ -41,7 +50,7 @@ public:
 	Bonus(LevelPoint, VelocityVector, Color, bool good);
 	virtual ~Bonus() {}
 
-	virtual void render() override;
+	virtual void render(Timestamp now) override;
 	virtual void tick(Game&, Time frame_length) override;
 
 	Color get_color() {
@@ -51,6 +60,11 @@ public:
 	bool is_good() {
 		return good;
 	}
+
+	/*
+	 * Writes the kind and the state of the bonus, see load_bonus().
+	 */
+	virtual void save(SnapshotWriter&) const override;
 };
 
 class SimpleBonus : public Bonus {
@@ -58,13 +72,19 @@ public:
 	using GameAction = std::function<void(Game&)>;
 
 private:
-	GameAction action;
+	const GameAction *action;
 
 protected:
 	virtual void apply(Game&) override;
 
 public:
-	SimpleBonus(LevelPoint, VelocityVector, Color, bool good, GameAction);
+	/*
+	 * The action is not copied and must outlive the bonus.
+	 */
+	SimpleBonus(
+			LevelPoint, VelocityVector, Color, bool good,
+			const GameAction*
+	);
 	virtual ~SimpleBonus() {}
 
 };
@@ -78,5 +98,15 @@ void register_simple_bonus_type(
 
 Bonus* create_random_bonus(LevelPoint pos);
 
+/*
+ * Recreates a bonus written by Bonus::save(). Returns nullptr on failure.
+ */
+Bonus* load_bonus(SnapshotReader&);
+
+/*
+ * Applies the gravity of Bonus::tick() to a batch of bonuses.
+ */
+void accelerate_bonuses(MotionStore&, Time frame_length);
+
 
 #endif /* BONUS_H_ */
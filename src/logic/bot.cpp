@@ -0,0 +1,255 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "bot.h"
+
+#include "logic.h"
+
+#include <limits>
+
+
+const unsigned int MAX_PREDICTION_STEPS = 256;
+const Time MAX_PREDICTION_TIME = 10.0f;
+
+const Time NEVER = std::numeric_limits<Time>::infinity();
+
+// Grid lines closer than this to the leading edge count as already crossed
+const LevelCoord GRID_LINE_EPSILON = 1e-4f;
+
+/*
+ * Time until the leading edge of the ball crosses the next grid line.
+ */
+Time time_to_grid_line(LevelCoord center, LevelCoord radius, Velocity v) {
+	using std::floor;
+	using std::ceil;
+
+	if (v > 0) {
+		LevelCoord edge = center + radius;
+		return (floor(edge + GRID_LINE_EPSILON) + 1 - edge) / v;
+	}
+
+	if (v < 0) {
+		LevelCoord edge = center - radius;
+		return (ceil(edge - GRID_LINE_EPSILON) - 1 - edge) / v;
+	}
+
+	return NEVER;
+}
+
+/*
+ * The cell the leading edge of the ball enters when it is on a grid line.
+ */
+LevelBlockCoord get_entered_cell(
+		LevelCoord center, LevelCoord radius, Velocity v
+) {
+	using std::floor;
+
+	return static_cast<LevelBlockCoord>(floor(
+			v > 0
+					? center + radius + 0.5f
+					: center - radius - 0.5f
+	));
+}
+
+/*
+ * Time until the center reaches whichever of the borders it moves towards.
+ */
+Time time_to_border(
+		LevelCoord center, LevelCoord min, LevelCoord max, Velocity v
+) {
+	if (v == 0) {
+		return NEVER;
+	}
+
+	Time result = ((v > 0 ? max : min) - center) / v;
+	return result > 0 ? result : 0;
+}
+
+BallPrediction predict_landing(Game& game, Ball& ball) {
+	const Level& level = *(game.level);
+	const LevelCoord r = ball.get_radius();
+
+	const LevelCoord landing_y = PLATFORM_HEIGHT + r;
+
+	LevelPoint pos = ball.get_position();
+	VelocityVector v = {ball.get_velocity_x(), ball.get_velocity_y()};
+	Time time = 0;
+
+	if (ball.get_is_held() || pos.y < landing_y) {
+		return {false, 0, pos.x};
+	}
+
+	for (unsigned int step = 0; step < MAX_PREDICTION_STEPS; ++step) {
+		const Time to_wall =
+				time_to_border(pos.x, r, level.get_width() - r, v.x);
+		const Time to_ceiling_or_platform =
+				time_to_border(pos.y, landing_y, level.get_height() - r, v.y);
+
+		const Time to_column = time_to_grid_line(pos.x, r, v.x);
+		const Time to_row = time_to_grid_line(pos.y, r, v.y);
+
+		const Time dt = std::min(
+				std::min(to_wall, to_ceiling_or_platform),
+				std::min(to_column, to_row)
+		);
+
+		if (dt == NEVER) {
+			break;
+		}
+
+		pos += v * dt;
+		time += dt;
+
+		if (time > MAX_PREDICTION_TIME) {
+			break;
+		}
+
+		bool bounced = false;
+
+		if (dt == to_ceiling_or_platform) {
+			if (v.y < 0) {
+				return {true, time, pos.x};
+			}
+
+			v.y *= -1;
+			bounced = true;
+		}
+
+		if (dt == to_wall) {
+			v.x *= -1;
+			bounced = true;
+		}
+
+		if (bounced) {
+			continue;
+		}
+
+		// Bricks reflect the ball like walls
+		if (dt == to_column) {
+			LevelBlock block = {
+					get_entered_cell(pos.x, r, v.x),
+					static_cast<LevelBlockCoord>(floorf(pos.y))
+			};
+
+			if (level.get_brick(block) != nullptr) {
+				v.x *= -1;
+			}
+		} else {
+			LevelBlock block = {
+					static_cast<LevelBlockCoord>(floorf(pos.x)),
+					get_entered_cell(pos.y, r, v.y)
+			};
+
+			if (level.get_brick(block) != nullptr) {
+				v.y *= -1;
+			}
+		}
+	}
+
+	return {false, time, pos.x};
+}
+
+/*
+ * Bot
+ */
+
+// How far the platform may be from its target before it moves
+const LevelCoord STEERING_TOLERANCE = 0.1f;
+
+// Part of the platform half-width used to aim the ball at bricks
+const LevelCoord AIMING_FACTOR = 0.5f;
+
+LevelCoord Bot::find_bricks_center(Game& game) const {
+	const Level& level = *(game.level);
+
+	LevelCoord sum = 0;
+	unsigned int count = 0;
+
+	for (LevelBlockCoord x = 0; x < level.get_width(); ++x) {
+		for (
+				LevelBlock block = {x, level.get_height() - level.get_field_height()};
+				block.y < level.get_height();
+				++block.y
+		) {
+			if (level.get_brick(block) != nullptr) {
+				sum += x + 0.5f;
+				count++;
+			}
+		}
+	}
+
+	return count == 0 ? LevelCoord(level.get_width()) / 2 : sum / count;
+}
+
+LevelCoord Bot::choose_target(Game& game) {
+	Ball *lowest = nullptr;
+	BallPrediction first = {false, 0, 0};
+
+	for (Ball *ball : game.get_balls()) {
+		if (ball->get_is_held()) {
+			continue;
+		}
+
+		BallPrediction prediction = predict_landing(game, *ball);
+
+		if (prediction.lands && (!first.lands || prediction.time < first.time)) {
+			first = prediction;
+		}
+
+		if (lowest == nullptr
+				|| ball->get_position().y < lowest->get_position().y) {
+			lowest = ball;
+		}
+	}
+
+	if (!first.lands) {
+		return lowest != nullptr
+				? lowest->get_position().x
+				: game.platform.get_position();
+	}
+
+	// Hitting the ball off-centre sends it towards the bricks
+	const LevelCoord half_size = game.platform.get_size() / 2;
+	const LevelCoord bricks = find_bricks_center(game);
+	const LevelCoord aim = force_in_range<LevelCoord>(
+			-1,
+			(bricks - first.x) / (half_size * 2),
+			1
+	);
+
+	return first.x - aim * half_size * AIMING_FACTOR;
+}
+
+void Bot::steer(Game& game, LevelCoord target) {
+	const LevelCoord distance =
+			target - game.platform.get_desired_position();
+	using std::abs;
+
+	const bool is_fast = abs(distance) > game.platform.get_size() / 2;
+
+	game.platform.set_movement(true, distance < -STEERING_TOLERANCE, is_fast);
+	game.platform.set_movement(false, distance > STEERING_TOLERANCE, is_fast);
+}
+
+void Bot::control(Game& game) {
+	for (Ball *ball : game.get_balls()) {
+		ball->release();
+	}
+
+	steer(game, choose_target(game));
+}
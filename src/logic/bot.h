@@ -0,0 +1,63 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BOT_H_
+#define BOT_H_
+
+#include "../common.h"
+
+
+/*
+ * Where and when a ball is expected to reach the platform.
+ */
+struct BallPrediction {
+	// False if the ball does not come down within the prediction horizon
+	bool lands;
+
+	Time time;
+	LevelCoord x;
+};
+
+/*
+ * Follows the path of the ball through walls, the ceiling and bricks until it
+ * comes down to the platform. The path is marched from one grid line to the
+ * next; bricks are treated as walls and acceleration is ignored.
+ */
+BallPrediction predict_landing(Game&, Ball&);
+
+/*
+ * Plays the game by steering the platform towards the ball that lands first.
+ */
+class Bot {
+private:
+	// Where the bricks are, on average
+	LevelCoord find_bricks_center(Game&) const;
+
+	LevelCoord choose_target(Game&);
+	void steer(Game&, LevelCoord target);
+
+public:
+	/*
+	 * Releases held balls and sets the platform movement. Called before every
+	 * simulation step.
+	 */
+	void control(Game&);
+};
+
+
+#endif /* BOT_H_ */
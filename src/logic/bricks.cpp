@@ -19,31 +19,21 @@
 #include "bricks.h"
 
 #include "logic.h"
+#include "snapshot.h"
 
 
 void Brick::destroy(Game& game, LevelBlock pos) {
-	game.level->destroy_brick(pos);
-	do_destroy(game, pos);
-	get_current_attempt()->increase_score(get_reward());
-
-	Bonus *bonus = create_random_bonus(static_cast<LevelPoint>(pos));
-	if (bonus != nullptr) {
-		game.add_bonus(bonus);
-	}
+	game.level->destroy_chain(game, pos);
 }
 
-void Brick::do_destroy(Game& game, LevelBlock pos) {
-	game.add_sprite(new BrickBrokenSprite(
-			pos.add(0.5f, 0.5f), false
-	));
-}
+void Brick::do_destroy(Game&, LevelBlock) {}
 
 bool Brick::on_collision(Game& game, LevelBlock pos, Ball&) {
 	destroy(game, pos);
 	return true;
 }
 
-const float HEALTH_DECREASE_PER_UNIT_IMPULSE =
+const LevelCoord HEALTH_DECREASE_PER_UNIT_IMPULSE =
 		0.75f // default descrease
 		/
 		(1.0f * DEFAULT_BALL_VELOCITY); // default impulse
@@ -60,29 +50,10 @@ bool SturdyBrick::on_collision(Game& game, LevelBlock pos, Ball& ball) {
 	return true;
 }
 
-void ExplosiveBrick::do_destroy(Game& game, LevelBlock pos) {
-	for (LevelBlockCoord x = pos.x - 1; x <= pos.x + 1; ++x) {
-		for (LevelBlock block = {x, pos.y - 1}; block.y <= pos.y + 1; ++block.y) {
-			Brick* brick = game.level->get_brick(block);
-			if (brick != nullptr) {
-				brick->destroy(game, block);
-			}
-		}
-	}
-
-	game.add_sprite(new BrickExplosionSprite({
-		pos.add(0.5f, 0.5f)
-	}));
-}
-
 void ExtraBallBrick::do_destroy(Game& game, LevelBlock pos) {
-	game.add_sprite(new BrickBrokenSprite(
-			pos.add(0.5f, 0.5f), false
-	));
-
 	Ball *ball = new Ball(pos.add(0.5f, 0.5f));
 
-	float angle = generate_random_float() * 2*PI;
+	LevelCoord angle = generate_random_float() * 2*PI;
 	ball->set_velocity(
 			ball->get_velocity() * sin(angle),
 			ball->get_velocity() * cos(angle)
@@ -90,3 +61,55 @@ void ExtraBallBrick::do_destroy(Game& game, LevelBlock pos) {
 
 	game.add_ball(ball);
 }
+
+/*
+ * Snapshots
+ */
+
+void Brick::save(SnapshotWriter& writer) const {
+	save_simulated(writer);
+}
+
+void Brick::save_simulated(SnapshotWriter& writer) const {
+	writer.write(get_type());
+	writer.write(needs_destruction);
+}
+
+void Brick::load(SnapshotReader& reader) {
+	needs_destruction = reader.read<bool>();
+}
+
+void SturdyBrick::save(SnapshotWriter& writer) const {
+	save_simulated(writer);
+	writer.write(display_health);
+}
+
+void SturdyBrick::save_simulated(SnapshotWriter& writer) const {
+	Brick::save_simulated(writer);
+	writer.write(max_health);
+	writer.write(health);
+}
+
+void SturdyBrick::load(SnapshotReader& reader) {
+	Brick::load(reader);
+	max_health = reader.read<Health>();
+	health = reader.read<Health>();
+	display_health = reader.read<Health>();
+}
+
+Brick* load_brick(SnapshotReader& reader) {
+	Brick *brick;
+
+	switch (reader.read<BrickType>()) {
+	case SIMPLE_BRICK:     brick = new SimpleBrick();    break;
+	case STURDY_BRICK:     brick = new SturdyBrick(0);   break;
+	case EXPLOSIVE_BRICK:  brick = new ExplosiveBrick(); break;
+	case EXTRA_BALL_BRICK: brick = new ExtraBallBrick(); break;
+	default:
+		reader.fail();
+		return nullptr;
+	}
+
+	brick->load(reader);
+	return brick;
+}
@@ -20,9 +20,16 @@
 #define BRICKS_H_
 
 #include "../common.h"
+#include "../arena.h"
 
 
-class Brick {
+enum BrickType : unsigned char {
+	SIMPLE_BRICK, STURDY_BRICK, EXPLOSIVE_BRICK, EXTRA_BALL_BRICK,
+
+	BRICK_TYPES
+};
+
+class Brick : public ArenaAllocated {
 private:
 	bool needs_destruction = true;
 
@@ -31,6 +38,13 @@ protected:
 		needs_destruction = false;
 	}
 
+	friend class Level;
+
+	/*
+	 * Applies the effects of this brick's destruction on the game, beyond the
+	 * BRICK_DESTROYED event. Called once per brick, after the whole chain has
+	 * been removed from the field.
+	 */
 	virtual void do_destroy(Game&, LevelBlock);
 
 public:
@@ -40,6 +54,9 @@ public:
 		return needs_destruction;
 	}
 
+	/*
+	 * Destroys this brick along with every brick its destruction takes down.
+	 */
 	void destroy(Game&, LevelBlock);
 
 	virtual bool on_collision(Game&, LevelBlock, Ball&);
@@ -47,18 +64,48 @@ public:
 	virtual Score get_reward() const {
 		return 1;
 	}
+
+	/*
+	 * The bricks at most this many blocks away are destroyed along with this
+	 * one.
+	 */
+	virtual LevelBlockCoord get_blast_radius() const {
+		return 0;
+	}
+
+	virtual BrickType get_type() const = 0;
+
+	/*
+	 * Writes the type and the state of the brick, see load_brick().
+	 */
+	virtual void save(SnapshotWriter&) const;
+	virtual void load(SnapshotReader&);
+
+	/*
+	 * Writes the part of the state that ticks depend on, leaving out what
+	 * only rendering animates. Hashed to fingerprint the level.
+	 */
+	virtual void save_simulated(SnapshotWriter&) const;
 };
 
+/*
+ * Recreates a brick written by Brick::save(). Returns nullptr on failure.
+ */
+Brick* load_brick(SnapshotReader&);
+
 class SimpleBrick : public Brick {
 public:
 	void render(Game&, LevelBlock) override;
+	virtual BrickType get_type() const override {
+		return SIMPLE_BRICK;
+	}
 };
 
 class SturdyBrick : public Brick {
 private:
 	using Health = LevelCoord;
 
-	const Health max_health;
+	Health max_health;
 	Health health;
 	Health display_health;
 public:
@@ -70,16 +117,27 @@ public:
 	virtual Score get_reward() const override {
 		return max_health;
 	}
+	virtual BrickType get_type() const override {
+		return STURDY_BRICK;
+	}
+
+	virtual void save(SnapshotWriter&) const override;
+	virtual void load(SnapshotReader&) override;
+	virtual void save_simulated(SnapshotWriter&) const override;
 };
 
 class ExplosiveBrick : public Brick {
-protected:
-	virtual void do_destroy(Game&, LevelBlock) override;
 public:
 	virtual void render(Game&, LevelBlock) override;
 	virtual Score get_reward() const override {
 		return 5;
 	}
+	virtual LevelBlockCoord get_blast_radius() const override {
+		return 1;
+	}
+	virtual BrickType get_type() const override {
+		return EXPLOSIVE_BRICK;
+	}
 };
 
 class ExtraBallBrick : public Brick {
@@ -90,6 +148,9 @@ public:
 	virtual Score get_reward() const override {
 		return 5;
 	}
+	virtual BrickType get_type() const override {
+		return EXTRA_BALL_BRICK;
+	}
 };
 
 
@@ -19,6 +19,7 @@
 #include "collideable.h"
 
 #include "logic.h"
+#include "snapshot.h"
 
 
 Collideable::Collideable(
@@ -95,6 +96,29 @@ void Collideable::tick(Game& game, Time frame_length) {
 	check_collisions(game);
 }
 
+void Collideable::store_motion(MotionStore& store, size_t index) const {
+	store.x[index] = position.x;
+	store.y[index] = position.y;
+	store.radius[index] = radius;
+	store.vx[index] = velocity_vector.x;
+	store.vy[index] = velocity_vector.y;
+	store.speed[index] = velocity;
+}
+
+void Collideable::load_motion(const MotionStore& store, size_t index) {
+	position.x = store.x[index];
+	position.y = store.y[index];
+	velocity_vector.x = store.vx[index];
+	velocity_vector.y = store.vy[index];
+	velocity = store.speed[index];
+}
+
+void Collideable::handle_motion_hits(Game& game, unsigned char hits) {
+	if (hits & HIT_BOUNDS) {
+		check_collisions(game);
+	}
+}
+
 void Collideable::check_collisions(Game& game) {
 	collide_with_platform(game);
 	collide_with_bounds(game);
@@ -145,3 +169,19 @@ void Collideable::on_collide_with_level_wall(Game& game) {
 void Collideable::die() {
 	dead = true;
 }
+
+void Collideable::save(SnapshotWriter& writer) const {
+	writer.write(position);
+	writer.write(radius);
+	writer.write(velocity);
+	writer.write(velocity_vector);
+	writer.write(dead);
+}
+
+void Collideable::load(SnapshotReader& reader) {
+	position = reader.read<LevelPoint>();
+	radius = reader.read<LevelCoord>();
+	velocity = reader.read<Velocity>();
+	velocity_vector = reader.read<VelocityVector>();
+	dead = reader.read<bool>();
+}
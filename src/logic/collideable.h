@@ -20,9 +20,11 @@
 #define COLLIDEABLE_H_
 
 #include "../common.h"
+#include "../arena.h"
+#include "motion.h"
 
 
-class Collideable {
+class Collideable : public ArenaAllocated {
 private:
 	void bounce(
 			Velocity& velocity,
@@ -61,7 +63,11 @@ public:
 		return position;
 	}
 
-	LevelCoord get_radius() {
+	const LevelPoint& get_position() const {
+		return position;
+	}
+
+	LevelCoord get_radius() const {
 		return radius;
 	}
 
@@ -69,7 +75,10 @@ public:
 		return dead;
 	}
 
-	virtual void render() = 0;
+	/*
+	 * Renders the object as of the given moment of game time.
+	 */
+	virtual void render(Timestamp now) = 0;
 	virtual void tick(Game&, Time frame_length);
 
 	Velocity get_velocity() const;
@@ -81,6 +90,22 @@ public:
 
 	void bounce_x(bool positive, LevelCoord border);
 	void bounce_y(bool positive, LevelCoord border);
+
+	/*
+	 * Copies the motion state to and from a batch, see motion.h.
+	 */
+	void store_motion(MotionStore&, size_t index) const;
+	void load_motion(const MotionStore&, size_t index);
+
+	/*
+	 * Handles the collisions of a batched move given the MotionHit flags
+	 * integrate_motion() reported. Equivalent to the collision checks of
+	 * tick().
+	 */
+	virtual void handle_motion_hits(Game&, unsigned char hits);
+
+	virtual void save(SnapshotWriter&) const;
+	virtual void load(SnapshotReader&);
 };
 
 
@@ -0,0 +1,105 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVENTS_H_
+#define EVENTS_H_
+
+#include "../common.h"
+#include "bricks.h"
+
+#include <vector>
+
+
+enum GameEventType : unsigned char {
+	// A ball bounced off a wall, the ceiling or, while invincible, the floor
+	WALL_HIT,
+	PLATFORM_HIT,
+	BRICK_HIT,
+
+	BRICK_DESTROYED,
+
+	BONUS_CAUGHT,
+	BONUS_LOST,
+
+	BALL_LOST
+};
+
+/*
+ * Something that happened in the simulation that may matter beyond it, such
+ * as to sprites or the score. Fields that do not apply to the type are left
+ * at their defaults.
+ */
+struct GameEvent {
+	GameEventType type;
+
+	// Of the ball or the bonus, or the center of the brick
+	LevelPoint position;
+
+	// Of the ball or the bonus when it was lost
+	VelocityVector velocity = {0, 0};
+
+	// Of the lost ball
+	LevelCoord radius = 0;
+
+	// Of the destroyed brick
+	BrickType brick = SIMPLE_BRICK;
+	Score reward = 0;
+
+	// Of the caught or lost bonus
+	bool good = false;
+
+	GameEvent(GameEventType type, LevelPoint position) :
+		type(type),
+		position(position)
+	{}
+};
+
+/*
+ * The events of a tick in the order they happened. Storage is kept between
+ * ticks so that emitting does not allocate once the buffer has grown.
+ */
+class EventBuffer {
+private:
+	std::vector<GameEvent> events;
+
+public:
+	EventBuffer();
+
+	void emit(const GameEvent& event) {
+		events.push_back(event);
+	}
+
+	void clear() {
+		events.clear();
+	}
+
+	size_t size() const {
+		return events.size();
+	}
+
+	std::vector<GameEvent>::const_iterator begin() const {
+		return events.cbegin();
+	}
+
+	std::vector<GameEvent>::const_iterator end() const {
+		return events.cend();
+	}
+};
+
+
+#endif /* EVENTS_H_ */
@@ -0,0 +1,47 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "input.h"
+
+#include "logic.h"
+
+
+void apply_input(Game& game, const InputEvent& event) {
+	switch (event.action) {
+
+	case MOVE_LEFT:
+	case MOVE_RIGHT:
+		game.platform.set_movement(
+				event.action == MOVE_LEFT,
+				event.state,
+				event.is_fast
+		);
+		break;
+
+	case MOVE_FAST:
+		game.platform.set_movement_fast(event.state);
+		break;
+
+	case RELEASE_BALLS:
+		for (Ball *ball : game.get_balls()) {
+			ball->release();
+		}
+		break;
+
+	}
+}
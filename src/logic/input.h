@@ -0,0 +1,76 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+#include "../common.h"
+
+#include <deque>
+
+
+enum InputAction {
+	MOVE_LEFT, MOVE_RIGHT, MOVE_FAST, RELEASE_BALLS
+};
+
+/*
+ * A single player command together with the moment it was issued.
+ */
+struct InputEvent {
+	// Moment of game time, see GameClock
+	Timestamp time;
+	InputAction action;
+	bool state;
+	bool is_fast;
+};
+
+/*
+ * Buffers player commands until the simulation reaches the moment they were
+ * issued at. Events are expected to be pushed in chronological order.
+ */
+class InputQueue {
+private:
+	std::deque<InputEvent> events;
+
+public:
+	void push(InputEvent event) {
+		events.push_back(event);
+	}
+
+	/*
+	 * Checks whether an event issued no later than the given time is pending.
+	 */
+	bool has_event_until(Timestamp time) const {
+		return !events.empty() && events.front().time <= time;
+	}
+
+	InputEvent pop() {
+		InputEvent result = events.front();
+		events.pop_front();
+		return result;
+	}
+
+	void clear() {
+		events.clear();
+	}
+};
+
+void apply_input(Game&, const InputEvent&);
+
+
+#endif /* INPUT_H_ */
@@ -19,6 +19,8 @@
 #include "level.h"
 
 #include "logic.h"
+#include "snapshot.h"
+#include "../graphics/quality.h"
 
 
 Level::Level(
@@ -34,10 +36,16 @@ Level::Level(
 	size_t length = width * field_height;
 	field = new Brick*[length];
 	corpses_field = new bool[length];
+	cell_hashes = new uint64_t[length];
 	for (size_t i = 0; i < length; ++i) {
 		field[i] = nullptr;
 		corpses_field[i] = false;
+		cell_hashes[i] = 0;
+		update_cell_hash(i);
 	}
+
+	// A chain can destroy at most every brick at once
+	destruction_queue.reserve(length);
 }
 
 Level::~Level() {
@@ -49,6 +57,7 @@ Level::~Level() {
 	}
 	delete[] field;
 	delete[] corpses_field;
+	delete[] cell_hashes;
 }
 
 
@@ -92,6 +101,68 @@ void Level::destroy_brick(LevelBlock pos) {
 		}
 
 		corpses_field[index] = true;
+		update_cell_hash(index);
+	}
+}
+
+void Level::take_for_destruction(LevelBlock pos) {
+	Brick *brick = get_brick(pos);
+
+	if (brick != nullptr) {
+		// Stays allocated until delete_pending_bricks()
+		destroy_brick(pos);
+		destruction_queue.push_back({pos, brick});
+	}
+}
+
+void Level::destroy_chain(Game& game, LevelBlock origin) {
+	destruction_queue.clear();
+	take_for_destruction(origin);
+
+	// The queue grows while it is being walked
+	for (size_t i = 0; i < destruction_queue.size(); ++i) {
+		const LevelBlock pos = destruction_queue[i].pos;
+		const LevelBlockCoord reach =
+				destruction_queue[i].brick->get_blast_radius();
+
+		for (LevelBlockCoord x = pos.x - reach; x <= pos.x + reach; ++x) {
+			for (
+					LevelBlock block = {x, pos.y - reach};
+					block.y <= pos.y + reach;
+					++block.y
+			) {
+				take_for_destruction(block);
+			}
+		}
+	}
+
+	for (const Destruction& destruction : destruction_queue) {
+		LevelBlock pos = destruction.pos;
+
+		GameEvent event(BRICK_DESTROYED, pos.add(0.5f, 0.5f));
+		event.brick = destruction.brick->get_type();
+		event.reward = destruction.brick->get_reward();
+		game.events.emit(event);
+
+		destruction.brick->do_destroy(game, pos);
+	}
+
+	GameStats& stats = game.stats;
+	stats.bricks_destroyed += destruction_queue.size();
+	stats.chains++;
+	stats.longest_chain = std::max<Counter>(
+			stats.longest_chain,
+			destruction_queue.size()
+	);
+
+	for (const Destruction& destruction : destruction_queue) {
+		Bonus *bonus = create_random_bonus(
+				static_cast<LevelPoint>(destruction.pos)
+		);
+
+		if (bonus != nullptr) {
+			game.add_bonus(bonus);
+		}
 	}
 }
 
@@ -106,7 +177,10 @@ void Level::set_brick(LevelBlock pos, Brick* brick) {
 	}
 
 	destroy_brick(pos);
-	field[get_field_index(pos)] = brick;
+
+	size_t index = get_field_index(pos);
+	field[index] = brick;
+	update_cell_hash(index);
 
 	if (brick->get_needs_destruction()) {
 		bricks_to_destroy++;
@@ -125,6 +199,18 @@ bool Level::has_corpse(LevelBlock pos) const {
 	return corpses_field[get_field_index(pos)];
 }
 
+bool Level::has_bricks(LevelBlock min, LevelBlock max) const {
+	for (LevelBlockCoord x = min.x; x <= max.x; ++x) {
+		for (LevelBlock block = {x, min.y}; block.y <= max.y; ++block.y) {
+			if (get_brick(block) != nullptr) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 
 
 void Level::delete_pending_bricks() {
@@ -135,14 +221,32 @@ void Level::delete_pending_bricks() {
 	bricks_to_delete.clear();
 }
 
-void Level::render(Game& game) {
-	for (LevelBlockCoord x = 0; x < width; ++x) {
-		for (LevelBlock block = {x, 0}; block.y < height; ++block.y) {
+void Level::render(Game& game, const LevelView& view) {
+	// Cells that intersect the view, clamped to the field
+	LevelBlock min = {
+			std::max(
+					0,
+					static_cast<LevelBlockCoord>(std::floor(view.min.x))
+			),
+			std::max(
+					height - field_height,
+					static_cast<LevelBlockCoord>(std::floor(view.min.y))
+			)
+	};
+	LevelBlock max = {
+			std::min(width, static_cast<LevelBlockCoord>(std::ceil(view.max.x))),
+			std::min(height, static_cast<LevelBlockCoord>(std::ceil(view.max.y)))
+	};
+
+	bool corpses = get_quality().corpses;
+
+	for (LevelBlockCoord x = min.x; x < max.x; ++x) {
+		for (LevelBlock block = {x, min.y}; block.y < max.y; ++block.y) {
 			Brick* brick = get_brick(block);
 			if (brick != nullptr) {
 				brick->render(game, block);
 			} else {
-				if (has_corpse(block)) {
+				if (corpses && has_corpse(block)) {
 					render_corpse(block);
 				}
 			}
@@ -153,13 +257,17 @@ void Level::render(Game& game) {
 
 
 void Level::collide(Game& context, LevelBlock pos, Ball& ball) {
+	context.stats.brick_checks++;
+
 	Brick* brick = get_brick(pos);
 
 	if (brick == nullptr) {
 		return;
 	}
 
-	LevelPoint pos_float = {static_cast<float>(pos.x), static_cast<float>(pos.y)};
+	LevelPoint pos_float = {
+			static_cast<LevelCoord>(pos.x), static_cast<LevelCoord>(pos.y)
+	};
 	LevelPoint& ball_pos = ball.get_position();
 	LevelCoord ball_radius = ball.get_radius();
 
@@ -188,16 +296,18 @@ void Level::collide(Game& context, LevelBlock pos, Ball& ball) {
 	//   and the ball centre is small enough for a collision
 	//   Comparing squared distances because sqrt() is expensive
 	if (!(collides_vertically || collides_horizontally)) {
+		using std::abs;
+
 		collides_vertically = collides_horizontally =
 
 			sqr(std::min(
-				std::abs(ball_pos.x - pos_float.x),
-				std::abs(ball_pos.x - (pos_float.x + 1))
+				abs(ball_pos.x - pos_float.x),
+				abs(ball_pos.x - (pos_float.x + 1))
 			))
 			+
 			sqr(std::min(
-				std::abs(ball_pos.y - pos_float.y),
-				std::abs(ball_pos.y - (pos_float.y + 1))
+				abs(ball_pos.y - pos_float.y),
+				abs(ball_pos.y - (pos_float.y + 1))
 			))
 
 			<= sqr(ball_radius);
@@ -207,10 +317,14 @@ void Level::collide(Game& context, LevelBlock pos, Ball& ball) {
 	bool should_bounce_positive_y = ball_pos.y > pos_float.y + 0.5f;
 
 	if (collides_vertically || collides_horizontally) {
+		context.stats.brick_hits++;
 
 		bool should_bounce = brick->on_collision(context, pos, ball)
 				&& !ball.is_invincible();
 
+		// The brick may have been damaged or destroyed
+		update_cell_hash(get_field_index(pos));
+
 		if (should_bounce) {
 			if (collides_horizontally) {
 				ball.bounce_x(
@@ -230,7 +344,92 @@ void Level::collide(Game& context, LevelBlock pos, Ball& ball) {
 				);
 			}
 
-			ball.create_collision_sprite(context);
+			ball.emit_hit(context, BRICK_HIT);
+		}
+	}
+}
+
+/*
+ * Snapshots
+ */
+
+const LevelBlockCoord MAX_SNAPSHOT_LEVEL_SIZE = 4096;
+
+void Level::save(SnapshotWriter& writer) const {
+	writer.write(id);
+	writer.write(width);
+	writer.write(height);
+	writer.write(field_height);
+
+	size_t length = width * field_height;
+
+	for (size_t i = 0; i < length; ++i) {
+		writer.write(corpses_field[i]);
+		writer.write(field[i] != nullptr);
+
+		if (field[i] != nullptr) {
+			field[i]->save(writer);
+		}
+	}
+}
+
+void Level::update_cell_hash(size_t index) {
+	uint64_t hash = EMPTY_HASH;
+	SnapshotWriter writer(hash);
+
+	writer.write(index);
+	writer.write(corpses_field[index]);
+	writer.write(field[index] != nullptr);
+
+	if (field[index] != nullptr) {
+		field[index]->save_simulated(writer);
+	}
+
+	// A sum does not depend on the order in which cells change
+	field_hash += hash - cell_hashes[index];
+	cell_hashes[index] = hash;
+}
+
+void Level::save_hash(SnapshotWriter& writer) const {
+	writer.write(id);
+	writer.write(width);
+	writer.write(height);
+	writer.write(field_height);
+	writer.write(field_hash);
+}
+
+Level* load_level(SnapshotReader& reader) {
+	LevelId id = reader.read<LevelId>();
+	LevelBlockCoord width = reader.read<LevelBlockCoord>();
+	LevelBlockCoord height = reader.read<LevelBlockCoord>();
+	LevelBlockCoord field_height = reader.read<LevelBlockCoord>();
+
+	if (reader.is_failed()
+			|| !is_in_range(1, width, MAX_SNAPSHOT_LEVEL_SIZE)
+			|| !is_in_range(1, height, MAX_SNAPSHOT_LEVEL_SIZE)
+			|| !is_in_range(0, field_height, height)) {
+		reader.fail();
+		return nullptr;
+	}
+
+	Level *level = new Level(id, width, height, field_height);
+
+	for (LevelBlockCoord y = height - field_height; y < height; ++y) {
+		for (LevelBlock block = {0, y}; block.x < width; ++block.x) {
+			size_t index = level->get_field_index(block);
+			level->corpses_field[index] = reader.read<bool>();
+			level->update_cell_hash(index);
+
+			if (reader.read<bool>()) {
+				level->set_brick(block, load_brick(reader));
+			}
 		}
 	}
+
+	if (reader.is_failed()) {
+		delete level;
+		return nullptr;
+	}
+
+	return level;
 }
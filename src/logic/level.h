@@ -20,13 +20,14 @@
 #define LEVEL_H_
 
 #include "../common.h"
+#include "../arena.h"
 
 #include "bricks.h"
 
 
 typedef unsigned int LevelId;
 
-class Level {
+class Level : public ArenaAllocated {
 private:
 	LevelId id;
 
@@ -35,10 +36,33 @@ private:
 	Brick** field;
 	bool* corpses_field;
 	LevelBlockCoord field_height;
-	std::list<Brick*> bricks_to_delete = std::list<Brick*>();
+
+	/*
+	 * Hash of every cell, kept up to date as cells change, and their sum,
+	 * so that fingerprinting the level does not walk the whole field.
+	 */
+	uint64_t* cell_hashes;
+	uint64_t field_hash = 0;
+	ArenaList<Brick*> bricks_to_delete;
 
 	unsigned int bricks_to_destroy = 0;
 
+	struct Destruction {
+		LevelBlock pos;
+		Brick *brick;
+	};
+
+	/*
+	 * Bricks of the chain being destroyed, in the order they were reached.
+	 * Kept between chains to reuse its capacity.
+	 */
+	std::vector<Destruction> destruction_queue;
+
+	/*
+	 * Removes the brick at the position from the field and queues it.
+	 */
+	void take_for_destruction(LevelBlock);
+
 	/*
 	 * Checks whether the block _does_not_ represent a brick on the field.
 	 */
@@ -49,6 +73,11 @@ private:
 	 */
 	size_t get_field_index(LevelBlock) const;
 
+	/*
+	 * Rehashes the cell at the given field index after it changed.
+	 */
+	void update_cell_hash(size_t index);
+
 	void render_corpse(LevelBlock) const;
 
 public:
@@ -59,7 +88,10 @@ public:
 	);
 	~Level();
 
-	void render(Game& game);
+	/*
+	 * Renders the bricks and corpses in the cells that intersect the view.
+	 */
+	void render(Game& game, const LevelView& view);
 
 	LevelId get_id() {
 		return id;
@@ -67,15 +99,29 @@ public:
 
 	LevelBlockCoord get_width() const  { return width; }
 	LevelBlockCoord get_height() const { return height; }
+	LevelBlockCoord get_field_height() const { return field_height; }
 
 	Brick* get_brick(LevelBlock) const;
 	void set_brick(LevelBlock, Brick*);
 	void destroy_brick(LevelBlock);
 
+	/*
+	 * Destroys the brick at the position and, breadth-first, every brick
+	 * caught in the blast of a destroyed brick. Each brick is destroyed once.
+	 * Effects are then applied in order: sprites and brick actions, the total
+	 * reward, and finally one bonus roll per brick.
+	 */
+	void destroy_chain(Game&, LevelBlock);
+
 	bool is_level_cleared() const;
 
 	bool has_corpse(LevelBlock) const;
 
+	/*
+	 * Checks whether any block of the rectangle holds a brick.
+	 */
+	bool has_bricks(LevelBlock min, LevelBlock max) const;
+
 	/*
 	 * Handles a single collision if necessary.
 	 */
@@ -85,7 +131,25 @@ public:
 	 * Deletes (frees memory) of the bricks that have been semantically removed.
 	 */
 	void delete_pending_bricks();
+
+	/*
+	 * Writes the dimensions, bricks and corpses, see load_level().
+	 */
+	void save(SnapshotWriter&) const;
+
+	/*
+	 * Writes the dimensions and a hash of the simulated state of the bricks
+	 * and corpses, without walking the field.
+	 */
+	void save_hash(SnapshotWriter&) const;
+
+	friend Level* load_level(SnapshotReader&);
 };
 
+/*
+ * Recreates a level written by Level::save(). Returns nullptr on failure.
+ */
+Level* load_level(SnapshotReader&);
+
 
 #endif /* LEVEL_H_ */
@@ -17,16 +17,21 @@
  */
 
 #include "logic.h"
-#include "../workflow.h"
 
 #include "level_builder.h"
+#include "snapshot.h"
+#include "tick_workers.h"
 
 
 const float PLATFORM_SIZE_BONUS_FACTOR = 1.5f;
 const float BALL_MASS_BONUS_FACTOR = 1.5f;
 const Time INVINSIBILITY_BONUS = 5.0f;
 
+void reserve_tick_buffers();
+
 void setup_logic() {
+	reserve_tick_buffers();
+
 	register_simple_bonus_type(
 			Color(0xEE0000), true,
 			[](Game&) {
@@ -95,30 +100,207 @@ void setup_logic() {
 }
 
 void terminate_logic() {
+	stop_tick_workers();
 	end_attempt();
 }
 
-extern const LevelId max_level;
 Level* _create_level(LevelId id);
 
+MotionBounds get_motion_bounds(Game& game) {
+	const Level& level = *(game.level);
+
+	return {
+			static_cast<LevelCoord>(level.get_width()),
+			static_cast<LevelCoord>(level.get_height()),
+
+			game.platform.get_min_x(),
+			game.platform.get_max_x(),
+			PLATFORM_HEIGHT,
+
+			static_cast<LevelCoord>(
+					level.get_height() - level.get_field_height()
+			)
+	};
+}
+
 std::vector<Ball*> __tick__balls_copy;
-std::list<Bonus*> __tick__bonuses_copy;
+std::vector<Ball*> __tick__moving_balls;
+std::vector<Bonus*> __tick__bonuses_copy;
+MotionStore __tick__motion;
+
+// Tick buffers grow past this only in unusually busy games
+const size_t RESERVED_BODIES = 64;
+
+void reserve_tick_buffers() {
+	__tick__balls_copy.reserve(RESERVED_BODIES);
+	__tick__moving_balls.reserve(RESERVED_BODIES);
+	__tick__bonuses_copy.reserve(RESERVED_BODIES);
+	__tick__motion.reserve(RESERVED_BODIES);
+}
 
-void tick(Game& game, Time frame_length) {
-	if (game.state != RUNNING) {
-		return;
+/*
+ * Balls and bonuses are moved in bulk by the kernels in motion.h; collisions
+ * are then handled one body at a time in the original order. Only bodies
+ * that touched a boundary or the brick rows do any per-object work.
+ */
+
+void move_balls(Game& game, Time frame_length) {
+	MotionStore& motion = __tick__motion;
+
+	__tick__moving_balls.clear();
+
+	for (Ball *ball : __tick__balls_copy) {
+		if (ball->prepare_tick(game, frame_length)) {
+			__tick__moving_balls.push_back(ball);
+		}
 	}
 
-	Attempt *attempt = get_current_attempt();
+	motion.resize(__tick__moving_balls.size());
 
-	Level& level = *(game.level);
-	game.platform.tick(game, frame_length);
+	for (size_t i = 0; i < __tick__moving_balls.size(); ++i) {
+		__tick__moving_balls[i]->store_motion(motion, i);
+	}
 
-	__tick__balls_copy = game.get_balls();
+	integrate_motion(motion, frame_length, get_motion_bounds(game));
 
-	for (Ball *ball : __tick__balls_copy) {
-		ball->tick(game, frame_length);
+	for (size_t i = 0; i < __tick__moving_balls.size(); ++i) {
+		Ball *ball = __tick__moving_balls[i];
+
+		ball->load_motion(motion, i);
+		ball->handle_motion_hits(game, motion.hits[i]);
+		ball->store_motion(motion, i);
+	}
+
+	accelerate_balls(motion, frame_length);
+
+	for (size_t i = 0; i < __tick__moving_balls.size(); ++i) {
+		__tick__moving_balls[i]->load_motion(motion, i);
+		__tick__moving_balls[i]->finish_tick(game, frame_length);
+	}
+}
+
+/*
+ * Large games split their balls into contiguous parts. Each part prepares,
+ * moves and accelerates its balls on a tick thread and looks up which of
+ * them have bricks around, see get_blocks_around(). Collisions change shared
+ * state, so they are still handled on the calling thread in ball order, but
+ * only for the balls a part found touching something. Bricks are never
+ * added during a tick, so a ball with no bricks around it at the start of
+ * the tick cannot hit one later, and the result equals that of move_balls()
+ * bit for bit.
+ */
+
+struct BallPart {
+	// Range of __tick__balls_copy
+	size_t begin, end;
+
+	std::vector<Ball*> moving;
+	MotionStore motion;
+
+	// Brick checks of the balls that turned out to need no collision handling
+	Counter skipped_brick_checks;
+};
+
+std::vector<BallPart> __tick__ball_parts;
+
+void prepare_ball_part(
+		BallPart& part, Game& game,
+		Time frame_length, const MotionBounds& bounds
+) {
+	part.moving.clear();
+	part.skipped_brick_checks = 0;
+
+	for (size_t i = part.begin; i < part.end; ++i) {
+		Ball *ball = __tick__balls_copy[i];
 
+		if (ball->prepare_tick(game, frame_length)) {
+			part.moving.push_back(ball);
+		}
+	}
+
+	MotionStore& motion = part.motion;
+	motion.resize(part.moving.size());
+
+	for (size_t i = 0; i < part.moving.size(); ++i) {
+		part.moving[i]->store_motion(motion, i);
+	}
+
+	integrate_motion(motion, frame_length, bounds);
+
+	for (size_t i = 0; i < part.moving.size(); ++i) {
+		if ((motion.hits[i] & HIT_BOUNDS) || !(motion.hits[i] & NEAR_BRICKS)) {
+			continue;
+		}
+
+		LevelBlock min, max;
+		get_blocks_around(
+				{motion.x[i], motion.y[i]}, motion.radius[i],
+				min, max
+		);
+
+		if (!game.level->has_bricks(min, max)) {
+			part.skipped_brick_checks +=
+					(max.x - min.x + 1) * (max.y - min.y + 1);
+			motion.hits[i] = 0;
+		}
+	}
+}
+
+void finish_ball_part(BallPart& part, Game& game, Time frame_length) {
+	accelerate_balls(part.motion, frame_length);
+
+	for (size_t i = 0; i < part.moving.size(); ++i) {
+		part.moving[i]->load_motion(part.motion, i);
+		part.moving[i]->finish_tick(game, frame_length);
+	}
+}
+
+void move_balls_in_parts(Game& game, Time frame_length) {
+	const MotionBounds bounds = get_motion_bounds(game);
+	const size_t balls = __tick__balls_copy.size();
+	const unsigned int parts = std::min<size_t>(get_tick_threads(), balls);
+
+	if (__tick__ball_parts.size() < parts) {
+		__tick__ball_parts.resize(parts);
+	}
+
+	for (unsigned int i = 0; i < parts; ++i) {
+		__tick__ball_parts[i].begin = balls * i / parts;
+		__tick__ball_parts[i].end = balls * (i + 1) / parts;
+	}
+
+	auto prepare = [&game, frame_length, &bounds](unsigned int i) {
+		prepare_ball_part(__tick__ball_parts[i], game, frame_length, bounds);
+	};
+	run_tick_parts(parts, prepare);
+
+	for (unsigned int p = 0; p < parts; ++p) {
+		BallPart& part = __tick__ball_parts[p];
+		game.stats.brick_checks += part.skipped_brick_checks;
+
+		for (size_t i = 0; i < part.moving.size(); ++i) {
+			if (part.motion.hits[i] == 0) {
+				continue;
+			}
+
+			Ball *ball = part.moving[i];
+
+			ball->load_motion(part.motion, i);
+			ball->handle_motion_hits(game, part.motion.hits[i]);
+			ball->store_motion(part.motion, i);
+		}
+	}
+
+	auto finish = [&game, frame_length](unsigned int i) {
+		finish_ball_part(__tick__ball_parts[i], game, frame_length);
+	};
+	run_tick_parts(parts, finish);
+}
+
+void remove_dead_balls(Game& game) {
+	Attempt *attempt = get_current_attempt();
+
+	for (Ball *ball : __tick__balls_copy) {
 		if (ball->is_dead()) {
 			if (game.get_balls().size() == 1) {
 
@@ -126,7 +308,6 @@ void tick(Game& game, Time frame_length) {
 
 				if (attempt->get_lives() == 0) {
 					game.state = DEFEAT;
-					show_results_menu(game);
 				} else {
 					game.reset_balls();
 				}
@@ -137,23 +318,149 @@ void tick(Game& game, Time frame_length) {
 			}
 		}
 	}
+}
+
+void tick_balls(Game& game, Time frame_length) {
+	__tick__balls_copy = game.get_balls();
+
+	if (get_tick_threads() > 1
+			&& __tick__balls_copy.size() >= get_parallel_tick_threshold()) {
+		move_balls_in_parts(game, frame_length);
+	} else {
+		move_balls(game, frame_length);
+	}
 
-	__tick__bonuses_copy = game.get_bonuses();
+	remove_dead_balls(game);
+}
+
+void tick_bonuses(Game& game, Time frame_length) {
+	MotionStore& motion = __tick__motion;
 
+	__tick__bonuses_copy.assign(
+			game.get_bonuses().cbegin(),
+			game.get_bonuses().cend()
+	);
+	motion.resize(__tick__bonuses_copy.size());
+
+	size_t i = 0;
 	for (Bonus *bonus : __tick__bonuses_copy) {
-		bonus->tick(game, frame_length);
+		bonus->store_motion(motion, i++);
+	}
+
+	integrate_motion(motion, frame_length, get_motion_bounds(game));
+
+	i = 0;
+	for (Bonus *bonus : __tick__bonuses_copy) {
+		bonus->load_motion(motion, i);
+		bonus->handle_motion_hits(game, motion.hits[i]);
+		bonus->store_motion(motion, i++);
+	}
+
+	accelerate_bonuses(motion, frame_length);
+
+	i = 0;
+	for (Bonus *bonus : __tick__bonuses_copy) {
+		bonus->load_motion(motion, i++);
 
 		if (bonus->is_dead()) {
 			game.remove_bonus(bonus);
 		}
 	}
+}
+
+void update_stats(Game& game) {
+	game.stats.ticks++;
+	game.stats.balls = game.get_balls().size();
+	game.stats.bonuses = game.get_bonuses().size();
+	game.stats.sprites = game.sprites.size();
+}
+
+void tick_step(Game& game, Time frame_length) {
+	Attempt *attempt = get_current_attempt();
+
+	Level& level = *(game.level);
+
+	if (game.bot != nullptr) {
+		game.bot->control(game);
+	}
+
+	game.platform.tick(game, frame_length);
+
+	tick_balls(game, frame_length);
+	tick_bonuses(game, frame_length);
 
 	level.delete_pending_bricks();
+	update_stats(game);
 
 	if (level.is_level_cleared()) {
 		game.state = VICTORY;
 		attempt->increase_score(20 * attempt->get_lives());
-		show_results_menu(game);
+	}
+}
+
+void simulate_frame(Game& game, Time frame_length, Timestamp frame_end) {
+	const Timestamp frame_start = frame_end - to_timestamp(frame_length);
+	Time simulated = 0;
+
+	while (game.input.has_event_until(frame_end)) {
+		InputEvent event = game.input.pop();
+
+		// Events issued before this frame (e.g. while paused) apply at once
+		Time offset = force_in_range(
+				simulated,
+				to_seconds(event.time - frame_start),
+				frame_length
+		);
+
+		if (offset > simulated) {
+			tick_step(game, offset - simulated);
+			simulated = offset;
+
+			if (game.state != RUNNING) {
+				return;
+			}
+		}
+
+		apply_input(game, event);
+	}
+
+	if (simulated < frame_length) {
+		tick_step(game, frame_length - simulated);
+	}
+}
+
+void award_score(const Game& game) {
+	Score reward = 0;
+
+	for (const GameEvent& event : game.events) {
+		if (event.type == BRICK_DESTROYED) {
+			reward += event.reward;
+		}
+	}
+
+	get_current_attempt()->increase_score(reward);
+}
+
+void tick(Game& game, Time frame_length, Timestamp frame_end) {
+	game.events.clear();
+
+	if (game.state != RUNNING) {
+		return;
+	}
+
+	ArenaScope arena_scope(game.get_arena());
+
+	simulate_frame(game, frame_length, frame_end);
+	award_score(game);
+}
+
+void advance_game(Game& game, Timestamp wall_now) {
+	Timestamp step = game.clock.update(wall_now);
+
+	if (step > 0) {
+		tick(game, to_seconds(step), game.clock.get_now());
+	} else {
+		game.events.clear();
 	}
 }
 
@@ -186,6 +493,16 @@ void end_attempt() {
 	current_attempt = nullptr;
 }
 
+AttemptScope::AttemptScope(Attempt& attempt) :
+	previous(current_attempt)
+{
+	current_attempt = &attempt;
+}
+
+AttemptScope::~AttemptScope() {
+	current_attempt = previous;
+}
+
 Attempt::Attempt() :
 		lives(10),
 		score(0),
@@ -217,7 +534,7 @@ void Attempt::increase_score(Score increment) {
 }
 
 Game* Attempt::start_next_level() {
-	Level* level = _create_level(next_level);
+	LevelId id = next_level;
 
 	if (next_level == max_level) {
 		next_level = 0;
@@ -225,22 +542,49 @@ Game* Attempt::start_next_level() {
 		next_level++;
 	}
 
-	Game* result = new Game(level);
-	result->reset_balls();
-	return result;
+	return new Game(id);
+}
+
+void Attempt::save(SnapshotWriter& writer) const {
+	writer.write(lives);
+	writer.write(score);
+	writer.write(next_level);
+}
+
+void Attempt::load(SnapshotReader& reader) {
+	lives = reader.read<Lives>();
+	score = reader.read<Score>();
+	next_level = reader.read<LevelId>();
+
+	if (next_level > max_level) {
+		reader.fail();
+	}
 }
 
 /*
  * Game
  */
 
-Game::Game(Level *level) :
+Game::Game() :
+	arena(),
 	balls(),
-	level(level),
+	bonuses(ArenaAllocator<Bonus*>(&arena)),
+	level(nullptr),
 	platform(),
 	state(RUNNING),
-	sprites()
-{}
+	sprites(ArenaAllocator<Sprite*>(&arena))
+{
+	balls.reserve(RESERVED_BODIES);
+}
+
+Game::Game(LevelId id) :
+	Game()
+{
+	ArenaScope arena_scope(arena);
+
+	level = _create_level(id);
+	reset_balls();
+}
 
 Game::~Game() {
 	delete_and_clear(balls);
@@ -248,6 +592,7 @@ Game::~Game() {
 	delete_and_clear(bonuses);
 
 	delete level;
+	delete bot;
 }
 
 void Game::add_sprite(Sprite* sprite) {
@@ -287,6 +632,7 @@ void Game::remove_ball(Ball *ball) {
 
 void Game::add_bonus(Bonus* bonus) {
 	bonuses.push_back(bonus);
+	stats.bonuses_spawned++;
 }
 
 void Game::remove_bonus(Bonus* bonus) {
@@ -19,6 +19,7 @@
 #ifndef LOGIC_H_
 #define LOGIC_H_
 
+#include "../clock.h"
 #include "../common.h"
 
 #include "bricks.h"
@@ -27,6 +28,10 @@
 #include "platform.h"
 #include "ball.h"
 #include "bonus.h"
+#include "events.h"
+#include "input.h"
+#include "stats.h"
+#include "bot.h"
 #include "../random.h"
 
 
@@ -47,29 +52,80 @@ public:
 	void remove_lives(Lives mod);
 
 	Game* start_next_level();
+
+	void save(SnapshotWriter&) const;
+	void load(SnapshotReader&);
 };
 
+extern const LevelId max_level;
+
 Attempt* get_current_attempt();
 void start_attempt();
 void end_attempt();
 
+/*
+ * Makes an attempt current until the end of the scope, so that games not
+ * played in the current attempt keep their own score and lives. The attempt
+ * must not be ended within the scope.
+ */
+class AttemptScope {
+private:
+	Attempt *previous;
+
+public:
+	AttemptScope(Attempt&);
+	~AttemptScope();
+
+	AttemptScope(const AttemptScope&) = delete;
+	AttemptScope& operator=(const AttemptScope&) = delete;
+};
+
+/*
+ * A level being played. The level, balls, bonuses and sprites are allocated
+ * from the game's arena, which must be current (see ArenaScope) whenever they
+ * are created.
+ */
 class Game {
 private:
+	// Declared first to outlive every object allocated from it
+	Arena arena;
+
 	std::vector<Ball*> balls;
-	std::list<Bonus*> bonuses;
+	ArenaList<Bonus*> bonuses;
 
 public:
 	Level *level;
 
 	Platform platform;
 
+	InputQueue input;
+
+	// Steers the platform instead of the player if not nullptr; owned
+	Bot *bot = nullptr;
+
 	GameState state;
 
-	std::list<Sprite*> sprites;
+	ArenaList<Sprite*> sprites;
+
+	// What happened during the last tick, see tick()
+	EventBuffer events;
+
+	GameStats stats;
+
+	// Simulation time, see advance_game()
+	GameClock clock;
+
+	Game(LevelId);
+
+	// Creates a game without a level or balls, for callers that build them
+	Game();
 
-	Game(Level*);
 	~Game();
 
+	Arena& get_arena() {
+		return arena;
+	}
+
 	void add_sprite(Sprite *sprite);
 
 	void add_ball(Ball*);
@@ -84,12 +140,28 @@ public:
 	void add_bonus(Bonus* bonus);
 	void remove_bonus(Bonus* bonus);
 
-	const std::list<Bonus*>& get_bonuses() const {
+	const ArenaList<Bonus*>& get_bonuses() const {
 		return bonuses;
 	}
 };
 
-void tick(Game& game, Time frame_length);
+/*
+ * Advances the game by frame_length seconds ending at frame_end. Queued input
+ * events are applied at the exact moment within the frame they were issued at.
+ * The game state becomes VICTORY or DEFEAT when the level ends.
+ *
+ * What happened replaces the previous contents of game.events. Destroyed
+ * bricks are scored from there; sprites are left to the caller, see
+ * create_event_sprites().
+ */
+void tick(Game& game, Time frame_length, Timestamp frame_end);
+
+/*
+ * Follows the clock of the game to the given wall clock moment and ticks the
+ * game by the simulation time that passed. Events are cleared even if no
+ * time passed.
+ */
+void advance_game(Game& game, Timestamp wall_now);
 
 void setup_logic();
 void terminate_logic();
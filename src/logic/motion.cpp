@@ -0,0 +1,807 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "motion.h"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define X86_MOTION_KERNELS
+#include <immintrin.h>
+#endif
+
+// Kernels must round every product and sum on their own to stay identical,
+// so multiplies and adds are never fused into FMA here, even where the build
+// targets a CPU that has it
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+
+void MotionStore::resize(size_t count) {
+	x.resize(count);
+	y.resize(count);
+	radius.resize(count);
+	vx.resize(count);
+	vy.resize(count);
+	speed.resize(count);
+	hits.resize(count);
+}
+
+void MotionStore::reserve(size_t count) {
+	x.reserve(count);
+	y.reserve(count);
+	radius.reserve(count);
+	vx.reserve(count);
+	vy.reserve(count);
+	speed.reserve(count);
+	hits.reserve(count);
+}
+
+/*
+ * Scalar kernels
+ *
+ * These define the results every other implementation must reproduce. The
+ * operations mirror Collideable::tick, Ball::accelerate and Bonus::tick in
+ * the same order so that batched simulation is bit-identical to per-object
+ * simulation. They also process the remainders left over by vector kernels.
+ */
+
+unsigned char compute_hits(
+		LevelCoord x, LevelCoord y, LevelCoord radius, Velocity vy,
+		const MotionBounds& bounds
+) {
+	unsigned char hits = 0;
+
+	if (vy < 0
+		&& y - radius <= bounds.platform_height
+		&& bounds.platform_min_x - radius <= x
+		&& x <= bounds.platform_max_x + radius) {
+		hits |= HIT_PLATFORM;
+	}
+
+	if (y >= bounds.height - radius) {
+		hits |= HIT_CEILING;
+	}
+
+	if (!(radius <= x && x <= bounds.width - radius)) {
+		hits |= HIT_WALL;
+	}
+
+	if (y - radius <= 0) {
+		hits |= HIT_FLOOR;
+	}
+
+	if (y + radius >= bounds.field_bottom) {
+		hits |= NEAR_BRICKS;
+	}
+
+	return hits;
+}
+
+void integrate_scalar(
+		MotionStore& store, size_t start,
+		Time frame_length, const MotionBounds& bounds
+) {
+	for (size_t i = start; i < store.size(); ++i) {
+		store.x[i] += store.vx[i] * frame_length;
+		store.y[i] += store.vy[i] * frame_length;
+
+		store.hits[i] = compute_hits(
+				store.x[i], store.y[i], store.radius[i], store.vy[i],
+				bounds
+		);
+	}
+}
+
+void accelerate_scalar(
+		MotionStore& store, size_t start,
+		Velocity impulse, LevelCoord mass_per_cubed_radius
+) {
+	for (size_t i = start; i < store.size(); ++i) {
+		LevelCoord r = store.radius[i];
+		Velocity delta = impulse / (mass_per_cubed_radius * r * r * r);
+
+		store.speed[i] += delta;
+		store.vx[i] += delta * store.vx[i] / store.speed[i];
+		store.vy[i] += delta * store.vy[i] / store.speed[i];
+	}
+}
+
+void gravity_scalar(MotionStore& store, size_t start, Velocity change) {
+	for (size_t i = start; i < store.size(); ++i) {
+		store.vy[i] = store.vy[i] - change;
+		store.speed[i] = sqrt(sqr(store.vx[i]) + sqr(store.vy[i]));
+	}
+}
+
+#ifdef X86_MOTION_KERNELS
+#ifndef FIXED_POINT_PHYSICS
+
+/*
+ * SSE2 kernels
+ */
+
+__attribute__((target("sse2")))
+size_t integrate_sse2(
+		MotionStore& store, Time frame_length, const MotionBounds& bounds
+) {
+	const __m128 time = _mm_set1_ps(frame_length);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 width = _mm_set1_ps(bounds.width);
+	const __m128 height = _mm_set1_ps(bounds.height);
+	const __m128 platform_min_x = _mm_set1_ps(bounds.platform_min_x);
+	const __m128 platform_max_x = _mm_set1_ps(bounds.platform_max_x);
+	const __m128 platform_height = _mm_set1_ps(bounds.platform_height);
+	const __m128 field_bottom = _mm_set1_ps(bounds.field_bottom);
+
+	const __m128i platform_bit = _mm_set1_epi32(HIT_PLATFORM);
+	const __m128i ceiling_bit = _mm_set1_epi32(HIT_CEILING);
+	const __m128i wall_bit = _mm_set1_epi32(HIT_WALL);
+	const __m128i floor_bit = _mm_set1_epi32(HIT_FLOOR);
+	const __m128i near_bit = _mm_set1_epi32(NEAR_BRICKS);
+
+	const size_t count = store.size() & ~size_t(3);
+
+	for (size_t i = 0; i < count; i += 4) {
+		__m128 vx = _mm_loadu_ps(&store.vx[i]);
+		__m128 vy = _mm_loadu_ps(&store.vy[i]);
+		__m128 r = _mm_loadu_ps(&store.radius[i]);
+
+		__m128 x = _mm_add_ps(_mm_loadu_ps(&store.x[i]), _mm_mul_ps(vx, time));
+		__m128 y = _mm_add_ps(_mm_loadu_ps(&store.y[i]), _mm_mul_ps(vy, time));
+
+		_mm_storeu_ps(&store.x[i], x);
+		_mm_storeu_ps(&store.y[i], y);
+
+		__m128 bottom = _mm_sub_ps(y, r);
+
+		__m128 platform = _mm_and_ps(
+				_mm_and_ps(
+						_mm_cmplt_ps(vy, zero),
+						_mm_cmple_ps(bottom, platform_height)
+				),
+				_mm_and_ps(
+						_mm_cmple_ps(_mm_sub_ps(platform_min_x, r), x),
+						_mm_cmple_ps(x, _mm_add_ps(platform_max_x, r))
+				)
+		);
+		__m128 ceiling = _mm_cmpge_ps(y, _mm_sub_ps(height, r));
+		__m128 inside = _mm_and_ps(
+				_mm_cmple_ps(r, x),
+				_mm_cmple_ps(x, _mm_sub_ps(width, r))
+		);
+		__m128 on_floor = _mm_cmple_ps(bottom, zero);
+		__m128 near = _mm_cmpge_ps(_mm_add_ps(y, r), field_bottom);
+
+		__m128i hits = _mm_or_si128(
+				_mm_or_si128(
+						_mm_and_si128(_mm_castps_si128(platform), platform_bit),
+						_mm_and_si128(_mm_castps_si128(ceiling), ceiling_bit)
+				),
+				_mm_or_si128(
+						_mm_andnot_si128(_mm_castps_si128(inside), wall_bit),
+						_mm_or_si128(
+								_mm_and_si128(_mm_castps_si128(on_floor), floor_bit),
+								_mm_and_si128(_mm_castps_si128(near), near_bit)
+						)
+				)
+		);
+
+		hits = _mm_packs_epi32(hits, hits);
+		hits = _mm_packus_epi16(hits, hits);
+
+		int packed = _mm_cvtsi128_si32(hits);
+		std::memcpy(&store.hits[i], &packed, 4);
+	}
+
+	return count;
+}
+
+__attribute__((target("sse2")))
+size_t accelerate_sse2(
+		MotionStore& store,
+		Velocity impulse, LevelCoord mass_per_cubed_radius
+) {
+	const __m128 impulse_v = _mm_set1_ps(impulse);
+	const __m128 density = _mm_set1_ps(mass_per_cubed_radius);
+
+	const size_t count = store.size() & ~size_t(3);
+
+	for (size_t i = 0; i < count; i += 4) {
+		__m128 r = _mm_loadu_ps(&store.radius[i]);
+		__m128 vx = _mm_loadu_ps(&store.vx[i]);
+		__m128 vy = _mm_loadu_ps(&store.vy[i]);
+
+		__m128 mass = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(density, r), r), r);
+		__m128 delta = _mm_div_ps(impulse_v, mass);
+		__m128 speed = _mm_add_ps(_mm_loadu_ps(&store.speed[i]), delta);
+
+		vx = _mm_add_ps(vx, _mm_div_ps(_mm_mul_ps(delta, vx), speed));
+		vy = _mm_add_ps(vy, _mm_div_ps(_mm_mul_ps(delta, vy), speed));
+
+		_mm_storeu_ps(&store.speed[i], speed);
+		_mm_storeu_ps(&store.vx[i], vx);
+		_mm_storeu_ps(&store.vy[i], vy);
+	}
+
+	return count;
+}
+
+__attribute__((target("sse2")))
+size_t gravity_sse2(MotionStore& store, Velocity change) {
+	const __m128 change_v = _mm_set1_ps(change);
+
+	const size_t count = store.size() & ~size_t(3);
+
+	for (size_t i = 0; i < count; i += 4) {
+		__m128 vx = _mm_loadu_ps(&store.vx[i]);
+		__m128 vy = _mm_sub_ps(_mm_loadu_ps(&store.vy[i]), change_v);
+
+		__m128 speed = _mm_sqrt_ps(
+				_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy))
+		);
+
+		_mm_storeu_ps(&store.vy[i], vy);
+		_mm_storeu_ps(&store.speed[i], speed);
+	}
+
+	return count;
+}
+
+/*
+ * AVX2 kernels
+ *
+ * FMA is deliberately not enabled: fused operations round differently from
+ * the scalar reference.
+ */
+
+__attribute__((target("avx2")))
+size_t integrate_avx2(
+		MotionStore& store, Time frame_length, const MotionBounds& bounds
+) {
+	const __m256 time = _mm256_set1_ps(frame_length);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 width = _mm256_set1_ps(bounds.width);
+	const __m256 height = _mm256_set1_ps(bounds.height);
+	const __m256 platform_min_x = _mm256_set1_ps(bounds.platform_min_x);
+	const __m256 platform_max_x = _mm256_set1_ps(bounds.platform_max_x);
+	const __m256 platform_height = _mm256_set1_ps(bounds.platform_height);
+	const __m256 field_bottom = _mm256_set1_ps(bounds.field_bottom);
+
+	const __m256i platform_bit = _mm256_set1_epi32(HIT_PLATFORM);
+	const __m256i ceiling_bit = _mm256_set1_epi32(HIT_CEILING);
+	const __m256i wall_bit = _mm256_set1_epi32(HIT_WALL);
+	const __m256i floor_bit = _mm256_set1_epi32(HIT_FLOOR);
+	const __m256i near_bit = _mm256_set1_epi32(NEAR_BRICKS);
+
+	const size_t count = store.size() & ~size_t(7);
+
+	for (size_t i = 0; i < count; i += 8) {
+		__m256 vx = _mm256_loadu_ps(&store.vx[i]);
+		__m256 vy = _mm256_loadu_ps(&store.vy[i]);
+		__m256 r = _mm256_loadu_ps(&store.radius[i]);
+
+		__m256 x = _mm256_add_ps(
+				_mm256_loadu_ps(&store.x[i]), _mm256_mul_ps(vx, time)
+		);
+		__m256 y = _mm256_add_ps(
+				_mm256_loadu_ps(&store.y[i]), _mm256_mul_ps(vy, time)
+		);
+
+		_mm256_storeu_ps(&store.x[i], x);
+		_mm256_storeu_ps(&store.y[i], y);
+
+		__m256 bottom = _mm256_sub_ps(y, r);
+
+		__m256 platform = _mm256_and_ps(
+				_mm256_and_ps(
+						_mm256_cmp_ps(vy, zero, _CMP_LT_OQ),
+						_mm256_cmp_ps(bottom, platform_height, _CMP_LE_OQ)
+				),
+				_mm256_and_ps(
+						_mm256_cmp_ps(
+								_mm256_sub_ps(platform_min_x, r), x,
+								_CMP_LE_OQ
+						),
+						_mm256_cmp_ps(
+								x, _mm256_add_ps(platform_max_x, r),
+								_CMP_LE_OQ
+						)
+				)
+		);
+		__m256 ceiling = _mm256_cmp_ps(
+				y, _mm256_sub_ps(height, r), _CMP_GE_OQ
+		);
+		__m256 inside = _mm256_and_ps(
+				_mm256_cmp_ps(r, x, _CMP_LE_OQ),
+				_mm256_cmp_ps(x, _mm256_sub_ps(width, r), _CMP_LE_OQ)
+		);
+		__m256 on_floor = _mm256_cmp_ps(bottom, zero, _CMP_LE_OQ);
+		__m256 near = _mm256_cmp_ps(
+				_mm256_add_ps(y, r), field_bottom, _CMP_GE_OQ
+		);
+
+		__m256i hits = _mm256_or_si256(
+				_mm256_or_si256(
+						_mm256_and_si256(
+								_mm256_castps_si256(platform), platform_bit
+						),
+						_mm256_and_si256(
+								_mm256_castps_si256(ceiling), ceiling_bit
+						)
+				),
+				_mm256_or_si256(
+						_mm256_andnot_si256(
+								_mm256_castps_si256(inside), wall_bit
+						),
+						_mm256_or_si256(
+								_mm256_and_si256(
+										_mm256_castps_si256(on_floor), floor_bit
+								),
+								_mm256_and_si256(
+										_mm256_castps_si256(near), near_bit
+								)
+						)
+				)
+		);
+
+		__m128i packed = _mm_packs_epi32(
+				_mm256_castsi256_si128(hits),
+				_mm256_extracti128_si256(hits, 1)
+		);
+		packed = _mm_packus_epi16(packed, packed);
+
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&store.hits[i]), packed);
+	}
+
+	return count;
+}
+
+__attribute__((target("avx2")))
+size_t accelerate_avx2(
+		MotionStore& store,
+		Velocity impulse, LevelCoord mass_per_cubed_radius
+) {
+	const __m256 impulse_v = _mm256_set1_ps(impulse);
+	const __m256 density = _mm256_set1_ps(mass_per_cubed_radius);
+
+	const size_t count = store.size() & ~size_t(7);
+
+	for (size_t i = 0; i < count; i += 8) {
+		__m256 r = _mm256_loadu_ps(&store.radius[i]);
+		__m256 vx = _mm256_loadu_ps(&store.vx[i]);
+		__m256 vy = _mm256_loadu_ps(&store.vy[i]);
+
+		__m256 mass = _mm256_mul_ps(
+				_mm256_mul_ps(_mm256_mul_ps(density, r), r), r
+		);
+		__m256 delta = _mm256_div_ps(impulse_v, mass);
+		__m256 speed = _mm256_add_ps(_mm256_loadu_ps(&store.speed[i]), delta);
+
+		vx = _mm256_add_ps(vx, _mm256_div_ps(_mm256_mul_ps(delta, vx), speed));
+		vy = _mm256_add_ps(vy, _mm256_div_ps(_mm256_mul_ps(delta, vy), speed));
+
+		_mm256_storeu_ps(&store.speed[i], speed);
+		_mm256_storeu_ps(&store.vx[i], vx);
+		_mm256_storeu_ps(&store.vy[i], vy);
+	}
+
+	return count;
+}
+
+__attribute__((target("avx2")))
+size_t gravity_avx2(MotionStore& store, Velocity change) {
+	const __m256 change_v = _mm256_set1_ps(change);
+
+	const size_t count = store.size() & ~size_t(7);
+
+	for (size_t i = 0; i < count; i += 8) {
+		__m256 vx = _mm256_loadu_ps(&store.vx[i]);
+		__m256 vy = _mm256_sub_ps(_mm256_loadu_ps(&store.vy[i]), change_v);
+
+		__m256 speed = _mm256_sqrt_ps(
+				_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy))
+		);
+
+		_mm256_storeu_ps(&store.vy[i], vy);
+		_mm256_storeu_ps(&store.speed[i], speed);
+	}
+
+	return count;
+}
+
+#else /* FIXED_POINT_PHYSICS */
+
+/*
+ * Fixed-point kernels
+ *
+ * Coordinates and velocities are Q16.16 integers, see fixed.h. Products are
+ * computed in 64 bits for the even and odd lanes separately; bits 16 to 47
+ * of each product are the raw result, exactly as in Fixed::operator*.
+ * Only integration is vectorized: acceleration and gravity divide and take
+ * square roots, which have no integer vector instructions.
+ */
+
+__attribute__((target("sse2")))
+__m128i multiply_fixed_sse2(__m128i a, __m128i b) {
+	const __m128i low = _mm_set_epi32(0, -1, 0, -1);
+
+	// SSE2 only multiplies unsigned numbers; negative factors are corrected
+	// for in the upper halves of the products
+	__m128i correction = _mm_add_epi32(
+			_mm_and_si128(_mm_srai_epi32(a, 31), b),
+			_mm_and_si128(_mm_srai_epi32(b, 31), a)
+	);
+
+	__m128i even = _mm_sub_epi64(
+			_mm_mul_epu32(a, b),
+			_mm_slli_epi64(correction, 32)
+	);
+	__m128i odd = _mm_sub_epi64(
+			_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)),
+			_mm_andnot_si128(low, correction)
+	);
+
+	return _mm_or_si128(
+			_mm_and_si128(_mm_srli_epi64(even, Fixed::FRACTION_BITS), low),
+			_mm_andnot_si128(low, _mm_slli_epi64(odd, Fixed::FRACTION_BITS))
+	);
+}
+
+__attribute__((target("sse2")))
+__m128i load_fixed_sse2(const Fixed *source) {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+}
+
+__attribute__((target("sse2")))
+void store_fixed_sse2(Fixed *destination, __m128i value) {
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), value);
+}
+
+__attribute__((target("sse2")))
+size_t integrate_sse2(
+		MotionStore& store, Time frame_length, const MotionBounds& bounds
+) {
+	const __m128i time = _mm_set1_epi32(Fixed(frame_length).get_raw());
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i width = _mm_set1_epi32(bounds.width.get_raw());
+	const __m128i height = _mm_set1_epi32(bounds.height.get_raw());
+	const __m128i platform_min_x =
+			_mm_set1_epi32(bounds.platform_min_x.get_raw());
+	const __m128i platform_max_x =
+			_mm_set1_epi32(bounds.platform_max_x.get_raw());
+	const __m128i platform_height =
+			_mm_set1_epi32(bounds.platform_height.get_raw());
+	const __m128i field_bottom = _mm_set1_epi32(bounds.field_bottom.get_raw());
+
+	const __m128i platform_bit = _mm_set1_epi32(HIT_PLATFORM);
+	const __m128i ceiling_bit = _mm_set1_epi32(HIT_CEILING);
+	const __m128i wall_bit = _mm_set1_epi32(HIT_WALL);
+	const __m128i floor_bit = _mm_set1_epi32(HIT_FLOOR);
+	const __m128i near_bit = _mm_set1_epi32(NEAR_BRICKS);
+
+	const size_t count = store.size() & ~size_t(3);
+
+	for (size_t i = 0; i < count; i += 4) {
+		__m128i vx = load_fixed_sse2(&store.vx[i]);
+		__m128i vy = load_fixed_sse2(&store.vy[i]);
+		__m128i r = load_fixed_sse2(&store.radius[i]);
+
+		__m128i x = _mm_add_epi32(
+				load_fixed_sse2(&store.x[i]), multiply_fixed_sse2(vx, time)
+		);
+		__m128i y = _mm_add_epi32(
+				load_fixed_sse2(&store.y[i]), multiply_fixed_sse2(vy, time)
+		);
+
+		store_fixed_sse2(&store.x[i], x);
+		store_fixed_sse2(&store.y[i], y);
+
+		__m128i bottom = _mm_sub_epi32(y, r);
+
+		// a <= b is computed as !(a > b)
+		__m128i off_platform = _mm_or_si128(
+				_mm_cmpgt_epi32(bottom, platform_height),
+				_mm_or_si128(
+						_mm_cmpgt_epi32(_mm_sub_epi32(platform_min_x, r), x),
+						_mm_cmpgt_epi32(x, _mm_add_epi32(platform_max_x, r))
+				)
+		);
+		__m128i outside = _mm_or_si128(
+				_mm_cmpgt_epi32(r, x),
+				_mm_cmpgt_epi32(x, _mm_sub_epi32(width, r))
+		);
+
+		__m128i hits = _mm_or_si128(
+				_mm_or_si128(
+						_mm_andnot_si128(
+								off_platform,
+								_mm_and_si128(
+										_mm_cmpgt_epi32(zero, vy), platform_bit
+								)
+						),
+						_mm_andnot_si128(
+								_mm_cmpgt_epi32(_mm_sub_epi32(height, r), y),
+								ceiling_bit
+						)
+				),
+				_mm_or_si128(
+						_mm_and_si128(outside, wall_bit),
+						_mm_or_si128(
+								_mm_andnot_si128(
+										_mm_cmpgt_epi32(bottom, zero), floor_bit
+								),
+								_mm_andnot_si128(
+										_mm_cmpgt_epi32(
+												field_bottom, _mm_add_epi32(y, r)
+										),
+										near_bit
+								)
+						)
+				)
+		);
+
+		hits = _mm_packs_epi32(hits, hits);
+		hits = _mm_packus_epi16(hits, hits);
+
+		int packed = _mm_cvtsi128_si32(hits);
+		std::memcpy(&store.hits[i], &packed, 4);
+	}
+
+	return count;
+}
+
+__attribute__((target("avx2")))
+__m256i multiply_fixed_avx2(__m256i a, __m256i b) {
+	__m256i even = _mm256_mul_epi32(a, b);
+	__m256i odd = _mm256_mul_epi32(
+			_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)
+	);
+
+	return _mm256_blend_epi32(
+			_mm256_srli_epi64(even, Fixed::FRACTION_BITS),
+			_mm256_slli_epi64(odd, Fixed::FRACTION_BITS),
+			0xAA
+	);
+}
+
+__attribute__((target("avx2")))
+__m256i load_fixed_avx2(const Fixed *source) {
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+}
+
+__attribute__((target("avx2")))
+void store_fixed_avx2(Fixed *destination, __m256i value) {
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), value);
+}
+
+__attribute__((target("avx2")))
+size_t integrate_avx2(
+		MotionStore& store, Time frame_length, const MotionBounds& bounds
+) {
+	const __m256i time = _mm256_set1_epi32(Fixed(frame_length).get_raw());
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i width = _mm256_set1_epi32(bounds.width.get_raw());
+	const __m256i height = _mm256_set1_epi32(bounds.height.get_raw());
+	const __m256i platform_min_x =
+			_mm256_set1_epi32(bounds.platform_min_x.get_raw());
+	const __m256i platform_max_x =
+			_mm256_set1_epi32(bounds.platform_max_x.get_raw());
+	const __m256i platform_height =
+			_mm256_set1_epi32(bounds.platform_height.get_raw());
+	const __m256i field_bottom =
+			_mm256_set1_epi32(bounds.field_bottom.get_raw());
+
+	const __m256i platform_bit = _mm256_set1_epi32(HIT_PLATFORM);
+	const __m256i ceiling_bit = _mm256_set1_epi32(HIT_CEILING);
+	const __m256i wall_bit = _mm256_set1_epi32(HIT_WALL);
+	const __m256i floor_bit = _mm256_set1_epi32(HIT_FLOOR);
+	const __m256i near_bit = _mm256_set1_epi32(NEAR_BRICKS);
+
+	const size_t count = store.size() & ~size_t(7);
+
+	for (size_t i = 0; i < count; i += 8) {
+		__m256i vx = load_fixed_avx2(&store.vx[i]);
+		__m256i vy = load_fixed_avx2(&store.vy[i]);
+		__m256i r = load_fixed_avx2(&store.radius[i]);
+
+		__m256i x = _mm256_add_epi32(
+				load_fixed_avx2(&store.x[i]), multiply_fixed_avx2(vx, time)
+		);
+		__m256i y = _mm256_add_epi32(
+				load_fixed_avx2(&store.y[i]), multiply_fixed_avx2(vy, time)
+		);
+
+		store_fixed_avx2(&store.x[i], x);
+		store_fixed_avx2(&store.y[i], y);
+
+		__m256i bottom = _mm256_sub_epi32(y, r);
+
+		__m256i off_platform = _mm256_or_si256(
+				_mm256_cmpgt_epi32(bottom, platform_height),
+				_mm256_or_si256(
+						_mm256_cmpgt_epi32(
+								_mm256_sub_epi32(platform_min_x, r), x
+						),
+						_mm256_cmpgt_epi32(
+								x, _mm256_add_epi32(platform_max_x, r)
+						)
+				)
+		);
+		__m256i outside = _mm256_or_si256(
+				_mm256_cmpgt_epi32(r, x),
+				_mm256_cmpgt_epi32(x, _mm256_sub_epi32(width, r))
+		);
+
+		__m256i hits = _mm256_or_si256(
+				_mm256_or_si256(
+						_mm256_andnot_si256(
+								off_platform,
+								_mm256_and_si256(
+										_mm256_cmpgt_epi32(zero, vy),
+										platform_bit
+								)
+						),
+						_mm256_andnot_si256(
+								_mm256_cmpgt_epi32(
+										_mm256_sub_epi32(height, r), y
+								),
+								ceiling_bit
+						)
+				),
+				_mm256_or_si256(
+						_mm256_and_si256(outside, wall_bit),
+						_mm256_or_si256(
+								_mm256_andnot_si256(
+										_mm256_cmpgt_epi32(bottom, zero),
+										floor_bit
+								),
+								_mm256_andnot_si256(
+										_mm256_cmpgt_epi32(
+												field_bottom,
+												_mm256_add_epi32(y, r)
+										),
+										near_bit
+								)
+						)
+				)
+		);
+
+		__m128i packed = _mm_packs_epi32(
+				_mm256_castsi256_si128(hits),
+				_mm256_extracti128_si256(hits, 1)
+		);
+		packed = _mm_packus_epi16(packed, packed);
+
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(&store.hits[i]), packed);
+	}
+
+	return count;
+}
+
+#endif /* FIXED_POINT_PHYSICS */
+#endif /* X86_MOTION_KERNELS */
+
+/*
+ * Dispatch
+ */
+
+MotionKernel detect_motion_kernel() {
+#ifdef X86_MOTION_KERNELS
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx2")) {
+		return AVX2_KERNEL;
+	}
+
+	if (__builtin_cpu_supports("sse2")) {
+		return SSE2_KERNEL;
+	}
+#endif
+
+	return SCALAR_KERNEL;
+}
+
+MotionKernel best_motion_kernel = detect_motion_kernel();
+MotionKernel motion_kernel = best_motion_kernel;
+
+const char* get_motion_kernel_name(MotionKernel kernel) {
+	switch (kernel) {
+	case SCALAR_KERNEL: return "scalar";
+	case SSE2_KERNEL:   return "sse2";
+	case AVX2_KERNEL:   return "avx2";
+	}
+
+	return "unknown";
+}
+
+bool is_motion_kernel_supported(MotionKernel kernel) {
+	return kernel <= best_motion_kernel;
+}
+
+void set_motion_kernel(MotionKernel kernel) {
+	if (!is_motion_kernel_supported(kernel)) {
+		std::cerr << "Motion kernel " << get_motion_kernel_name(kernel)
+				<< " is not supported by this CPU" << std::endl;
+		return;
+	}
+
+	motion_kernel = kernel;
+}
+
+MotionKernel get_motion_kernel() {
+	return motion_kernel;
+}
+
+void integrate_motion(
+		MotionStore& store, Time frame_length, const MotionBounds& bounds
+) {
+	size_t done = 0;
+
+#ifdef X86_MOTION_KERNELS
+	switch (motion_kernel) {
+	case AVX2_KERNEL: done = integrate_avx2(store, frame_length, bounds); break;
+	case SSE2_KERNEL: done = integrate_sse2(store, frame_length, bounds); break;
+	case SCALAR_KERNEL: break;
+	}
+#endif
+
+	integrate_scalar(store, done, frame_length, bounds);
+}
+
+void accelerate_motion(
+		MotionStore& store, Time frame_length,
+		Velocity acceleration, LevelCoord mass_per_cubed_radius
+) {
+	const Velocity impulse = acceleration * frame_length;
+	size_t done = 0;
+
+#if defined(X86_MOTION_KERNELS) && !defined(FIXED_POINT_PHYSICS)
+	switch (motion_kernel) {
+	case AVX2_KERNEL:
+		done = accelerate_avx2(store, impulse, mass_per_cubed_radius);
+		break;
+	case SSE2_KERNEL:
+		done = accelerate_sse2(store, impulse, mass_per_cubed_radius);
+		break;
+	case SCALAR_KERNEL: break;
+	}
+#endif
+
+	accelerate_scalar(store, done, impulse, mass_per_cubed_radius);
+}
+
+void apply_gravity(
+		MotionStore& store, Time frame_length, Velocity acceleration
+) {
+	const Velocity change = acceleration * frame_length;
+	size_t done = 0;
+
+#if defined(X86_MOTION_KERNELS) && !defined(FIXED_POINT_PHYSICS)
+	switch (motion_kernel) {
+	case AVX2_KERNEL: done = gravity_avx2(store, change); break;
+	case SSE2_KERNEL: done = gravity_sse2(store, change); break;
+	case SCALAR_KERNEL: break;
+	}
+#endif
+
+	gravity_scalar(store, done, change);
+}
@@ -0,0 +1,112 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOTION_H_
+#define MOTION_H_
+
+#include "../common.h"
+
+
+/*
+ * Bounds a body touched after being moved.
+ */
+enum MotionHit : unsigned char {
+	HIT_PLATFORM = 1 << 0,
+	HIT_CEILING  = 1 << 1,
+	HIT_WALL     = 1 << 2,
+	HIT_FLOOR    = 1 << 3,
+
+	// The body overlaps rows that may contain bricks
+	NEAR_BRICKS  = 1 << 4,
+
+	HIT_BOUNDS = HIT_PLATFORM | HIT_CEILING | HIT_WALL | HIT_FLOOR
+};
+
+/*
+ * Structure-of-arrays copy of the motion state of a group of bodies, laid out
+ * for the bulk kernels below.
+ */
+struct MotionStore {
+	std::vector<LevelCoord> x, y, radius;
+	std::vector<Velocity> vx, vy, speed;
+	std::vector<unsigned char> hits;
+
+	size_t size() const {
+		return x.size();
+	}
+
+	/*
+	 * Sets the number of bodies. Capacity is retained between ticks.
+	 */
+	void resize(size_t);
+
+	/*
+	 * Allocates room for the given number of bodies in advance.
+	 */
+	void reserve(size_t);
+};
+
+/*
+ * Geometry the bodies are checked against, see Collideable::check_collisions.
+ */
+struct MotionBounds {
+	LevelCoord width, height;
+	LevelCoord platform_min_x, platform_max_x, platform_height;
+
+	// Lowest row that may contain bricks
+	LevelCoord field_bottom;
+};
+
+enum MotionKernel {
+	SCALAR_KERNEL, SSE2_KERNEL, AVX2_KERNEL
+};
+
+const char* get_motion_kernel_name(MotionKernel);
+bool is_motion_kernel_supported(MotionKernel);
+
+/*
+ * Selects the kernel implementation. The fastest supported one is used by
+ * default. All implementations produce bit-identical results; motion.cpp
+ * turns off floating-point contraction so that compilers targeting FMA do
+ * not fuse the scalar operations differently from the vector ones.
+ */
+void set_motion_kernel(MotionKernel);
+MotionKernel get_motion_kernel();
+
+/*
+ * Moves every body by velocity * time and records the bounds it touched.
+ */
+void integrate_motion(MotionStore&, Time, const MotionBounds&);
+
+/*
+ * Speeds every body up along its direction by
+ * acceleration * time / (mass_per_cubed_radius * radius^3), see
+ * Ball::accelerate.
+ */
+void accelerate_motion(
+		MotionStore&, Time,
+		Velocity acceleration, LevelCoord mass_per_cubed_radius
+);
+
+/*
+ * Pulls every body down by acceleration * time, updating its speed.
+ */
+void apply_gravity(MotionStore&, Time, Velocity acceleration);
+
+
+#endif /* MOTION_H_ */
@@ -19,6 +19,7 @@
 #include "platform.h"
 
 #include "logic.h"
+#include "snapshot.h"
 
 
 const LevelCoord DEFAULT_PLATFORM_SIZE = 3;
@@ -145,3 +146,33 @@ void Platform::tick(Game& game, Time frame_length) {
 	move(game, frame_length);
 	tick_visual(game, frame_length);
 }
+
+/*
+ * Snapshots
+ */
+
+void Platform::save(SnapshotWriter& writer) const {
+	writer.write(size);
+	writer.write(desired_size);
+	writer.write(position);
+	writer.write(desired_position);
+	writer.write(velocity);
+	writer.write(visual.height);
+	writer.write(visual.velocity);
+	writer.write(is_moving_left);
+	writer.write(is_moving_right);
+	writer.write(is_moving_fast);
+}
+
+void Platform::load(SnapshotReader& reader) {
+	size = reader.read<LevelCoord>();
+	desired_size = reader.read<LevelCoord>();
+	position = reader.read<LevelCoord>();
+	desired_position = reader.read<LevelCoord>();
+	velocity = reader.read<Velocity>();
+	visual.height = reader.read<LevelCoord>();
+	visual.velocity = reader.read<Velocity>();
+	is_moving_left = reader.read<bool>();
+	is_moving_right = reader.read<bool>();
+	is_moving_fast = reader.read<bool>();
+}
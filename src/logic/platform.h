@@ -56,6 +56,11 @@ public:
 	LevelCoord get_position() const { return position; }
 	LevelCoord get_size()     const { return size; }
 
+	/*
+	 * The position the platform is being pulled towards by player input.
+	 */
+	LevelCoord get_desired_position() const { return desired_position; }
+
 	void set_position(LevelCoord);
 	void set_size(LevelCoord);
 	void set_size_animated(LevelCoord);
@@ -71,6 +76,9 @@ public:
 
 	void set_movement(bool is_left, bool new_state, bool is_fast);
 	void set_movement_fast(bool is_fast);
+
+	void save(SnapshotWriter&) const;
+	void load(SnapshotReader&);
 };
 
 
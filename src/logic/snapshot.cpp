@@ -0,0 +1,491 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "snapshot.h"
+
+#include "logic.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+
+
+const uint32_t SNAPSHOT_MAGIC = 0x4E534C43; // "CLSN"
+
+// Coordinates are stored as they are in memory, so builds with fixed-point
+// physics cannot read snapshots of floating-point builds and vice versa
+#ifdef FIXED_POINT_PHYSICS
+const uint16_t SNAPSHOT_VERSION = 1 | 0x8000;
+#else
+const uint16_t SNAPSHOT_VERSION = 1;
+#endif
+
+// Sanity limit for counts read from snapshots
+const uint32_t MAX_SNAPSHOT_OBJECTS = 1 << 20;
+
+void save_snapshot(Game& game, Snapshot& snapshot) {
+	snapshot.clear();
+	SnapshotWriter writer(snapshot);
+
+	writer.write(SNAPSHOT_MAGIC);
+	writer.write(SNAPSHOT_VERSION);
+
+	std::vector<uint32_t> random_state = get_random_state();
+	writer.write(static_cast<uint32_t>(random_state.size()));
+	for (uint32_t word : random_state) {
+		writer.write(word);
+	}
+
+	get_current_attempt()->save(writer);
+
+	writer.write(game.state);
+	game.platform.save(writer);
+	game.level->save(writer);
+
+	writer.write(static_cast<uint32_t>(game.get_balls().size()));
+	for (Ball *ball : game.get_balls()) {
+		ball->save(writer);
+	}
+
+	writer.write(static_cast<uint32_t>(game.get_bonuses().size()));
+	for (Bonus *bonus : game.get_bonuses()) {
+		bonus->save(writer);
+	}
+}
+
+Game* load_snapshot(const Snapshot& snapshot) {
+	SnapshotReader reader(snapshot);
+
+	if (reader.read<uint32_t>() != SNAPSHOT_MAGIC
+			|| reader.read<uint16_t>() != SNAPSHOT_VERSION) {
+		std::cerr << "Not a snapshot or unsupported snapshot version"
+				<< std::endl;
+		return nullptr;
+	}
+
+	uint32_t random_words = reader.read<uint32_t>();
+	if (random_words > MAX_SNAPSHOT_OBJECTS) {
+		reader.fail();
+		random_words = 0;
+	}
+
+	std::vector<uint32_t> random_state(random_words);
+	for (uint32_t& word : random_state) {
+		word = reader.read<uint32_t>();
+	}
+
+	Attempt attempt;
+	attempt.load(reader);
+
+	Game *game = new Game();
+	ArenaScope arena_scope(game->get_arena());
+
+	// Validated before it becomes an enumerator
+	auto state = reader.read<std::underlying_type<GameState>::type>();
+	switch (state) {
+	case RUNNING: case PAUSED: case VICTORY: case DEFEAT:
+		game->state = static_cast<GameState>(state);
+		break;
+	default:
+		reader.fail();
+	}
+	game->platform.load(reader);
+	game->level = load_level(reader);
+
+	uint32_t balls = reader.read<uint32_t>();
+	for (uint32_t i = 0; i < balls && !reader.is_failed(); ++i) {
+		Ball *ball = new Ball();
+		ball->load(reader);
+		game->add_ball(ball);
+	}
+
+	uint32_t bonuses = reader.read<uint32_t>();
+	for (uint32_t i = 0; i < bonuses && !reader.is_failed(); ++i) {
+		Bonus *bonus = load_bonus(reader);
+		if (bonus != nullptr) {
+			game->add_bonus(bonus);
+		}
+	}
+
+	if (reader.is_failed()
+			|| !reader.is_at_end()
+			|| game->level == nullptr
+			|| game->get_balls().empty()
+			|| !set_random_state(random_state)) {
+		std::cerr << "Snapshot is corrupted" << std::endl;
+		delete game;
+		return nullptr;
+	}
+
+	end_attempt();
+	start_attempt();
+	*get_current_attempt() = attempt;
+
+	return game;
+}
+
+/*
+ * State hashing
+ */
+
+const char* get_state_part_name(StatePart part) {
+	switch (part) {
+	case RANDOM_PART:   return "random generator";
+	case ATTEMPT_PART:  return "attempt";
+	case PLATFORM_PART: return "platform";
+	case LEVEL_PART:    return "level";
+	case BALLS_PART:    return "balls";
+	case BONUSES_PART:  return "bonuses";
+	default:            return "unknown";
+	}
+}
+
+bool StateHash::operator==(const StateHash& other) const {
+	for (size_t i = 0; i < STATE_PARTS; ++i) {
+		if (parts[i] != other.parts[i]) return false;
+	}
+
+	return true;
+}
+
+void hash_state(Game& game, StateHash& hash) {
+	for (uint64_t& part : hash.parts) {
+		part = EMPTY_HASH;
+	}
+
+	{
+		SnapshotWriter writer(hash.parts[RANDOM_PART]);
+		writer.write(get_random_fingerprint());
+	}
+
+	{
+		SnapshotWriter writer(hash.parts[ATTEMPT_PART]);
+		get_current_attempt()->save(writer);
+		writer.write(game.state);
+	}
+
+	{
+		SnapshotWriter writer(hash.parts[PLATFORM_PART]);
+		game.platform.save(writer);
+	}
+
+	{
+		SnapshotWriter writer(hash.parts[LEVEL_PART]);
+		game.level->save_hash(writer);
+	}
+
+	{
+		SnapshotWriter writer(hash.parts[BALLS_PART]);
+		for (Ball *ball : game.get_balls()) {
+			ball->save(writer);
+		}
+	}
+
+	{
+		SnapshotWriter writer(hash.parts[BONUSES_PART]);
+		for (Bonus *bonus : game.get_bonuses()) {
+			bonus->save(writer);
+		}
+	}
+}
+
+/*
+ * Snapshot files
+ */
+
+bool write_snapshot_file(const std::string& path, const Snapshot& snapshot) {
+	// Replace the file only once the new one is complete
+	const std::string temporary = path + ".tmp";
+
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		file.write(
+				reinterpret_cast<const char*>(snapshot.data()),
+				snapshot.size()
+		);
+
+		if (!file) {
+			std::cerr << "Could not write snapshot " << temporary << std::endl;
+			return false;
+		}
+	}
+
+	if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+		std::cerr << "Could not replace snapshot " << path << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool read_snapshot_file(const std::string& path, Snapshot& snapshot) {
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file) {
+		std::cerr << "Could not open snapshot " << path << std::endl;
+		return false;
+	}
+
+	snapshot.assign(
+			std::istreambuf_iterator<char>(file),
+			std::istreambuf_iterator<char>()
+	);
+
+	return true;
+}
+
+/*
+ * Delta encoding
+ *
+ * A snapshot is stored as its bytewise XOR with the previous one (or with
+ * nothing for keyframes), as alternating runs of zeros and literal bytes:
+ *
+ *   size, [zero run length, literal run length, literal bytes]...
+ *
+ * with all numbers as LEB128 varints.
+ */
+
+void write_varint(std::vector<unsigned char>& output, size_t value) {
+	while (value >= 0x80) {
+		output.push_back(static_cast<unsigned char>(value | 0x80));
+		value >>= 7;
+	}
+
+	output.push_back(static_cast<unsigned char>(value));
+}
+
+size_t read_varint(const unsigned char *&input, const unsigned char *end) {
+	size_t result = 0;
+
+	for (unsigned int shift = 0; input != end && shift < 64; shift += 7) {
+		unsigned char byte = *input++;
+		result |= static_cast<size_t>(byte & 0x7F) << shift;
+
+		if (!(byte & 0x80)) {
+			break;
+		}
+	}
+
+	return result;
+}
+
+void encode_delta(
+		const Snapshot& previous, const Snapshot& current,
+		std::vector<unsigned char>& output
+) {
+	auto get_delta = [&](size_t i) -> unsigned char {
+		return current[i] ^ (i < previous.size() ? previous[i] : 0);
+	};
+
+	output.clear();
+	write_varint(output, current.size());
+
+	size_t i = 0;
+
+	while (i < current.size()) {
+		size_t zeros_start = i;
+		while (i < current.size() && get_delta(i) == 0) i++;
+
+		size_t literal_start = i;
+		while (i < current.size() && get_delta(i) != 0) i++;
+
+		write_varint(output, literal_start - zeros_start);
+		write_varint(output, i - literal_start);
+
+		for (size_t j = literal_start; j < i; ++j) {
+			output.push_back(get_delta(j));
+		}
+	}
+}
+
+bool decode_delta(
+		const Snapshot& previous,
+		const unsigned char *input, const unsigned char *end,
+		Snapshot& output
+) {
+	size_t size = read_varint(input, end);
+	output.assign(size, 0);
+
+	for (size_t i = 0; i < size && i < previous.size(); ++i) {
+		output[i] = previous[i];
+	}
+
+	size_t i = 0;
+
+	while (i < size) {
+		size_t zeros = read_varint(input, end);
+		size_t literals = read_varint(input, end);
+
+		if (zeros + literals == 0
+				|| size - i < zeros + literals
+				|| static_cast<size_t>(end - input) < literals) {
+			return false;
+		}
+
+		i += zeros;
+
+		for (size_t j = 0; j < literals; ++j) {
+			output[i++] ^= *input++;
+		}
+	}
+
+	return input == end;
+}
+
+/*
+ * SnapshotRing
+ */
+
+SnapshotRing::SnapshotRing(size_t capacity, unsigned int keyframe_interval) :
+	storage(capacity),
+	keyframe_interval(keyframe_interval)
+{}
+
+void SnapshotRing::drop_oldest() {
+	entries.pop_front();
+
+	// Differences are useless without the keyframe they start from
+	while (!entries.empty() && !entries.front().is_keyframe) {
+		entries.pop_front();
+	}
+}
+
+size_t SnapshotRing::find_space(size_t size) {
+	size_t offset = 0;
+
+	if (!entries.empty()) {
+		offset = entries.back().offset + entries.back().size;
+	}
+
+	if (storage.size() - offset < size) {
+		offset = 0;
+	}
+
+	// Entries ahead of the write position are the oldest ones
+	for (;;) {
+		bool overlaps = false;
+
+		for (const Entry& entry : entries) {
+			if (entry.offset < offset + size && offset < entry.offset + entry.size) {
+				overlaps = true;
+				break;
+			}
+		}
+
+		if (!overlaps) {
+			return offset;
+		}
+
+		drop_oldest();
+	}
+}
+
+void SnapshotRing::push(const Snapshot& snapshot) {
+	bool is_keyframe = entries.empty() || since_keyframe >= keyframe_interval;
+
+	size_t offset;
+
+	for (;;) {
+		encode_delta(is_keyframe ? Snapshot() : latest, snapshot, encoded);
+
+		if (encoded.size() > storage.size()) {
+			std::cerr << "Snapshot of " << encoded.size()
+					<< " bytes does not fit into the history" << std::endl;
+			clear();
+			return;
+		}
+
+		offset = find_space(encoded.size());
+
+		// The keyframe this difference is based on may have been dropped
+		if (is_keyframe || !entries.empty()) {
+			break;
+		}
+		is_keyframe = true;
+	}
+
+	std::copy(encoded.begin(), encoded.end(), storage.begin() + offset);
+	entries.push_back({offset, encoded.size(), is_keyframe});
+
+	since_keyframe = is_keyframe ? 1 : since_keyframe + 1;
+	latest = snapshot;
+}
+
+size_t SnapshotRing::get_used_bytes() const {
+	size_t result = 0;
+
+	for (const Entry& entry : entries) {
+		result += entry.size;
+	}
+
+	return result;
+}
+
+bool SnapshotRing::get(size_t age, Snapshot& snapshot) const {
+	if (age >= entries.size()) {
+		return false;
+	}
+
+	size_t target = entries.size() - 1 - age;
+	size_t keyframe = target;
+
+	while (!entries[keyframe].is_keyframe) {
+		keyframe--;
+	}
+
+	Snapshot previous;
+
+	for (size_t i = keyframe; i <= target; ++i) {
+		const unsigned char *data = &storage[entries[i].offset];
+
+		if (!decode_delta(previous, data, data + entries[i].size, snapshot)) {
+			std::cerr << "Snapshot history is corrupted" << std::endl;
+			return false;
+		}
+
+		previous.swap(snapshot);
+	}
+
+	snapshot.swap(previous);
+	return true;
+}
+
+void SnapshotRing::rewind(size_t age) {
+	if (age >= entries.size()) {
+		clear();
+		return;
+	}
+
+	entries.erase(entries.end() - age, entries.end());
+
+	since_keyframe = 0;
+	for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+		since_keyframe++;
+		if (entry->is_keyframe) break;
+	}
+
+	get(0, latest);
+}
+
+void SnapshotRing::clear() {
+	entries.clear();
+	since_keyframe = 0;
+	latest.clear();
+}
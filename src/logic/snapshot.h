@@ -0,0 +1,231 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include "../common.h"
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <type_traits>
+
+
+/*
+ * Binary image of a Game, the current Attempt and the random generator.
+ * Sprites, pending input and the bot are not included.
+ */
+using Snapshot = std::vector<unsigned char>;
+
+/*
+ * Adds bytes to a 64-bit FNV-1a hash.
+ */
+inline void add_to_hash(uint64_t& hash, const unsigned char *bytes, size_t size) {
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 0x100000001B3ull;
+	}
+}
+
+const uint64_t EMPTY_HASH = 0xCBF29CE484222325ull;
+
+/*
+ * Appends values to a snapshot, or feeds them into a hash instead so that
+ * the state can be fingerprinted without building a snapshot.
+ */
+class SnapshotWriter {
+private:
+	Snapshot *output = nullptr;
+	uint64_t *hash = nullptr;
+
+public:
+	SnapshotWriter(Snapshot& output) : output(&output) {}
+	SnapshotWriter(uint64_t& hash) : hash(&hash) {}
+
+	template< class T >
+	void write(const T& value) {
+		static_assert(
+				std::is_trivially_copyable<T>::value,
+				"Only plain values can be written directly"
+		);
+
+		const unsigned char *bytes =
+				reinterpret_cast<const unsigned char*>(&value);
+
+		if (output != nullptr) {
+			output->insert(output->end(), bytes, bytes + sizeof(T));
+		} else {
+			add_to_hash(*hash, bytes, sizeof(T));
+		}
+	}
+};
+
+/*
+ * Reads values written by SnapshotWriter. Reading past the end or calling
+ * fail() marks the reader as failed; all further reads return zeros.
+ */
+class SnapshotReader {
+private:
+	const Snapshot& input;
+	size_t position = 0;
+	bool failed = false;
+
+public:
+	SnapshotReader(const Snapshot& input) : input(input) {}
+
+	template< class T >
+	T read() {
+		static_assert(
+				std::is_trivially_copyable<T>::value,
+				"Only plain values can be read directly"
+		);
+
+		T result;
+
+		if (failed || input.size() - position < sizeof(T)) {
+			failed = true;
+			std::memset(&result, 0, sizeof(T));
+			return result;
+		}
+
+		std::memcpy(&result, &input[position], sizeof(T));
+		position += sizeof(T);
+		return result;
+	}
+
+	void fail() {
+		failed = true;
+	}
+
+	bool is_failed() const {
+		return failed;
+	}
+
+	bool is_at_end() const {
+		return position == input.size();
+	}
+};
+
+/*
+ * Captures the state of the game and the current attempt.
+ */
+void save_snapshot(Game&, Snapshot&);
+
+/*
+ * Creates a game from a snapshot, replacing the current attempt and the
+ * random generator state. Returns nullptr if the snapshot is invalid.
+ */
+Game* load_snapshot(const Snapshot&);
+
+/*
+ * Fingerprint of the simulated state, hashed part by part so that a
+ * mismatch can be narrowed down. Covers everything a snapshot does but the
+ * damage animation of bricks, which only rendering advances.
+ */
+enum StatePart {
+	RANDOM_PART, ATTEMPT_PART, PLATFORM_PART, LEVEL_PART, BALLS_PART,
+	BONUSES_PART,
+
+	STATE_PARTS
+};
+
+const char* get_state_part_name(StatePart);
+
+struct StateHash {
+	uint64_t parts[STATE_PARTS];
+
+	bool operator==(const StateHash& other) const;
+	bool operator!=(const StateHash& other) const {
+		return !(*this == other);
+	}
+};
+
+/*
+ * Hashes the state of the game and the current attempt. Cheap enough to be
+ * done every tick.
+ */
+void hash_state(Game&, StateHash&);
+
+bool write_snapshot_file(const std::string& path, const Snapshot&);
+bool read_snapshot_file(const std::string& path, Snapshot&);
+
+/*
+ * Recent snapshots kept within a fixed amount of memory. Every snapshot but
+ * the periodic keyframes is stored as the difference to its predecessor;
+ * consecutive ticks change little, so the differences are mostly zeros and
+ * compress well. The oldest snapshots are dropped to make room.
+ */
+class SnapshotRing {
+private:
+	struct Entry {
+		size_t offset, size;
+		bool is_keyframe;
+	};
+
+	std::vector<unsigned char> storage;
+	std::deque<Entry> entries;
+
+	const unsigned int keyframe_interval;
+	unsigned int since_keyframe = 0;
+
+	// The newest snapshot in full, for encoding the next difference
+	Snapshot latest;
+
+	// Scratch space reused between pushes
+	std::vector<unsigned char> encoded;
+
+	size_t find_space(size_t size);
+	void drop_oldest();
+
+public:
+	SnapshotRing(size_t capacity, unsigned int keyframe_interval = 30);
+
+	void push(const Snapshot&);
+
+	/*
+	 * The number of snapshots that can be retrieved.
+	 */
+	size_t size() const {
+		return entries.size();
+	}
+
+	size_t get_used_bytes() const;
+
+	size_t get_capacity() const {
+		return storage.size();
+	}
+
+	/*
+	 * Reconstructs the snapshot pushed the given number of pushes ago; 0 is
+	 * the newest one.
+	 */
+	bool get(size_t age, Snapshot&) const;
+
+	/*
+	 * Forgets the given number of newest snapshots, so that recording
+	 * continues from an older one.
+	 */
+	void rewind(size_t age);
+
+	void clear();
+};
+
+
+#endif /* SNAPSHOT_H_ */
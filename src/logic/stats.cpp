@@ -0,0 +1,53 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "stats.h"
+
+
+GameStats GameStats::since(const GameStats& earlier) const {
+	GameStats result = *this;
+
+	result.ticks -= earlier.ticks;
+	result.brick_checks -= earlier.brick_checks;
+	result.brick_hits -= earlier.brick_hits;
+	result.bricks_destroyed -= earlier.bricks_destroyed;
+	result.chains -= earlier.chains;
+	result.bonuses_spawned -= earlier.bonuses_spawned;
+	result.bonuses_caught -= earlier.bonuses_caught;
+
+	return result;
+}
+
+void print_stats(
+		std::ostream& output,
+		const GameStats& stats,
+		const char *separator
+) {
+	output
+			<< "balls: " << stats.balls << separator
+			<< "bonuses: " << stats.bonuses << separator
+			<< "sprites: " << stats.sprites << separator
+			<< "ticks: " << stats.ticks << separator
+			<< "brick checks: " << stats.brick_checks << separator
+			<< "brick hits: " << stats.brick_hits << separator
+			<< "bricks destroyed: " << stats.bricks_destroyed << separator
+			<< "chains: " << stats.chains << separator
+			<< "longest chain: " << stats.longest_chain << separator
+			<< "bonuses spawned: " << stats.bonuses_spawned << separator
+			<< "bonuses caught: " << stats.bonuses_caught;
+}
@@ -0,0 +1,67 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include "../common.h"
+
+#include <iostream>
+
+
+using Counter = unsigned long;
+
+/*
+ * What a game has simulated. Counters accumulate from the start of the game;
+ * the entity counts are refreshed at the end of every tick step.
+ */
+struct GameStats {
+	Counter ticks = 0;
+
+	// Level::collide() calls and those that touched a brick
+	Counter brick_checks = 0;
+	Counter brick_hits = 0;
+
+	Counter bricks_destroyed = 0;
+
+	// Every destroyed brick starts or continues an explosion chain
+	Counter chains = 0;
+	Counter longest_chain = 0;
+
+	Counter bonuses_spawned = 0;
+	Counter bonuses_caught = 0;
+
+	unsigned int balls = 0;
+	unsigned int bonuses = 0;
+	unsigned int sprites = 0;
+
+	/*
+	 * Returns the counters accumulated since the earlier stats were taken.
+	 * Entity counts and the longest chain are those of this instance.
+	 */
+	GameStats since(const GameStats& earlier) const;
+};
+
+/*
+ * Writes the entity counts and the counters, one "name: value" pair each.
+ * The separator is put between pairs.
+ */
+void print_stats(std::ostream&, const GameStats&, const char *separator);
+
+
+#endif /* STATS_H_ */
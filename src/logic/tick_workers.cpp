@@ -0,0 +1,147 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tick_workers.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+// Smaller games gain less from splitting than waking the workers costs
+const size_t DEFAULT_PARALLEL_TICK_THRESHOLD = 512;
+
+size_t parallel_tick_threshold = DEFAULT_PARALLEL_TICK_THRESHOLD;
+
+std::vector<std::thread> tick_workers;
+std::mutex tick_mutex;
+std::condition_variable tick_condition;
+
+bool should_stop_workers = false;
+
+// Increased for every run so that workers notice new work
+unsigned long tick_generation = 0;
+
+TickTask tick_task = nullptr;
+void *tick_context = nullptr;
+unsigned int tick_parts = 0;
+
+// The next part to be taken and the number of parts not yet finished
+unsigned int next_tick_part = 0;
+unsigned int unfinished_tick_parts = 0;
+
+/*
+ * Runs parts of the current task until none are left. Called with the lock
+ * held; returns with it held.
+ */
+void run_available_parts(std::unique_lock<std::mutex>& lock) {
+	while (next_tick_part < tick_parts) {
+		unsigned int part = next_tick_part++;
+
+		lock.unlock();
+		tick_task(tick_context, part);
+		lock.lock();
+
+		if (--unfinished_tick_parts == 0) {
+			tick_condition.notify_all();
+		}
+	}
+}
+
+void tick_worker_main() {
+	std::unique_lock<std::mutex> lock(tick_mutex);
+	unsigned long seen_generation = tick_generation;
+
+	while (true) {
+		tick_condition.wait(lock, [&seen_generation](void) {
+			return tick_generation != seen_generation || should_stop_workers;
+		});
+
+		if (should_stop_workers) {
+			break;
+		}
+
+		seen_generation = tick_generation;
+		run_available_parts(lock);
+	}
+}
+
+void set_tick_threads(unsigned int threads) {
+	stop_tick_workers();
+
+	should_stop_workers = false;
+	for (unsigned int i = 1; i < threads; ++i) {
+		tick_workers.push_back(std::thread(tick_worker_main));
+	}
+}
+
+unsigned int get_tick_threads() {
+	return tick_workers.size() + 1;
+}
+
+void set_parallel_tick_threshold(size_t balls) {
+	parallel_tick_threshold = balls;
+}
+
+size_t get_parallel_tick_threshold() {
+	return parallel_tick_threshold;
+}
+
+void stop_tick_workers() {
+	if (tick_workers.empty()) {
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(tick_mutex);
+		should_stop_workers = true;
+		tick_condition.notify_all();
+	}
+
+	for (std::thread& worker : tick_workers) {
+		worker.join();
+	}
+
+	tick_workers.clear();
+}
+
+void run_tick_parts(unsigned int parts, TickTask task, void *context) {
+	if (tick_workers.empty()) {
+		for (unsigned int part = 0; part < parts; ++part) {
+			task(context, part);
+		}
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(tick_mutex);
+
+	tick_task = task;
+	tick_context = context;
+	tick_parts = parts;
+	next_tick_part = 0;
+	unfinished_tick_parts = parts;
+
+	tick_generation++;
+	tick_condition.notify_all();
+
+	run_available_parts(lock);
+
+	tick_condition.wait(lock, [](void) {
+		return unfinished_tick_parts == 0;
+	});
+}
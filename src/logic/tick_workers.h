@@ -0,0 +1,61 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TICK_WORKERS_H_
+#define TICK_WORKERS_H_
+
+#include "../common.h"
+
+
+/*
+ * Threads that share the work of a tick in large games. The thread that
+ * runs the tick does its share of the work as well, so one thread means
+ * that ticks are not split at all.
+ */
+void set_tick_threads(unsigned int threads);
+unsigned int get_tick_threads();
+
+/*
+ * The number of balls a game needs before its ticks are split.
+ */
+void set_parallel_tick_threshold(size_t balls);
+size_t get_parallel_tick_threshold();
+
+void stop_tick_workers();
+
+using TickTask = void (*)(void *context, unsigned int part);
+
+/*
+ * Calls the task once for every part from 0 to parts - 1, spread over the
+ * tick threads, and returns once all calls have returned.
+ */
+void run_tick_parts(unsigned int parts, TickTask task, void *context);
+
+template< class F >
+void run_tick_parts(unsigned int parts, F& task) {
+	run_tick_parts(
+			parts,
+			[](void *context, unsigned int part) {
+				(*static_cast<F*>(context))(part);
+			},
+			&task
+	);
+}
+
+
+#endif /* TICK_WORKERS_H_ */
@@ -19,20 +19,74 @@
 #include "random.h"
 
 #include <random>
+#include <sstream>
 
 std::mt19937 *generator;
 std::uniform_real_distribution<> floats(0.0f, 1.0f);
 
+// Where the sequence was last set and how far it has advanced since
+uint32_t random_origin = 0;
+uint64_t random_draws = 0;
+
 void setup_random() {
 	std::random_device random_device;
-	generator = new std::mt19937(random_device());
+	random_origin = random_device();
+	random_draws = 0;
+	generator = new std::mt19937(random_origin);
 }
 
 void terminate_random() {
 	delete generator;
 }
 
+void seed_random(unsigned int seed) {
+	generator->seed(seed);
+	random_origin = seed;
+	random_draws = 0;
+}
+
 float generate_random_float() {
+	random_draws++;
 	return floats(*generator);
 }
 
+uint64_t get_random_fingerprint() {
+	return (static_cast<uint64_t>(random_origin) << 32) ^ random_draws;
+}
+
+
+// The textual form is the only portable way to access the state
+std::vector<uint32_t> get_random_state() {
+	std::stringstream stream;
+	stream << *generator;
+
+	std::vector<uint32_t> result;
+	uint32_t word;
+	while (stream >> word) {
+		result.push_back(word);
+	}
+
+	return result;
+}
+
+bool set_random_state(const std::vector<uint32_t>& state) {
+	std::stringstream stream;
+	for (uint32_t word : state) {
+		stream << word << ' ';
+	}
+
+	std::mt19937 restored;
+	stream >> restored;
+
+	if (stream.fail()) {
+		return false;
+	}
+
+	*generator = restored;
+
+	// Copying the whole state is fine here, restoring is rare
+	random_origin = std::mt19937(restored)();
+	random_draws = 0;
+
+	return true;
+}
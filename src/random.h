@@ -19,11 +19,32 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include <cstdint>
+#include <vector>
+
 
 void setup_random();
 void terminate_random();
 
+/*
+ * Restarts the random sequence from the given seed.
+ */
+void seed_random(unsigned int seed);
+
 float generate_random_float();
 
+/*
+ * Identifies the state by where the sequence was last seeded or restored
+ * and the number of values drawn since, without touching the generator.
+ * Runs that start from the same seed or snapshot get the same fingerprints.
+ */
+uint64_t get_random_fingerprint();
+
+/*
+ * The complete state of the generator, for snapshots.
+ */
+std::vector<uint32_t> get_random_state();
+bool set_random_state(const std::vector<uint32_t>&);
+
 
 #endif /* RANDOM_H_ */
@@ -0,0 +1,128 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include "../allocations.h"
+#include "../graphics/graphics.h"
+#include "../graphics/render_thread.h"
+#include "../logic/logic.h"
+
+
+const Time CHECK_STEP = 1.0f / 60;
+
+// Lets vectors, arenas and command buffers grow to their steady size first
+const unsigned int WARMUP_TICKS = 600;
+
+const Size CHECK_VIEW = {800, 600};
+
+/*
+ * Records the drawing commands of a game frame without executing them.
+ */
+void record_game_frame(Game& game, Timestamp now) {
+	get_command_buffer().clear();
+
+	push_transform();
+	LevelView view = apply_game_transform(game, CHECK_VIEW, 0);
+	render_game(game, now, view);
+	pop_transform();
+
+	// Formatted like the score display of the game layer
+	(
+			draw_string(Font(32)) << "Score: "
+			<< std::setw(5) << std::setfill('0')
+			<< get_current_attempt()->get_score()
+	).render({0, 0});
+}
+
+void print_allocations(AllocationPhase phase, AllocationCounts counts) {
+	std::cout << get_allocation_phase_name(phase) << ": "
+			<< counts.allocations << " allocations, "
+			<< counts.bytes << " bytes" << std::endl;
+}
+
+int check_allocations(unsigned int ticks) {
+	if (!is_tracking_allocations()) {
+		std::cerr << "Allocations are only counted when built with "
+				"TRACK_ALLOCATIONS" << std::endl;
+		return 1;
+	}
+
+	start_headless_attempt(1);
+
+	// The last level has the most bricks
+	Game *game = start_bot_game(max_level);
+
+	AllocationCounts tick_start, render_start;
+	unsigned int measured = 0;
+	Timestamp time = 0;
+
+	for (unsigned int i = 0; i < WARMUP_TICKS + ticks; ++i) {
+		if (i == WARMUP_TICKS) {
+			tick_start = get_allocation_counts(TICK_PHASE);
+			render_start = get_allocation_counts(RENDER_PHASE);
+		}
+
+		time += to_timestamp(CHECK_STEP);
+
+		{
+			AllocationPhaseScope allocation_phase(TICK_PHASE);
+			tick(*game, CHECK_STEP, time);
+			create_event_sprites(*game);
+		}
+
+		{
+			AllocationPhaseScope allocation_phase(RENDER_PHASE);
+			record_game_frame(*game, time);
+		}
+
+		if (game->state != RUNNING) {
+			break;
+		}
+
+		if (i >= WARMUP_TICKS) {
+			measured++;
+		}
+	}
+
+	AllocationCounts tick_counts =
+			get_allocation_counts(TICK_PHASE).since(tick_start);
+	AllocationCounts render_counts =
+			get_allocation_counts(RENDER_PHASE).since(render_start);
+
+	delete game;
+	get_command_buffer().clear();
+	end_attempt();
+
+	if (measured == 0) {
+		std::cerr << "The level ended during warm-up" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Steady state over " << measured << " ticks:" << std::endl;
+	print_allocations(TICK_PHASE, tick_counts);
+	print_allocations(RENDER_PHASE, render_counts);
+
+	if (tick_counts.allocations != 0 || render_counts.allocations != 0) {
+		std::cout << "FAIL: hot paths allocate from the heap" << std::endl;
+		return 1;
+	}
+
+	std::cout << "OK" << std::endl;
+	return 0;
+}
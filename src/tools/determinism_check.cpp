@@ -0,0 +1,258 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include <fstream>
+
+#include "../logic/logic.h"
+#include "../logic/snapshot.h"
+#include "../logic/tick_workers.h"
+
+
+const Time DETERMINISM_STEP = 1.0f / 60;
+const unsigned int DETERMINISM_SEED = 1;
+
+// Enough for every vector kernel to run full batches besides the remainder
+const size_t DETERMINISM_CROWD_BALLS = 67;
+
+using StateTrace = std::vector<StateHash>;
+using TraceRecorder = void (*)(unsigned int ticks, StateTrace&);
+
+/*
+ * Lets a Bot play level after level like simulate_gameplay() and hashes the
+ * state after every tick. A lost game starts a new attempt.
+ */
+void record_state_trace(unsigned int ticks, StateTrace& trace) {
+	trace.clear();
+	trace.reserve(ticks);
+
+	start_headless_attempt(DETERMINISM_SEED);
+
+	Game *game = nullptr;
+	Timestamp time = 0;
+
+	while (trace.size() < ticks) {
+		if (game == nullptr) {
+			game = start_bot_game();
+			time = 0;
+		}
+
+		time += to_timestamp(DETERMINISM_STEP);
+		tick(*game, DETERMINISM_STEP, time);
+
+		trace.push_back(StateHash());
+		hash_state(*game, trace.back());
+
+		if (game->state != RUNNING) {
+			finish_bot_game(game);
+			game = nullptr;
+		}
+	}
+
+	delete game;
+	end_attempt();
+}
+
+/*
+ * Hashes the state after every tick of a level crowded with balls. Levels
+ * of the Bot rarely have more than a few, too few for the vector kernels.
+ */
+void record_crowded_trace(unsigned int ticks, StateTrace& trace) {
+	trace.clear();
+	trace.reserve(ticks);
+
+	Game *game = create_tick_benchmark_game(DETERMINISM_CROWD_BALLS);
+	Timestamp time = 0;
+
+	while (trace.size() < ticks) {
+		time += to_timestamp(DETERMINISM_STEP);
+		tick(*game, DETERMINISM_STEP, time);
+
+		trace.push_back(StateHash());
+		hash_state(*game, trace.back());
+	}
+
+	delete game;
+	end_attempt();
+}
+
+/*
+ * Trace files hold one line per tick with the hash of every part in hex.
+ */
+bool write_state_trace(const std::string& path, const StateTrace& trace) {
+	std::ofstream file(path);
+	file << std::hex;
+
+	for (const StateHash& hash : trace) {
+		for (size_t i = 0; i < STATE_PARTS; ++i) {
+			file << (i == 0 ? "" : " ") << hash.parts[i];
+		}
+		file << '\n';
+	}
+
+	if (!file) {
+		std::cerr << "Could not write " << path << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool read_state_trace(const std::string& path, StateTrace& trace) {
+	std::ifstream file(path);
+	file >> std::hex;
+
+	trace.clear();
+
+	StateHash hash;
+	while (file >> hash.parts[0]) {
+		for (size_t i = 1; i < STATE_PARTS; ++i) {
+			file >> hash.parts[i];
+		}
+
+		if (!file) {
+			std::cerr << path << " is not a state trace" << std::endl;
+			return false;
+		}
+
+		trace.push_back(hash);
+	}
+
+	return file.eof();
+}
+
+/*
+ * Reports the first tick at which the traces differ and which parts of the
+ * state differ then. Only the ticks present in both traces are compared.
+ */
+bool compare_state_traces(
+		const StateTrace& expected, const StateTrace& actual,
+		const std::string& description
+) {
+	size_t length = std::min(expected.size(), actual.size());
+
+	for (size_t i = 0; i < length; ++i) {
+		if (expected[i] == actual[i]) {
+			continue;
+		}
+
+		std::cout << "FAIL    " << description << ": diverged at tick "
+				<< i + 1 << " in";
+
+		for (size_t part = 0; part < STATE_PARTS; ++part) {
+			if (expected[i].parts[part] != actual[i].parts[part]) {
+				std::cout << " "
+						<< get_state_part_name(static_cast<StatePart>(part));
+			}
+		}
+
+		std::cout << std::endl;
+		return false;
+	}
+
+	std::cout << "OK      " << description << ": " << length
+			<< " ticks match" << std::endl;
+	return true;
+}
+
+/*
+ * Records the trace again serially, with every other supported motion kernel
+ * and with split ticks, and returns the number of traces that differ from
+ * the reference.
+ */
+unsigned int compare_tick_variants(
+		TraceRecorder record, unsigned int ticks,
+		const StateTrace& reference, const std::string& scene
+) {
+	unsigned int failures = 0;
+
+	const MotionKernel default_kernel = get_motion_kernel();
+
+	StateTrace trace;
+	record(ticks, trace);
+	if (!compare_state_traces(reference, trace, scene + ", repeated run")) {
+		failures++;
+	}
+
+	for (MotionKernel kernel : {SCALAR_KERNEL, SSE2_KERNEL, AVX2_KERNEL}) {
+		if (kernel == default_kernel || !is_motion_kernel_supported(kernel)) {
+			continue;
+		}
+
+		set_motion_kernel(kernel);
+		record(ticks, trace);
+
+		std::string description = scene + ", "
+				+ get_motion_kernel_name(kernel) + " kernel";
+		if (!compare_state_traces(reference, trace, description)) {
+			failures++;
+		}
+	}
+
+	set_motion_kernel(default_kernel);
+
+	const unsigned int threads = get_tick_threads();
+	const size_t threshold = get_parallel_tick_threshold();
+
+	// Split even single-ball ticks so that the parallel path is covered
+	set_tick_threads(std::max(2u, threads));
+	set_parallel_tick_threshold(0);
+
+	record(ticks, trace);
+	if (!compare_state_traces(reference, trace, scene + ", parallel tick")) {
+		failures++;
+	}
+
+	set_tick_threads(threads);
+	set_parallel_tick_threshold(threshold);
+
+	return failures;
+}
+
+int check_determinism(unsigned int ticks, const std::string& trace_file) {
+	unsigned int failures = 0;
+
+	StateTrace reference, trace;
+	record_state_trace(ticks, reference);
+	failures += compare_tick_variants(record_state_trace, ticks, reference, "bot");
+
+	if (!trace_file.empty()) {
+		if (!std::ifstream(trace_file)) {
+			if (write_state_trace(trace_file, reference)) {
+				std::cout << "Recorded " << trace_file << std::endl;
+			} else {
+				failures++;
+			}
+		} else if (
+				!read_state_trace(trace_file, trace)
+				|| !compare_state_traces(trace, reference, trace_file)
+		) {
+			failures++;
+		}
+	}
+
+	StateTrace crowded;
+	record_crowded_trace(ticks, crowded);
+	failures += compare_tick_variants(
+			record_crowded_trace, ticks, crowded, "crowded level"
+	);
+
+	std::cout << failures << " comparison(s) failed" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include <cstdlib>
+#include <fstream>
+
+#include "../graphics/graphics.h"
+#include "../logic/logic.h"
+#include "../workflow.h"
+
+
+const unsigned int GOLDEN_SEED = 1;
+
+// A channel may differ by this much before the pixel counts as different
+const int PIXEL_TOLERANCE = 8;
+
+// Fraction of pixels allowed to differ, accounts for rasterizer differences
+const double MAX_DIFFERENT_PIXELS = 0.001;
+
+/*
+ * Images
+ */
+
+struct Image {
+	int width = 0, height = 0;
+	std::vector<unsigned char> rgb;
+};
+
+bool save_ppm(const std::string& path, const Image& image) {
+	std::ofstream file(path, std::ios::binary);
+	if (!file) {
+		std::cerr << "Could not write " << path << std::endl;
+		return false;
+	}
+
+	file << "P6\n" << image.width << " " << image.height << "\n255\n";
+	file.write(
+			reinterpret_cast<const char*>(image.rgb.data()),
+			image.rgb.size()
+	);
+
+	return static_cast<bool>(file);
+}
+
+bool load_ppm(const std::string& path, Image& image) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	std::string magic;
+	int max_value;
+	file >> magic >> image.width >> image.height >> max_value;
+	file.get(); // Single whitespace before pixel data
+
+	if (magic != "P6" || max_value != 255 || !file) {
+		std::cerr << path << " is not a supported PPM image" << std::endl;
+		return false;
+	}
+
+	image.rgb.resize(static_cast<size_t>(image.width) * image.height * 3);
+	file.read(reinterpret_cast<char*>(image.rgb.data()), image.rgb.size());
+
+	return static_cast<bool>(file);
+}
+
+/*
+ * Returns the number of pixels that differ noticeably. Marks them in diff.
+ */
+size_t compare_images(const Image& a, const Image& b, Image& diff) {
+	diff = a;
+
+	size_t different = 0;
+	for (size_t i = 0; i < a.rgb.size(); i += 3) {
+		bool same = true;
+		for (size_t c = 0; c < 3; ++c) {
+			if (std::abs(a.rgb[i + c] - b.rgb[i + c]) > PIXEL_TOLERANCE) {
+				same = false;
+			}
+		}
+
+		if (!same) {
+			different++;
+			diff.rgb[i] = 0xFF;
+			diff.rgb[i + 1] = diff.rgb[i + 2] = 0;
+		}
+	}
+
+	return different;
+}
+
+/*
+ * Scenes
+ */
+
+struct Scene {
+	std::string name;
+	Action setup;
+	unsigned int frames;
+};
+
+std::vector<Scene> get_golden_scenes() {
+	std::vector<Scene> scenes = {
+			{"main_menu", show_main_menu, 1},
+			{"controls", [](void) {
+				show_main_menu();
+				show_controls_menu();
+			}, 1},
+			{"pause", [](void) {
+				pause_game(*start_game_at_level(0));
+			}, 1},
+			{"results", [](void) {
+				Game *game = start_game_at_level(0);
+				game->state = DEFEAT;
+				show_results_menu(*game);
+			}, 1},
+	};
+
+	for (LevelId id = 0; id <= max_level; ++id) {
+		std::string name = "level_" + std::to_string(id);
+
+		scenes.push_back({name, [id](void) {
+			start_game_at_level(id);
+		}, 1});
+
+		// Ball in flight, collision sprites and destroyed bricks
+		scenes.push_back({name + "_play", [id](void) {
+			start_game_at_level(id)->input.push({0, RELEASE_BALLS, true, false});
+		}, 90});
+	}
+
+	// Instanced shapes batched across tiles
+	scenes.push_back({"wall", [](void) {
+		show_wall(4);
+	}, 60});
+
+	return scenes;
+}
+
+Image render_scene(const Scene& scene) {
+	seed_random(GOLDEN_SEED);
+	scene.setup();
+
+	for (unsigned int i = 0; i < scene.frames; ++i) {
+		render();
+	}
+
+	Image image;
+	WindowDimensions size = get_window_size();
+	image.width = size.width;
+	image.height = size.height;
+	capture_frame(image.rgb);
+
+	return image;
+}
+
+int record_golden_images(const std::string& directory) {
+	int result = 0;
+
+	for (const Scene& scene : get_golden_scenes()) {
+		std::string path = directory + "/" + scene.name + ".ppm";
+
+		if (save_ppm(path, render_scene(scene))) {
+			std::cout << "Recorded " << path << std::endl;
+		} else {
+			result = 1;
+		}
+	}
+
+	return result;
+}
+
+int check_golden_images(const std::string& directory) {
+	unsigned int failures = 0;
+
+	for (const Scene& scene : get_golden_scenes()) {
+		std::string path = directory + "/" + scene.name + ".ppm";
+		Image actual = render_scene(scene);
+		Image expected;
+
+		if (!load_ppm(path, expected)) {
+			std::cout << "MISSING " << scene.name << std::endl;
+			failures++;
+			continue;
+		}
+
+		if (
+				expected.width != actual.width
+				|| expected.height != actual.height
+		) {
+			std::cout << "FAIL    " << scene.name << ": size "
+					<< actual.width << "x" << actual.height << ", expected "
+					<< expected.width << "x" << expected.height << std::endl;
+			failures++;
+			continue;
+		}
+
+		Image diff;
+		size_t different = compare_images(actual, expected, diff);
+		size_t allowed = static_cast<size_t>(
+				MAX_DIFFERENT_PIXELS * actual.width * actual.height
+		);
+
+		if (different > allowed) {
+			std::cout << "FAIL    " << scene.name << ": " << different
+					<< " pixels differ" << std::endl;
+
+			save_ppm(directory + "/" + scene.name + ".actual.ppm", actual);
+			save_ppm(directory + "/" + scene.name + ".diff.ppm", diff);
+			failures++;
+		} else {
+			std::cout << "OK      " << scene.name << std::endl;
+		}
+	}
+
+	std::cout << failures << " scene(s) failed" << std::endl;
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include "../logic/logic.h"
+
+
+void start_headless_attempt(unsigned int seed) {
+	seed_random(seed);
+
+	end_attempt();
+	start_attempt();
+}
+
+Game* start_bot_game(unsigned int skipped_levels) {
+	Attempt *attempt = get_current_attempt();
+
+	for (unsigned int i = 0; i < skipped_levels; ++i) {
+		delete attempt->start_next_level();
+	}
+
+	Game *game = attempt->start_next_level();
+	game->bot = new Bot();
+	return game;
+}
+
+void finish_bot_game(Game *game) {
+	if (game->state == DEFEAT) {
+		end_attempt();
+		start_attempt();
+	}
+
+	delete game;
+}
@@ -0,0 +1,135 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "../logic/logic.h"
+
+
+const LevelCoord MOTION_BENCHMARK_WIDTH = 20;
+const LevelCoord MOTION_BENCHMARK_HEIGHT = 16;
+const unsigned int MOTION_BENCHMARK_TICKS = 200;
+const Time MOTION_BENCHMARK_TICK = 1.0f / 120;
+
+void fill_motion_benchmark(MotionStore& store, size_t bodies) {
+	seed_random(1);
+	store.resize(bodies);
+
+	for (size_t i = 0; i < bodies; ++i) {
+		store.radius[i] = 0.1f + generate_random_float() * 0.65f;
+		store.x[i] = generate_random_float() * MOTION_BENCHMARK_WIDTH;
+		store.y[i] = generate_random_float() * MOTION_BENCHMARK_HEIGHT;
+		store.vx[i] = generate_random_float() * 20 - 10;
+		store.vy[i] = generate_random_float() * 20 - 10;
+		store.speed[i] = sqrt(sqr(store.vx[i]) + sqr(store.vy[i]));
+	}
+}
+
+/*
+ * Runs the motion kernels for a tick of balls and of bonuses and returns the
+ * mean time per body in nanoseconds.
+ */
+double run_motion_benchmark(MotionStore& store) {
+	const MotionBounds bounds = {
+			MOTION_BENCHMARK_WIDTH, MOTION_BENCHMARK_HEIGHT,
+			8, 12, PLATFORM_HEIGHT,
+			MOTION_BENCHMARK_HEIGHT / 2
+	};
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < MOTION_BENCHMARK_TICKS; ++i) {
+		integrate_motion(store, MOTION_BENCHMARK_TICK, bounds);
+		accelerate_balls(store, MOTION_BENCHMARK_TICK);
+		accelerate_bonuses(store, MOTION_BENCHMARK_TICK);
+	}
+
+	double seconds = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start
+	).count();
+
+	return seconds * 1e9 / MOTION_BENCHMARK_TICKS / store.size();
+}
+
+template<typename T>
+bool is_bitwise_equal(const std::vector<T>& a, const std::vector<T>& b) {
+	return a.size() == b.size()
+			&& std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+bool is_bitwise_equal(const MotionStore& a, const MotionStore& b) {
+	return is_bitwise_equal(a.x, b.x)
+			&& is_bitwise_equal(a.y, b.y)
+			&& is_bitwise_equal(a.vx, b.vx)
+			&& is_bitwise_equal(a.vy, b.vy)
+			&& is_bitwise_equal(a.speed, b.speed)
+			&& is_bitwise_equal(a.hits, b.hits);
+}
+
+int benchmark_motion(size_t bodies) {
+	if (bodies == 0) {
+		std::cerr << "Nothing to benchmark" << std::endl;
+		return 1;
+	}
+
+	const MotionKernel kernels[] = {SCALAR_KERNEL, SSE2_KERNEL, AVX2_KERNEL};
+	const MotionKernel selected = get_motion_kernel();
+
+	MotionStore reference;
+	double reference_time = 0;
+	int result = 0;
+
+	for (MotionKernel kernel : kernels) {
+		if (!is_motion_kernel_supported(kernel)) {
+			std::cout << get_motion_kernel_name(kernel) << ": not supported"
+					<< std::endl;
+			continue;
+		}
+
+		set_motion_kernel(kernel);
+
+		MotionStore store;
+		fill_motion_benchmark(store, bodies);
+		double time = run_motion_benchmark(store);
+
+		std::cout << std::fixed << std::setprecision(2)
+				<< get_motion_kernel_name(kernel) << ": "
+				<< bodies << " bodies, "
+				<< time << " ns per body per tick";
+
+		if (kernel == SCALAR_KERNEL) {
+			reference = store;
+			reference_time = time;
+		} else {
+			std::cout << ", " << reference_time / time << "x scalar";
+
+			if (!is_bitwise_equal(store, reference)) {
+				std::cout << ", RESULTS DIFFER FROM SCALAR";
+				result = 1;
+			}
+		}
+
+		std::cout << std::endl;
+	}
+
+	set_motion_kernel(selected);
+	return result;
+}
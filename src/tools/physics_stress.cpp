@@ -0,0 +1,334 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include <chrono>
+
+#include "../logic/logic.h"
+
+
+// Simulation rates swept, from the smallest time step to the largest
+const unsigned int STRESS_RATES[] = {960, 480, 240, 120, 60, 30, 15};
+
+const Time STRESS_TRIAL_TIME = 20;
+
+const LevelBlockCoord STRESS_LEVEL_WIDTH = 20;
+const LevelBlockCoord STRESS_LEVEL_HEIGHT = 16;
+const LevelBlockCoord STRESS_FIELD_HEIGHT = 10;
+const float STRESS_BRICK_DENSITY = 0.3f;
+
+// Bricks must survive the trial so that the field does not change
+const unsigned int STRESS_BRICK_HEALTH = 100000;
+
+const Velocity STRESS_MAX_SPEED = 4 * DEFAULT_BALL_VELOCITY;
+const Ball::Mass STRESS_MIN_MASS = 0.1f;
+const Ball::Mass STRESS_MAX_MASS = 20.0f;
+
+// Positions resolved by a bounce are 0.01 away from the border
+const LevelCoord STRESS_TOLERANCE = 0.005f;
+
+// Distance between the points of a move that are checked against bricks
+const LevelCoord STRESS_SAMPLE_SPACING = 0.02f;
+
+enum Violation {
+	INSIDE_BRICK, PASSED_BRICK, ESCAPED_BOUNDS, MISSED_PLATFORM,
+
+	VIOLATIONS
+};
+
+const char *VIOLATION_NAMES[VIOLATIONS] = {
+		"Inside", "Passed", "Escaped", "Missed"
+};
+
+struct StressResult {
+	unsigned long ticks = 0;
+	unsigned long violations[VIOLATIONS] = {};
+	double tick_seconds = 0;
+
+	bool is_safe() const {
+		for (unsigned long count : violations) {
+			if (count != 0) return false;
+		}
+
+		return true;
+	}
+};
+
+float random_in_range(float min, float max) {
+	return min + generate_random_float() * (max - min);
+}
+
+/*
+ * A level of randomly placed bricks that never break, with one free ball of
+ * random size, speed and direction below them.
+ */
+Game* create_stress_game() {
+	Game *game = new Game();
+	ArenaScope arena_scope(game->get_arena());
+
+	Level *level = new Level(
+			max_level + 1,
+			STRESS_LEVEL_WIDTH, STRESS_LEVEL_HEIGHT, STRESS_FIELD_HEIGHT
+	);
+	game->level = level;
+
+	const LevelBlockCoord field_bottom =
+			STRESS_LEVEL_HEIGHT - STRESS_FIELD_HEIGHT;
+
+	for (LevelBlockCoord x = 0; x < STRESS_LEVEL_WIDTH; ++x) {
+		for (LevelBlock b = {x, field_bottom}; b.y < STRESS_LEVEL_HEIGHT; ++b.y) {
+			if (generate_random_float() < STRESS_BRICK_DENSITY) {
+				level->set_brick(b, new SturdyBrick(STRESS_BRICK_HEALTH));
+			}
+		}
+	}
+
+	float angle = random_in_range(0.2f * PI, 0.8f * PI);
+	Ball *ball = new Ball({0, 0}, {
+			DEFAULT_BALL_VELOCITY * cosf(angle),
+			DEFAULT_BALL_VELOCITY * sinf(angle)
+	});
+
+	ball->set_mass(random_in_range(STRESS_MIN_MASS, STRESS_MAX_MASS));
+	ball->set_mass_animated(ball->get_mass());
+	ball->accelerate(
+			random_in_range(0, STRESS_MAX_SPEED - DEFAULT_BALL_VELOCITY)
+	);
+
+	LevelCoord radius = ball->get_radius();
+	ball->get_position() = {
+			random_in_range(radius, STRESS_LEVEL_WIDTH - radius),
+			random_in_range(
+					PLATFORM_HEIGHT + 1 + radius,
+					field_bottom - radius
+			)
+	};
+
+	game->add_ball(ball);
+	game->bot = new Bot();
+
+	return game;
+}
+
+/*
+ * How deep a circle reaches into the block, positive if they overlap.
+ */
+LevelCoord get_overlap(LevelPoint centre, LevelCoord radius, LevelBlock block) {
+	LevelCoord dx = centre.x - force_in_range<LevelCoord>(
+			block.x, centre.x, block.x + 1
+	);
+	LevelCoord dy = centre.y - force_in_range<LevelCoord>(
+			block.y, centre.y, block.y + 1
+	);
+
+	return radius - sqrt(sqr(dx) + sqr(dy));
+}
+
+/*
+ * Checks whether the circle overlaps a brick it did not overlap at the start
+ * of the move.
+ */
+bool touches_new_brick(
+		Game& game, LevelPoint centre, LevelCoord radius, LevelPoint start
+) {
+	LevelBlock min = {
+			static_cast<LevelBlockCoord>(floorf(centre.x - radius)),
+			static_cast<LevelBlockCoord>(floorf(centre.y - radius))
+	};
+	LevelBlock max = {
+			static_cast<LevelBlockCoord>(floorf(centre.x + radius)),
+			static_cast<LevelBlockCoord>(floorf(centre.y + radius))
+	};
+
+	for (LevelBlockCoord x = min.x; x <= max.x; ++x) {
+		for (LevelBlock block = {x, min.y}; block.y <= max.y; ++block.y) {
+			if (game.level->get_brick(block) != nullptr
+					&& get_overlap(centre, radius, block) > STRESS_TOLERANCE
+					&& get_overlap(start, radius, block) <= STRESS_TOLERANCE) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Checks the move of a ball during one tick. The move is the straight line
+ * from its position before the tick along its velocity before the tick; the
+ * collisions of the tick only see where it ends.
+ */
+void check_stress_tick(
+		Game& game, Ball& ball,
+		LevelPoint start, VelocityVector velocity, Time step,
+		bool hit_brick, StressResult& result
+) {
+	const LevelCoord radius = ball.get_radius();
+	const LevelPoint end = start + velocity * step;
+	const LevelPoint position = ball.get_position();
+	const Level& level = *game.level;
+
+	LevelBlock cell = {
+			static_cast<LevelBlockCoord>(floorf(position.x)),
+			static_cast<LevelBlockCoord>(floorf(position.y))
+	};
+	if (level.get_brick(cell) != nullptr) {
+		result.violations[INSIDE_BRICK]++;
+	}
+
+	if (!is_in_range<LevelCoord>(0, position.x, level.get_width())
+			|| !is_in_range<LevelCoord>(0, position.y, level.get_height())) {
+		result.violations[ESCAPED_BOUNDS]++;
+	}
+
+	if (!hit_brick) {
+		LevelCoord length = sqrt(sqr(velocity.x) + sqr(velocity.y)) * step;
+		unsigned int samples =
+				static_cast<unsigned int>(ceilf(length / STRESS_SAMPLE_SPACING));
+
+		for (unsigned int i = 1; i <= samples; ++i) {
+			LevelPoint sample = start + velocity * (step * i / samples);
+
+			if (touches_new_brick(game, sample, radius, start)) {
+				result.violations[PASSED_BRICK]++;
+				break;
+			}
+		}
+	}
+
+	// The platform only checks where the move ends
+	LevelCoord start_bottom = start.y - radius;
+	LevelCoord end_bottom = end.y - radius;
+
+	if (velocity.y < 0 && !hit_brick
+			&& start_bottom > PLATFORM_HEIGHT && end_bottom <= PLATFORM_HEIGHT
+			&& ball.get_velocity_y() < 0) {
+		float crossing = (start_bottom - PLATFORM_HEIGHT)
+				/ (start_bottom - end_bottom);
+		LevelCoord x = start.x + (end.x - start.x) * crossing;
+
+		if (is_in_range(
+				game.platform.get_min_x() - radius,
+				x,
+				game.platform.get_max_x() + radius)) {
+			result.violations[MISSED_PLATFORM]++;
+		}
+	}
+}
+
+/*
+ * Plays every trial at the given rate until the ball is lost or the trial
+ * time is over.
+ */
+StressResult run_stress_rate(unsigned int rate, unsigned int trials) {
+	const Time step = 1.0f / rate;
+	StressResult result;
+
+	for (unsigned int trial = 0; trial < trials; ++trial) {
+		// Every rate plays the same trials
+		start_headless_attempt(trial + 1);
+
+		Game *game = create_stress_game();
+		Timestamp time = 0;
+
+		while (
+				game->state == RUNNING
+				&& time < to_timestamp(STRESS_TRIAL_TIME)
+		) {
+			Ball& ball = *game->get_balls().front();
+			LevelPoint start = ball.get_position();
+			VelocityVector velocity = {
+					ball.get_velocity_x(), ball.get_velocity_y()
+			};
+			Lives lives = get_current_attempt()->get_lives();
+			Counter hits = game->stats.brick_hits;
+
+			time += to_timestamp(step);
+
+			auto tick_start = std::chrono::steady_clock::now();
+			tick(*game, step, time);
+			result.tick_seconds += std::chrono::duration<double>(
+					std::chrono::steady_clock::now() - tick_start
+			).count();
+
+			result.ticks++;
+
+			// The bot missed the ball, which is not a fault of the physics
+			if (get_current_attempt()->get_lives() != lives) {
+				break;
+			}
+
+			check_stress_tick(
+					*game, ball, start, velocity, step,
+					game->stats.brick_hits != hits, result
+			);
+		}
+
+		delete game;
+	}
+
+	end_attempt();
+	return result;
+}
+
+int stress_physics(unsigned int trials) {
+	std::cout << "Step     Ticks     ";
+	for (const char *name : VIOLATION_NAMES) {
+		std::cout << std::setw(9) << std::left << name;
+	}
+	std::cout << "Ticks/s" << std::endl;
+
+	unsigned int safe_rate = 0;
+	double safe_ticks_per_second = 0;
+	bool unsafe_found = false;
+
+	for (unsigned int rate : STRESS_RATES) {
+		StressResult result = run_stress_rate(rate, trials);
+		double ticks_per_second = result.ticks / result.tick_seconds;
+
+		std::cout << std::left
+				<< std::setw(9) << ("1/" + std::to_string(rate))
+				<< std::setw(10) << result.ticks;
+		for (unsigned long count : result.violations) {
+			std::cout << std::setw(9) << count;
+		}
+		std::cout << std::fixed << std::setprecision(0)
+				<< ticks_per_second << std::endl;
+
+		// Larger steps only count as safe if every smaller one is
+		if (!result.is_safe()) {
+			unsafe_found = true;
+		} else if (!unsafe_found) {
+			safe_rate = rate;
+			safe_ticks_per_second = ticks_per_second;
+		}
+	}
+
+	if (safe_rate == 0) {
+		std::cout << "No time step is safe" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Largest safe step: 1/" << safe_rate << " s at "
+			<< std::fixed << std::setprecision(0) << safe_ticks_per_second
+			<< " ticks/s, " << safe_ticks_per_second / safe_rate
+			<< "x real time" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include <chrono>
+
+#include "../graphics/graphics.h"
+#include "../logic/logic.h"
+#include "../workflow.h"
+
+
+int benchmark_rendering(
+		unsigned int frames,
+		const std::string& snapshot,
+		unsigned int wall_games
+) {
+	if (wall_games != 0) {
+		show_wall(wall_games);
+	} else {
+		Game *game;
+
+		if (snapshot.empty()) {
+			game = start_game_at_level(max_level);
+		} else if ((game = resume_game(snapshot)) == nullptr) {
+			return 1;
+		}
+
+		game->input.push({0, RELEASE_BALLS, true, false});
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < frames; ++i) {
+		render();
+	}
+	finish_rendering();
+
+	double seconds = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start
+	).count();
+
+	WindowDimensions size = get_window_size();
+
+	std::cout << std::fixed << std::setprecision(2)
+			<< frames << " frames at " << size.width << "x" << size.height
+			<< " in " << seconds << " s: "
+			<< frames / seconds << " FPS, "
+			<< seconds / frames * 1000 << " ms per frame" << std::endl;
+
+	return 0;
+}
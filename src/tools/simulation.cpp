@@ -0,0 +1,101 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include <chrono>
+
+#include "../logic/logic.h"
+#include "../logic/snapshot.h"
+
+
+const Time SIMULATION_STEP = 1.0f / 60;
+
+// Levels the bot cannot finish in this time are abandoned
+const Time MAX_SIMULATED_LEVEL_TIME = 600;
+
+int simulate_gameplay(double seconds, const std::string& snapshot_file) {
+	start_headless_attempt(1);
+
+	Game *resumed = nullptr;
+
+	if (!snapshot_file.empty()) {
+		Snapshot snapshot;
+
+		if (!read_snapshot_file(snapshot_file, snapshot)
+				|| (resumed = load_snapshot(snapshot)) == nullptr) {
+			return 1;
+		}
+	}
+
+	unsigned int cleared = 0, lost = 0, abandoned = 0;
+	Score best_score = 0;
+	double simulated = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	while (simulated < seconds) {
+		Game *game = resumed;
+		if (game != nullptr) {
+			game->bot = new Bot();
+			resumed = nullptr;
+		} else {
+			game = start_bot_game();
+		}
+
+		Timestamp time = 0;
+
+		while (game->state == RUNNING
+				&& time < to_timestamp(MAX_SIMULATED_LEVEL_TIME)
+				&& simulated < seconds) {
+			time += to_timestamp(SIMULATION_STEP);
+			tick(*game, SIMULATION_STEP, time);
+
+			simulated += SIMULATION_STEP;
+		}
+
+		best_score = std::max(best_score, get_current_attempt()->get_score());
+
+		if (game->state == VICTORY) {
+			cleared++;
+		} else if (game->state == DEFEAT) {
+			lost++;
+		} else if (time >= to_timestamp(MAX_SIMULATED_LEVEL_TIME)) {
+			abandoned++;
+		}
+
+		finish_bot_game(game);
+	}
+
+	double elapsed = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start
+	).count();
+
+	end_attempt();
+
+	std::cout << std::fixed << std::setprecision(1)
+			<< "Simulated " << simulated << " s of gameplay in "
+			<< elapsed << " s: " << simulated / elapsed << "x real time, "
+			<< simulated / elapsed / 60 << " h per core-minute\n"
+			<< "Levels cleared: " << cleared
+			<< ", games lost: " << lost
+			<< ", levels abandoned: " << abandoned
+			<< ", best score: " << best_score << std::endl;
+
+	return 0;
+}
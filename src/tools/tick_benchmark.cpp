@@ -0,0 +1,151 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "tools.h"
+
+#include <chrono>
+#include <thread>
+
+#include "../logic/logic.h"
+#include "../logic/snapshot.h"
+#include "../logic/tick_workers.h"
+
+
+const unsigned int TICK_BENCHMARK_TICKS = 600;
+const Time TICK_BENCHMARK_STEP = 1.0f / 60;
+
+const LevelBlockCoord TICK_BENCHMARK_WIDTH = 40;
+const LevelBlockCoord TICK_BENCHMARK_HEIGHT = 32;
+const LevelBlockCoord TICK_BENCHMARK_FIELD_HEIGHT = 20;
+const float TICK_BENCHMARK_BRICK_DENSITY = 0.3f;
+const unsigned int TICK_BENCHMARK_BRICK_HEALTH = 100000;
+
+// A wide level with a platform covering the whole floor
+Game* create_tick_benchmark_game(size_t balls) {
+	start_headless_attempt(1);
+
+	Game *game = new Game();
+	ArenaScope arena_scope(game->get_arena());
+
+	Level *level = new Level(
+			max_level + 1,
+			TICK_BENCHMARK_WIDTH, TICK_BENCHMARK_HEIGHT,
+			TICK_BENCHMARK_FIELD_HEIGHT
+	);
+	game->level = level;
+
+	const LevelBlockCoord field_bottom =
+			TICK_BENCHMARK_HEIGHT - TICK_BENCHMARK_FIELD_HEIGHT;
+
+	for (LevelBlockCoord x = 0; x < TICK_BENCHMARK_WIDTH; ++x) {
+		for (LevelBlock b = {x, field_bottom}; b.y < TICK_BENCHMARK_HEIGHT; ++b.y) {
+			if (generate_random_float() < TICK_BENCHMARK_BRICK_DENSITY) {
+				level->set_brick(b, new SturdyBrick(TICK_BENCHMARK_BRICK_HEALTH));
+			}
+		}
+	}
+
+	game->platform.set_size(TICK_BENCHMARK_WIDTH);
+	game->platform.set_size_animated(TICK_BENCHMARK_WIDTH);
+	game->platform.set_position(TICK_BENCHMARK_WIDTH / 2.0f);
+
+	for (size_t i = 0; i < balls; ++i) {
+		float angle = (0.2f + 0.6f * generate_random_float()) * PI;
+
+		Ball *ball = new Ball({
+				(0.5f + generate_random_float() * (TICK_BENCHMARK_WIDTH - 1)),
+				(2.0f + generate_random_float() * (field_bottom - 3))
+		}, {
+				DEFAULT_BALL_VELOCITY * cosf(angle),
+				DEFAULT_BALL_VELOCITY * sinf(angle)
+		});
+
+		game->add_ball(ball);
+	}
+
+	return game;
+}
+
+/*
+ * Returns the ticks per second and the state at the end.
+ */
+double run_tick_benchmark(size_t balls, StateHash& result) {
+	Game *game = create_tick_benchmark_game(balls);
+
+	Timestamp time = 0;
+	auto start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < TICK_BENCHMARK_TICKS; ++i) {
+		time += to_timestamp(TICK_BENCHMARK_STEP);
+		tick(*game, TICK_BENCHMARK_STEP, time);
+	}
+
+	double elapsed = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start
+	).count();
+
+	hash_state(*game, result);
+
+	delete game;
+	end_attempt();
+
+	return TICK_BENCHMARK_TICKS / elapsed;
+}
+
+int benchmark_tick(size_t balls) {
+	const unsigned int previous_threads = get_tick_threads();
+	const size_t previous_threshold = get_parallel_tick_threshold();
+
+	// Split every tick, even of small games, to check the parallel path
+	set_parallel_tick_threshold(0);
+
+	const unsigned int max_threads =
+			std::max(2u, std::thread::hardware_concurrency());
+
+	StateHash serial_state;
+	double serial_speed = 0;
+	bool matches = true;
+
+	for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+		set_tick_threads(threads);
+
+		StateHash state;
+		double speed = run_tick_benchmark(balls, state);
+
+		if (threads == 1) {
+			serial_state = state;
+			serial_speed = speed;
+		}
+
+		std::cout << threads << " thread(s): " << std::fixed
+				<< std::setprecision(1) << speed << " ticks/s, "
+				<< std::setprecision(2) << speed / serial_speed << "x";
+
+		if (state != serial_state) {
+			std::cout << ", DIFFERS from the serial tick";
+			matches = false;
+		}
+
+		std::cout << std::endl;
+	}
+
+	set_tick_threads(previous_threads);
+	set_parallel_tick_threshold(previous_threshold);
+
+	return matches ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/*
+ * CleanOut the game
+ * Copyright (C) 2019  Javapony
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TOOLS_H_
+#define TOOLS_H_
+
+#include "../common.h"
+
+#include <string>
+
+
+/*
+ * Development tools selected on the command line. Each returns the process
+ * exit code.
+ */
+
+/*
+ * Renders every menu and level offscreen and stores the frames in the given
+ * directory as reference images.
+ */
+int record_golden_images(const std::string& directory);
+
+/*
+ * Renders every menu and level offscreen and compares the frames against the
+ * reference images in the given directory.
+ */
+int check_golden_images(const std::string& directory);
+
+/*
+ * Renders the given number of gameplay frames offscreen as fast as possible
+ * and reports the throughput. Plays the last level unless a snapshot file to
+ * start from is given, or shows a wall of bot-played games if their number
+ * is not zero.
+ */
+int benchmark_rendering(
+		unsigned int frames,
+		const std::string& snapshot,
+		unsigned int wall_games
+);
+
+/*
+ * Runs every supported motion kernel over the given number of bodies,
+ * reports the time per body and checks that the results match the scalar
+ * kernel. Does not require graphics.
+ */
+int benchmark_motion(size_t bodies);
+
+/*
+ * Lets a Bot play level after level without graphics until the given amount
+ * of game time has passed, then reports the results and the speed. Starts
+ * from the first level unless a snapshot file to start from is given.
+ */
+int simulate_gameplay(double seconds, const std::string& snapshot);
+
+/*
+ * Lets a Bot play the last level without graphics and checks that ticking
+ * and recording drawing commands make no heap allocations once warmed up.
+ * Requires a build with TRACK_ALLOCATIONS.
+ */
+int check_allocations(unsigned int ticks);
+
+/*
+ * Lets a Bot play the given number of ticks twice, again with every other
+ * supported motion kernel and once more with split ticks, and reports the
+ * first tick at which the state hashes differ. Does the same with a level
+ * crowded with balls, so that the vector kernels have full batches to run.
+ * If a trace file is given, the hashes of the Bot are compared against it,
+ * or recorded there if it does not exist yet, so that different builds can
+ * be compared.
+ */
+int check_determinism(unsigned int ticks, const std::string& trace_file);
+
+/*
+ * Plays the given number of trials with balls of random size and speed in
+ * generated levels at a range of time steps, without graphics. Counts balls
+ * ending up inside bricks, passing bricks or the platform without a hit and
+ * leaving the level, and reports the largest step without any.
+ */
+int stress_physics(unsigned int trials);
+
+/*
+ * Plays a level with the given number of balls at 1, 2, 4 and more tick
+ * threads up to the number of cores, without graphics. Reports the tick
+ * throughput of each and checks that the state matches the serial tick.
+ */
+int benchmark_tick(size_t balls);
+
+/*
+ * Headless games
+ */
+
+/*
+ * Seeds the random generator and starts a new attempt, so that headless
+ * games play out the same on every run.
+ */
+void start_headless_attempt(unsigned int seed);
+
+/*
+ * Starts the next level of the current attempt, after skipping the given
+ * number of levels, with a Bot playing it.
+ */
+Game* start_bot_game(unsigned int skipped_levels = 0);
+
+/*
+ * Deletes a game that has ended. A lost game also ends the attempt, and the
+ * next game starts a new one.
+ */
+void finish_bot_game(Game*);
+
+/*
+ * Starts a wide level of bricks that never break with the given number of
+ * balls flying in random directions and a platform that loses none of them.
+ * Seeds the random generator like start_headless_attempt().
+ */
+Game* create_tick_benchmark_game(size_t balls);
+
+
+#endif /* TOOLS_H_ */
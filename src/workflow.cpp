@@ -18,23 +18,89 @@
 
 #include "workflow.h"
 
+#include <sstream>
 #include <string>
 
 #include "logic/logic.h"
+#include "logic/snapshot.h"
 #include "graphics/graphics.h"
 
 
+// Static screens are redrawn after input only; this bounds the sleep anyway
+const Time IDLE_WAKEUP_INTERVAL = 0.5f;
+
 void main_loop() {
 
 	while (!should_close()) {
-		render();
+		if (is_frame_needed()) {
+			render();
+		} else {
+			wait_for_events(IDLE_WAKEUP_INTERVAL);
+		}
 	}
 
 }
 
-void start_next_level() {
+bool autoplay = false;
+
+void set_autoplay(bool enabled) {
+	autoplay = enabled;
+}
+
+Game* create_next_game() {
 	Game *game = get_current_attempt()->start_next_level();
 
+	if (autoplay) {
+		game->bot = new Bot();
+	}
+
+	return game;
+}
+
+std::string autosave_file;
+
+void set_autosave_file(const std::string& path) {
+	autosave_file = path;
+}
+
+const std::string& get_autosave_file() {
+	return autosave_file;
+}
+
+bool stats_reporting = false;
+
+void set_stats_reporting(bool enabled) {
+	stats_reporting = enabled;
+}
+
+bool is_reporting_stats() {
+	return stats_reporting;
+}
+
+Game* resume_game(const std::string& path) {
+	Snapshot snapshot;
+	if (!read_snapshot_file(path, snapshot)) {
+		return nullptr;
+	}
+
+	Game *game = load_snapshot(snapshot);
+	if (game == nullptr) {
+		return nullptr;
+	}
+
+	if (autoplay) {
+		game->bot = new Bot();
+	}
+
+	remove_all_layers();
+	add_layer(create_game_layer(game));
+
+	return game;
+}
+
+void start_next_level() {
+	Game *game = create_next_game();
+
 	remove_all_layers();
 	add_layer(create_game_layer(game));
 }
@@ -45,8 +111,34 @@ void start_game() {
 	start_next_level();
 }
 
+Game* start_game_at_level(LevelId id) {
+	end_attempt();
+	start_attempt();
+
+	Game *game = nullptr;
+	for (LevelId i = 0; i <= id; ++i) {
+		delete game;
+		game = create_next_game();
+	}
+
+	remove_all_layers();
+	add_layer(create_game_layer(game));
+
+	return game;
+}
+
+void show_wall(unsigned int games) {
+	remove_all_layers();
+
+	// Only lends its place to each game's own attempt
+	end_attempt();
+	start_attempt();
+
+	add_layer(create_wall_layer(games));
+}
+
 void exit_game() {
-	glfwSetWindowShouldClose(get_window_handle(), GLFW_TRUE);
+	request_close();
 }
 
 void show_controls_menu() {
@@ -189,10 +281,12 @@ void show_results_menu(Game& game) {
 
 void pause_game(Game& game) {
 	game.state = PAUSED;
+	game.clock.set_paused(true);
 
 	Layer *layer = new Layer(new CenterLayoutManager(), true);
 	layer->set_close_action([&game](void) {
 		game.state = RUNNING;
+		game.clock.set_paused(false);
 	});
 
 	Component *center = new Container("Center", new BorderLayoutManager());
@@ -20,13 +20,50 @@
 #define WORKFLOW_H_
 
 #include "common.h"
+#include "logic/level.h"
+
+#include <string>
 
 
 void main_loop();
 
 void show_main_menu();
+void show_controls_menu();
 void exit_game();
 void start_game();
+
+/*
+ * Starts a new attempt skipping directly to the given level.
+ */
+Game* start_game_at_level(LevelId);
+
+/*
+ * Lets a Bot play every game started from now on.
+ */
+void set_autoplay(bool);
+
+/*
+ * Makes running games save snapshots into the file periodically.
+ */
+void set_autosave_file(const std::string&);
+const std::string& get_autosave_file();
+
+/*
+ * Makes running games print their stats periodically.
+ */
+void set_stats_reporting(bool);
+bool is_reporting_stats();
+
+/*
+ * Starts the game saved in a snapshot file. Returns nullptr on failure.
+ */
+Game* resume_game(const std::string& path);
+
+/*
+ * Shows the given number of bot-played games tiled in the window.
+ */
+void show_wall(unsigned int games);
+
 void show_results_menu(Game&);
 void pause_game(Game&);
 